@@ -0,0 +1,73 @@
+#include <nexus/fuzz.hh>
+#include <nexus/fuzz/engine.hh>
+#include <nexus/tests/execute.hh>
+#include <nexus/tests/registry.hh>
+
+#include <format>
+#include <iostream>
+
+void nx::impl::register_fuzz_test(char const* name,
+                                  config::cfg test_config,
+                                  void (*fn)(std::span<std::byte const>),
+                                  std::source_location loc)
+{
+    nx::get_static_test_registry().add_declaration(
+        name, test_config,
+        [target = fuzz_target{.name = name, .test_config = test_config, .location = loc, .fn = fn}]
+        { nx::impl::run_fuzz_target(target); },
+        loc);
+}
+
+void nx::impl::run_fuzz_diff(std::string const& name,
+                             config::cfg const& test_config,
+                             fuzz_diff_function const& compare,
+                             std::source_location loc)
+{
+    fuzz_diff_timing timing;
+    auto const is_passed = nx::impl::run_fuzz_target({
+        .name = name,
+        .test_config = test_config,
+        .location = loc,
+        .fn = [&](std::span<std::byte const> input) { compare(input, timing); },
+    });
+
+    // timings of a failed comparison would be misleading (e.g. the optimized version may skip work incorrectly)
+    if (!is_passed || timing.inputs == 0)
+        return;
+
+    // one "iteration" per input, so time/iter is the average time per input
+    auto const reference_seconds = tick_clock::to_seconds(timing.reference_ticks);
+    auto const optimized_seconds = tick_clock::to_seconds(timing.optimized_ticks);
+    auto const speedup = optimized_seconds > 0 ? reference_seconds / optimized_seconds : 0.0;
+    nx::impl::report_benchmark_result({
+        .name = name + " [reference]",
+        .location = loc,
+        .iterations = timing.inputs,
+        .real_time_seconds = reference_seconds,
+        .cpu_time_seconds = reference_seconds,
+    });
+    nx::impl::report_benchmark_result({
+        .name = name + " [optimized]",
+        .location = loc,
+        .iterations = timing.inputs,
+        .real_time_seconds = optimized_seconds,
+        .cpu_time_seconds = optimized_seconds,
+        .counters = {{"speedup", speedup}},
+    });
+
+    if (impl::current_schedule_config().verbose)
+        std::cout << std::format("  fuzz diff \"{}\": optimized is {:.2f}x as fast as reference over {} inputs\n", name,
+                                 speedup, timing.inputs);
+}
+
+void nx::impl::register_fuzz_diff_target(char const* name,
+                                         config::cfg test_config,
+                                         fuzz_diff_function compare,
+                                         std::source_location loc)
+{
+    nx::get_static_test_registry().add_declaration(
+        name, test_config,
+        [name = std::string(name), test_config, compare = std::move(compare), loc]
+        { nx::impl::run_fuzz_diff(name, test_config, compare, loc); },
+        loc);
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <nexus/test.hh>
+
+#include <clean-core/macros.hh>
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <source_location>
+#include <span>
+#include <string>
+#include <type_traits>
+
+namespace nx::impl
+{
+void register_fuzz_test(char const* name,
+                        config::cfg test_config,
+                        void (*fn)(std::span<std::byte const>),
+                        std::source_location loc);
+
+// time spent in both sides of a FUZZ_DIFF, over all inputs executed in this process
+struct fuzz_diff_timing
+{
+    std::int64_t inputs = 0;
+    tick_clock::ticks reference_ticks = 0;
+    tick_clock::ticks optimized_ticks = 0;
+};
+
+// runs both sides on an input, checks that the outputs are equal, and adds the time of both sides
+using fuzz_diff_function = std::function<void(std::span<std::byte const>, fuzz_diff_timing&)>;
+
+// runs the comparison as fuzz target of the current test (see run_fuzz_target),
+// then reports the timing of both sides as benchmark results (only if no differing outputs were found)
+void run_fuzz_diff(std::string const& name, config::cfg const& test_config, fuzz_diff_function const& compare, std::source_location loc);
+
+void register_fuzz_diff_target(char const* name, config::cfg test_config, fuzz_diff_function compare, std::source_location loc);
+
+// differences are reported at loc (the FUZZ_DIFF)
+template <class Reference, class Optimized>
+fuzz_diff_function make_fuzz_diff_function(Reference reference, Optimized optimized, std::source_location loc)
+{
+    using input_t = std::span<std::byte const>;
+    static_assert(std::is_invocable_v<Reference&, input_t> && std::is_invocable_v<Optimized&, input_t>,
+                  "FUZZ_DIFF callables must take std::span<std::byte const>");
+    using reference_result = std::invoke_result_t<Reference&, input_t>;
+    using optimized_result = std::invoke_result_t<Optimized&, input_t>;
+    static_assert(!std::is_void_v<reference_result>, "FUZZ_DIFF callables must return their output");
+    static_assert(std::equality_comparable_with<reference_result, optimized_result>,
+                  "FUZZ_DIFF outputs must be comparable with ==");
+
+    return [reference, optimized, loc](input_t input, fuzz_diff_timing& timing) mutable
+    {
+        auto const timed = [&](auto& fn, tick_clock::ticks& ticks)
+        {
+            auto const start = tick_clock::now();
+            auto result = fn(input);
+            auto const elapsed = tick_clock::now_ordered() - start;
+            ticks += elapsed > tick_clock::overhead() ? elapsed - tick_clock::overhead() : 0;
+            return result;
+        };
+        // like CHECK(actual == expected): outputs are only formatted (bounded, with a container diff) if they differ
+        auto const check_equal = [&]<class A, class E>(A const& actual, E const& expected)
+        {
+            impl::make_check_handle(check_kind::check, "optimized(input) == reference(input)",
+                                    binary_expr_capture<A, E>{actual, expected, cmp_op::equal, bool(actual == expected)}, loc);
+        };
+
+        // alternating the order keeps the warm-up cost of touching the input from always hitting the same side
+        if (timing.inputs++ % 2 == 0)
+        {
+            auto const expected = timed(reference, timing.reference_ticks);
+            auto const actual = timed(optimized, timing.optimized_ticks);
+            check_equal(actual, expected);
+        }
+        else
+        {
+            auto const actual = timed(optimized, timing.optimized_ticks);
+            auto const expected = timed(reference, timing.reference_ticks);
+            check_equal(actual, expected);
+        }
+    };
+}
+
+template <class Reference, class Optimized>
+bool register_fuzz_diff(char const* name, config::cfg test_config, Reference reference, Optimized optimized, std::source_location loc)
+{
+    impl::register_fuzz_diff_target(name, test_config,
+                                    impl::make_fuzz_diff_function(std::move(reference), std::move(optimized), loc), loc);
+    return true;
+}
+} // namespace nx::impl
+
+#define NX_IMPL_FUZZ_TEST(name, unique_id, ...)                                                                   \
+    static void CC_MACRO_JOIN(_nx_fuzz_fn_, unique_id)(std::span<std::byte const>);                               \
+    static const bool CC_MACRO_JOIN(_nx_fuzz_reg_, unique_id) = (::nx::impl::register_fuzz_test(                  \
+                                                                     name,                                        \
+                                                                     []()                                         \
+                                                                     {                                            \
+                                                                         using namespace nx::config;              \
+                                                                         return ::nx::impl::merge_config(         \
+                                                                             __VA_ARGS__);                        \
+                                                                     }(),                                         \
+                                                                     &CC_MACRO_JOIN(_nx_fuzz_fn_, unique_id),     \
+                                                                     std::source_location::current()),            \
+                                                                 true);                                           \
+    static void CC_MACRO_JOIN(_nx_fuzz_fn_, unique_id)
+
+// FUZZ_TEST macro: registers a fuzz target as test in the same registry as TEST
+// - by default, runs a quick regression over the corpus (see --fuzz-corpus=<dir>)
+// - with --fuzz, explores new inputs guided by coverage of code built with -fsanitize-coverage=trace-pc-guard
+// - CHECK/REQUIRE failures, assertions, and exceptions fail the test and report the input
+//
+// usage:
+//   FUZZ_TEST("parser - never crashes")(std::span<std::byte const> input)
+//   {
+//       auto const result = parse(input);
+//       CHECK(result.consumed <= input.size());
+//   }
+#define FUZZ_TEST(name, ...) NX_IMPL_FUZZ_TEST(name, __COUNTER__, __VA_ARGS__)
+
+#define NX_IMPL_FUZZ_DIFF(name, unique_id, reference, optimized, ...)                                \
+    static const bool CC_MACRO_JOIN(_nx_fuzz_diff_reg_, unique_id) = ::nx::impl::register_fuzz_diff( \
+        name,                                                                                        \
+        []()                                                                                         \
+        {                                                                                            \
+            using namespace nx::config;                                                              \
+            return ::nx::impl::merge_config(__VA_ARGS__);                                            \
+        }(),                                                                                         \
+        reference, optimized, std::source_location::current())
+
+// FUZZ_DIFF macro: differential fuzzing of two implementations of the same function
+// - both callables get the same inputs (like a FUZZ_TEST) and must return equal outputs
+// - a differing output fails the test, reports both outputs, and saves the input as reproducer
+// - the time of both sides over all executed inputs is reported as a pair of benchmark results
+//   ("<name> [reference]" and "<name> [optimized]", the latter with a "speedup" counter)
+//
+// usage:
+//   FUZZ_DIFF("count zeros - simd", count_zeros_scalar, count_zeros_simd);
+//
+//   FUZZ_DIFF("utf8 validation",
+//             [](std::span<std::byte const> input) { return validate_utf8_reference(input); },
+//             [](std::span<std::byte const> input) { return validate_utf8_fast(input); });
+#define FUZZ_DIFF(name, reference, optimized, ...) \
+    NX_IMPL_FUZZ_DIFF(name, __COUNTER__, reference, optimized __VA_OPT__(, ) __VA_ARGS__)
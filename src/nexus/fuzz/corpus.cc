@@ -0,0 +1,212 @@
+#include "corpus.hh"
+
+#include <nexus/tests/hash.hh>
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <queue>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define NX_IMPL_HAS_MMAP 1
+#else
+#define NX_IMPL_HAS_MMAP 0
+#endif
+
+namespace
+{
+std::vector<std::byte> read_file(std::filesystem::path const& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    std::vector<char> const bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::vector<std::byte> result(bytes.size());
+    std::memcpy(result.data(), bytes.data(), bytes.size());
+    return result;
+}
+
+int process_id()
+{
+#if NX_IMPL_HAS_MMAP
+    return int(getpid());
+#else
+    return 0;
+#endif
+}
+
+std::string write_file(std::filesystem::path const& dir, std::string file_name, std::span<std::byte const> input)
+{
+    // write + rename so that concurrent readers never see partial files
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    auto const tmp_path = dir / std::format(".{}.tmp{}", file_name, process_id());
+    {
+        std::ofstream file(tmp_path, std::ios::binary);
+        file.write(reinterpret_cast<char const*>(input.data()), std::streamsize(input.size()));
+    }
+    std::filesystem::rename(tmp_path, dir / file_name, ec);
+    return file_name;
+}
+
+std::string write_if_new(std::filesystem::path const& dir, std::string file_name, std::span<std::byte const> input)
+{
+    std::error_code ec;
+    if (std::filesystem::exists(dir / file_name, ec))
+        return file_name;
+    return write_file(dir, std::move(file_name), input);
+}
+} // namespace
+
+nx::impl::fuzz_corpus_file::fuzz_corpus_file(std::filesystem::path const& path)
+{
+#if NX_IMPL_HAS_MMAP
+    auto const fd = ::open(path.c_str(), O_RDONLY);
+    if (fd >= 0)
+    {
+        struct stat st = {};
+        if (::fstat(fd, &st) == 0 && st.st_size > 0)
+        {
+            auto const size = size_t(st.st_size);
+            auto const mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED)
+            {
+                _mapping = mapping;
+                _mapping_size = size;
+                _data = {static_cast<std::byte const*>(mapping), size};
+            }
+        }
+        ::close(fd);
+
+        // empty files cannot be mapped and need no buffer
+        if (_mapping != nullptr || st.st_size == 0)
+            return;
+    }
+#endif
+
+    _buffer = read_file(path);
+    _data = _buffer;
+}
+
+nx::impl::fuzz_corpus_file::~fuzz_corpus_file()
+{
+#if NX_IMPL_HAS_MMAP
+    if (_mapping != nullptr)
+        ::munmap(_mapping, _mapping_size);
+#endif
+}
+
+std::string nx::impl::fuzz_content_hash(std::span<std::byte const> input)
+{
+    return std::format("{:016x}", fnv1a(input));
+}
+
+std::vector<std::string> nx::impl::fuzz_corpus::list_files() const
+{
+    std::vector<std::string> files;
+
+    std::error_code ec;
+    if (dir.empty() || !std::filesystem::is_directory(dir, ec))
+        return files;
+
+    for (auto const& entry : std::filesystem::directory_iterator(dir, ec))
+    {
+        auto name = entry.path().filename().string();
+        if (name.starts_with('.') || !entry.is_regular_file(ec))
+            continue;
+        files.push_back(std::move(name));
+    }
+
+    // known bugs first, so that a regression run reports them before spending time on the rest
+    std::ranges::sort(files, {},
+                      [](std::string const& name) { return std::pair(!is_reproducer(name), std::string_view(name)); });
+    return files;
+}
+
+std::string nx::impl::fuzz_corpus::add(std::span<std::byte const> input, std::string_view prefix) const
+{
+    if (dir.empty())
+        return {};
+    return write_if_new(dir, std::string(prefix) + fuzz_content_hash(input), input);
+}
+
+std::string nx::impl::fuzz_corpus::add_reproducer(std::span<std::byte const> input, std::string_view signature) const
+{
+    if (dir.empty())
+        return {};
+
+    auto file_name = std::format("crash-{}", signature);
+    std::error_code ec;
+    auto const existing_size = std::filesystem::file_size(dir / file_name, ec);
+    if (!ec && existing_size <= input.size())
+        return file_name;
+    return write_file(dir, std::move(file_name), input);
+}
+
+void nx::impl::fuzz_corpus::remove(std::string_view file_name) const
+{
+    std::error_code ec;
+    std::filesystem::remove(dir / file_name, ec);
+}
+
+std::vector<size_t> nx::impl::minimize_feature_cover(std::span<std::vector<std::uint32_t> const> features,
+                                                     std::span<size_t const> sizes)
+{
+    // lazy greedy: the gain of an input never grows as more features get covered,
+    // so a re-evaluated gain that still beats the next best stale gain is the true maximum
+    struct candidate
+    {
+        size_t gain = 0;
+        size_t size = 0;
+        size_t index = 0;
+
+        // "less" for the max-heap: fewer new features, then larger inputs, then later inputs
+        bool operator<(candidate const& rhs) const
+        {
+            if (gain != rhs.gain)
+                return gain < rhs.gain;
+            if (size != rhs.size)
+                return size > rhs.size;
+            return index > rhs.index;
+        }
+    };
+
+    std::uint32_t max_feature = 0;
+    std::priority_queue<candidate> queue;
+    for (size_t i = 0; i < features.size(); ++i)
+    {
+        for (auto f : features[i])
+            max_feature = std::max(max_feature, f);
+        if (!features[i].empty())
+            queue.push({.gain = features[i].size(), .size = sizes[i], .index = i});
+    }
+
+    std::vector<bool> is_covered(size_t(max_feature) + 1, false);
+    std::vector<size_t> result;
+    while (!queue.empty())
+    {
+        auto top = queue.top();
+        queue.pop();
+
+        top.gain = size_t(std::ranges::count_if(features[top.index], [&](std::uint32_t f) { return !is_covered[f]; }));
+        if (top.gain == 0)
+            continue;
+
+        if (!queue.empty() && top < queue.top())
+        {
+            queue.push(top);
+            continue;
+        }
+
+        for (auto f : features[top.index])
+            is_covered[f] = true;
+        result.push_back(top.index);
+    }
+
+    std::ranges::sort(result);
+    return result;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace nx::impl
+{
+// read-only contents of a corpus file
+// - memory-mapped where available, so replaying large corpora does not copy every file
+// - unreadable files are empty
+struct fuzz_corpus_file
+{
+    explicit fuzz_corpus_file(std::filesystem::path const& path);
+    fuzz_corpus_file(fuzz_corpus_file&&) = delete;
+    fuzz_corpus_file(fuzz_corpus_file const&) = delete;
+    fuzz_corpus_file& operator=(fuzz_corpus_file&&) = delete;
+    fuzz_corpus_file& operator=(fuzz_corpus_file const&) = delete;
+    ~fuzz_corpus_file();
+
+    [[nodiscard]] std::span<std::byte const> data() const { return _data; }
+
+private:
+    std::span<std::byte const> _data;
+    void* _mapping = nullptr;
+    size_t _mapping_size = 0;
+    std::vector<std::byte> _buffer; // fallback if the file cannot be mapped
+};
+
+// 64 bit FNV-1a of the input as 16 hex digits, used as corpus file name
+[[nodiscard]] std::string fuzz_content_hash(std::span<std::byte const> input);
+
+// on-disk corpus of a single fuzz target
+// - inputs are stored under their content hash, so duplicates are only stored once
+// - failing inputs are stored as "crash-<signature>" reproducers, which are replayed before all other inputs
+//   the signature identifies the bug (failure location or crash stack), so each bug keeps only its smallest input
+// - the most expensive inputs of performance fuzzing are stored as "slow-<hash>"
+// - files starting with '.' are ignored (temporaries of concurrent writers)
+struct fuzz_corpus
+{
+    std::filesystem::path dir; // empty: corpus is disabled
+
+    // reproducers first, each group sorted by name, so that replays are reproducible
+    [[nodiscard]] std::vector<std::string> list_files() const;
+
+    // returns the file name, does nothing if an input with the same content exists
+    std::string add(std::span<std::byte const> input, std::string_view prefix = {}) const;
+
+    // returns the file name, replaces an existing reproducer of the same signature only if the input is smaller
+    std::string add_reproducer(std::span<std::byte const> input, std::string_view signature) const;
+
+    void remove(std::string_view file_name) const;
+
+    [[nodiscard]] static bool is_reproducer(std::string_view file_name) { return file_name.starts_with("crash-"); }
+    [[nodiscard]] static bool is_slow_input(std::string_view file_name) { return file_name.starts_with("slow-"); }
+};
+
+// greedy set cover for corpus minimization
+// - features[i] are the (distinct) coverage features of input i, sizes[i] its size in bytes
+// - returns the indices of a small subset that covers the union of all features (sorted)
+// - prefers inputs with more new features, then smaller inputs
+[[nodiscard]] std::vector<size_t> minimize_feature_cover(std::span<std::vector<std::uint32_t> const> features,
+                                                         std::span<size_t const> sizes);
+
+} // namespace nx::impl
@@ -0,0 +1,63 @@
+#include "coverage.hh"
+
+#include <algorithm>
+#include <limits>
+
+// the callbacks must not be instrumented themselves, even if nexus is built with coverage flags
+#if defined(__clang__)
+#define NX_IMPL_NO_COVERAGE __attribute__((no_sanitize("coverage")))
+#elif defined(__GNUC__) && __GNUC__ >= 12
+#define NX_IMPL_NO_COVERAGE __attribute__((no_sanitize_coverage))
+#else
+#define NX_IMPL_NO_COVERAGE
+#endif
+
+namespace
+{
+// zero-initialized statics: guard init runs from module constructors, possibly before any dynamic initialization
+// edges beyond the map size share counters (rare, costs some precision)
+constexpr size_t max_edges = 1u << 20;
+std::uint32_t g_counters[max_edges];
+std::uint64_t g_total_hits = 0;
+size_t g_edge_count = 0;
+bool g_enabled = false;
+} // namespace
+
+extern "C" NX_IMPL_NO_COVERAGE void __sanitizer_cov_trace_pc_guard_init(std::uint32_t* start, std::uint32_t* stop)
+{
+    // called once per instrumented module, possibly multiple times with the same range
+    if (start == stop || *start != 0)
+        return;
+
+    for (auto guard = start; guard < stop; ++guard)
+    {
+        // index 0 means "not instrumented", so edges are 1-based
+        g_edge_count = std::min(g_edge_count + 1, max_edges - 1);
+        *guard = std::uint32_t(g_edge_count);
+    }
+}
+
+extern "C" NX_IMPL_NO_COVERAGE void __sanitizer_cov_trace_pc_guard(std::uint32_t* guard)
+{
+    if (!g_enabled)
+        return;
+
+    ++g_total_hits;
+    auto& counter = g_counters[*guard];
+    if (counter != std::numeric_limits<std::uint32_t>::max())
+        ++counter;
+}
+
+size_t nx::impl::coverage_edge_count() { return g_edge_count; }
+
+std::span<std::uint32_t> nx::impl::coverage_counters() { return {g_counters, g_edge_count + 1}; }
+
+void nx::impl::coverage_set_enabled(bool enabled) { g_enabled = enabled; }
+
+std::uint64_t nx::impl::coverage_total_hits() { return g_total_hits; }
+
+void nx::impl::coverage_reset()
+{
+    std::fill_n(g_counters, g_edge_count + 1, std::uint32_t(0));
+    g_total_hits = 0;
+}
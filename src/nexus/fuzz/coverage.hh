@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+// edge coverage from -fsanitize-coverage=trace-pc-guard
+// - nexus provides the __sanitizer_cov_trace_pc_guard callbacks
+// - only code compiled with that flag is observed (see nexus_enable_fuzz_coverage in CMake)
+// - without instrumented code, fuzzing still works but is unguided
+namespace nx::impl
+{
+// number of instrumented edges in the process (0 if nothing is instrumented)
+[[nodiscard]] size_t coverage_edge_count();
+
+// 32-bit saturating hit counters, one per edge
+// wide enough that performance fuzzing can still tell apart inputs that run a hot loop millions of times
+[[nodiscard]] std::span<std::uint32_t> coverage_counters();
+
+// number of edges executed since the last reset, not saturating (a measure of execution cost)
+[[nodiscard]] std::uint64_t coverage_total_hits();
+
+// counters are only updated while collection is enabled (i.e. while a fuzz target runs)
+void coverage_set_enabled(bool enabled);
+void coverage_reset();
+
+// AFL-style hit count bucket as a bit mask (1, 2, 3, 4-7, 8-15, 16-31, 32-127, 128+)
+[[nodiscard]] constexpr std::uint8_t coverage_bucket(std::uint32_t count)
+{
+    if (count == 0)
+        return 0;
+    if (count <= 3)
+        return std::uint8_t(1u << (count - 1));
+    if (count <= 7)
+        return 1u << 3;
+    if (count <= 15)
+        return 1u << 4;
+    if (count <= 31)
+        return 1u << 5;
+    if (count <= 127)
+        return 1u << 6;
+    return 1u << 7;
+}
+} // namespace nx::impl
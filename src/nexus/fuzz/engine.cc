@@ -0,0 +1,937 @@
+#include "engine.hh"
+
+#include <nexus/fuzz/corpus.hh>
+#include <nexus/fuzz/coverage.hh>
+#include <nexus/fuzz/mutator.hh>
+#include <nexus/tests/check.hh>
+#include <nexus/tests/crash.hh>
+#include <nexus/tests/execute.hh>
+#include <nexus/tests/hash.hh>
+#include <nexus/tests/timer.hh>
+#include <nexus/tests/trace.hh>
+
+#include <clean-core/assert.hh>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <csignal>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define NX_IMPL_HAS_FORK 1
+#else
+#define NX_IMPL_HAS_FORK 0
+#endif
+
+namespace
+{
+// inputs larger than this are never produced by mutation (corpus files may be larger)
+constexpr size_t max_input_size = 4096;
+
+// number of mutated inputs executed in regression mode, on top of the corpus
+constexpr int regression_mutations = 256;
+
+// how often workers pick up inputs found by other workers
+constexpr double corpus_sync_seconds = 1.0;
+
+// number of most expensive inputs that performance fuzzing keeps and reports
+constexpr size_t max_slowest_inputs = 5;
+
+// budget for minimizing failing inputs before they are reported and saved
+// crashes are reproduced in a forked process per attempt, so they get fewer attempts
+constexpr int max_minimize_attempts = 1000;
+constexpr int max_crash_minimize_attempts = 200;
+
+// number of stack frames shown for crashes
+constexpr size_t reported_crash_frames = 8;
+
+std::span<std::byte const> as_bytes(std::string_view str) { return std::as_bytes(std::span(str.data(), str.size())); }
+
+// test names are free-form, directories are not
+std::string sanitize_file_name(std::string_view name)
+{
+    std::string result;
+    for (auto c : name)
+    {
+        auto const is_safe = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-'
+                          || c == '_' || c == '.';
+        result += is_safe ? c : '_';
+    }
+    return result;
+}
+
+std::string describe_input(std::span<std::byte const> input)
+{
+    constexpr size_t max_shown = 64;
+
+    std::string hex;
+    for (size_t i = 0; i < std::min(input.size(), max_shown); ++i)
+        hex += std::format("{}{:02x}", i == 0 ? "" : " ", unsigned(input[i]));
+    if (input.size() > max_shown)
+        hex += " ...";
+
+    return std::format("fuzz input ({} bytes): {}", input.size(), hex);
+}
+
+// identifies the bug behind failing checks: the location and expression of the first failure
+std::string failure_signature(nx::impl::captured_checks const& captured)
+{
+    if (captured.errors.empty())
+        return nx::impl::fuzz_content_hash({});
+
+    auto const& error = captured.errors.front();
+    return nx::impl::fuzz_content_hash(
+        as_bytes(std::format("{}:{}: {}", error.location.file_name(), error.location.line(), error.expr)));
+}
+
+// (edge, hit count bucket) pairs of the last execution
+std::vector<std::uint32_t> collect_features()
+{
+    std::vector<std::uint32_t> features;
+    auto const counters = nx::impl::coverage_counters();
+    for (size_t i = 0; i < counters.size(); ++i)
+        if (counters[i] != 0)
+            features.push_back(std::uint32_t(i * 8 + size_t(std::countr_zero(nx::impl::coverage_bucket(counters[i])))));
+    return features;
+}
+
+// per-worker part of the state shared between forked fuzz workers
+struct fuzz_worker_slot
+{
+    std::atomic<std::int64_t> execs = 0;
+    std::atomic<bool> found_failure = false;
+
+    // recorded by the crash handler of the worker
+    nx::impl::crash_stack crash;
+
+    // the input currently executed, so that crashes can be attributed after the worker died
+    // mutated inputs always fit, input_size still tells if something larger (e.g. a corpus file) was cut off
+    std::uint32_t input_size = 0; // full size, input may be truncated
+    std::byte input[max_input_size];
+
+    [[nodiscard]] std::span<std::byte const> stored_input() const
+    {
+        return {input, std::min<size_t>(input_size, max_input_size)};
+    }
+    [[nodiscard]] bool is_input_truncated() const { return input_size > max_input_size; }
+};
+
+#if NX_IMPL_HAS_FORK
+// memory shared between the main process and its forked fuzz workers
+// layout: stop flag | crash stack of reproduction runs | worker slots | one coverage bucket mask per edge
+struct fuzz_shared_memory
+{
+    std::atomic<bool>* stop = nullptr;
+    nx::impl::crash_stack* reproduced_crash = nullptr;
+    std::span<fuzz_worker_slot> workers;
+    std::span<std::uint8_t> seen_buckets;
+
+    void* mapping = nullptr;
+    size_t mapping_size = 0;
+
+    fuzz_shared_memory(int worker_count, size_t edge_count)
+    {
+        auto const crash_offset = alignof(nx::impl::crash_stack);
+        auto const slots_offset = (crash_offset + sizeof(nx::impl::crash_stack) + alignof(fuzz_worker_slot) - 1)
+                                / alignof(fuzz_worker_slot) * alignof(fuzz_worker_slot);
+        auto const buckets_offset = slots_offset + sizeof(fuzz_worker_slot) * size_t(worker_count);
+        mapping_size = buckets_offset + edge_count;
+        mapping = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        CC_ASSERT(mapping != MAP_FAILED, "could not map shared memory for fuzz workers");
+
+        auto const base = static_cast<std::byte*>(mapping);
+        stop = new (base) std::atomic<bool>(false);
+        reproduced_crash = new (base + crash_offset) nx::impl::crash_stack();
+        auto const slots = reinterpret_cast<fuzz_worker_slot*>(base + slots_offset);
+        for (auto i = 0; i < worker_count; ++i)
+            new (slots + i) fuzz_worker_slot();
+        workers = {slots, size_t(worker_count)};
+        seen_buckets = {reinterpret_cast<std::uint8_t*>(base + buckets_offset), edge_count};
+    }
+
+    fuzz_shared_memory(fuzz_shared_memory const&) = delete;
+    fuzz_shared_memory& operator=(fuzz_shared_memory const&) = delete;
+
+    ~fuzz_shared_memory() { munmap(mapping, mapping_size); }
+};
+#endif
+
+struct costly_input
+{
+    std::uint64_t cost = 0; // edge hits or ticks, see fuzz_cost_metric
+    std::vector<std::byte> input;
+};
+
+struct fuzz_session
+{
+    nx::impl::fuzz_target const& target;
+    nx::impl::fuzz_corpus on_disk;
+
+    // inputs that mutations start from
+    std::vector<std::vector<std::byte>> corpus;
+    std::unordered_set<std::string> known_corpus_files;
+
+    // per edge: hit count buckets seen so far
+    // points into shared memory when fuzzing with multiple workers so they don't duplicate each other's effort
+    std::vector<std::uint8_t> local_seen_buckets;
+    std::span<std::uint8_t> seen_buckets;
+    size_t covered_features = 0;
+
+    // performance fuzzing (in the spirit of PerfFuzz): inputs are also kept if they hit any edge more often than
+    // all previous inputs or are the most expensive so far, so that mutation climbs towards slow paths
+    nx::fuzz_cost_metric cost_metric = nx::fuzz_cost_metric::none;
+    std::uint64_t last_cost = 0;
+    std::vector<std::uint32_t> max_edge_hits;
+    std::vector<costly_input> slowest_inputs; // most expensive first
+
+    // only set inside forked workers
+    fuzz_worker_slot* worker = nullptr;
+    std::atomic<bool> const* stop = nullptr;
+
+    std::int64_t execs = 0;
+    bool found_failure = false;
+
+    // shown if the process crashes while executing it
+    std::span<std::byte const> current_input;
+
+    // regression part: executes every on-disk input once (streamed, so huge corpora need little memory)
+    // only inputs that add coverage are kept for mutation, all of them if there is no instrumentation
+    void replay_corpus()
+    {
+        auto const _trace = nx::trace_scope("corpus replay", "fuzz");
+        auto const keeps_all = nx::impl::coverage_edge_count() == 0;
+        for (auto const& file_name : on_disk.list_files())
+        {
+            known_corpus_files.insert(file_name);
+
+            nx::impl::fuzz_corpus_file const file(on_disk.dir / file_name);
+            auto const is_interesting = execute(file.data());
+            if (found_failure)
+                return;
+
+            if (is_interesting || keeps_all)
+                corpus.emplace_back(file.data().begin(), file.data().end());
+        }
+    }
+
+    // picks up inputs that other workers wrote to the shared corpus directory
+    // they already contributed their coverage to the shared map, so they are added unconditionally
+    void import_new_corpus_files()
+    {
+        for (auto const& file_name : on_disk.list_files())
+        {
+            if (!known_corpus_files.insert(file_name).second)
+                continue;
+
+            nx::impl::fuzz_corpus_file const file(on_disk.dir / file_name);
+            corpus.emplace_back(file.data().begin(), file.data().end());
+        }
+    }
+
+    void save_to_corpus(std::span<std::byte const> input) { known_corpus_files.insert(on_disk.add(input)); }
+
+    // without an on-disk corpus, reproducers go to a temporary directory so they are never lost
+    std::string write_reproducer(std::span<std::byte const> input, std::string_view signature) const
+    {
+        auto reproducers = on_disk;
+        if (reproducers.dir.empty())
+            reproducers.dir = std::filesystem::temp_directory_path() / "nexus-fuzz-reproducers" / sanitize_file_name(target.name);
+        return (reproducers.dir / reproducers.add_reproducer(input, signature)).string();
+    }
+
+    std::vector<std::string> describe_failure(std::span<std::byte const> input, std::string_view signature, size_t original_size) const
+    {
+        std::vector<std::string> lines = {std::format("reproducer: {}", write_reproducer(input, signature)),
+                                          describe_input(input)};
+        if (original_size != input.size())
+            lines.push_back(std::format("minimized from {} to {} bytes", original_size, input.size()));
+        return lines;
+    }
+
+    // minimizes a failing input (keeping its failure signature), saves it as reproducer, and reports its checks
+    void report_failing_input(std::span<std::byte const> input, nx::impl::captured_checks captured)
+    {
+        auto const signature = failure_signature(captured);
+        auto const _trace = nx::trace_scope("minimize failing input", "fuzz");
+        auto minimized = nx::impl::minimize_input(
+            {input.begin(), input.end()},
+            [&](std::span<std::byte const> candidate)
+            {
+                auto const candidate_captured = run_input(candidate);
+                return candidate_captured.is_failing() && failure_signature(candidate_captured) == signature;
+            },
+            max_minimize_attempts);
+
+        // a non-deterministic target may not fail again, then the original input is reported
+        auto replayed = run_input(minimized);
+        if (replayed.is_failing() && failure_signature(replayed) == signature)
+            captured = std::move(replayed);
+        else
+            minimized.assign(input.begin(), input.end());
+
+        nx::impl::report_captured_checks(std::move(captured), describe_failure(minimized, signature, input.size()));
+    }
+
+    // true if the last execution reached a new (edge, hit count bucket) pair
+    bool collect_new_coverage()
+    {
+        auto const counters = nx::impl::coverage_counters();
+        auto const edge_count = std::min(counters.size(), seen_buckets.size());
+
+        auto has_new = false;
+        for (size_t i = 0; i < edge_count; ++i)
+        {
+            if (counters[i] == 0)
+                continue;
+
+            auto const bucket = nx::impl::coverage_bucket(counters[i]);
+            auto seen = std::atomic_ref<std::uint8_t>(seen_buckets[i]);
+            if ((seen.load(std::memory_order_relaxed) & bucket) != 0)
+                continue;
+
+            // with multiple workers, only the first one to reach a feature keeps the input
+            if ((seen.fetch_or(bucket, std::memory_order_relaxed) & bucket) == 0)
+            {
+                ++covered_features;
+                has_new = true;
+            }
+        }
+        return has_new;
+    }
+
+    // true if the last execution is the most expensive so far or made any edge hotter than before
+    bool collect_new_cost(std::span<std::byte const> input)
+    {
+        auto has_new = false;
+
+        if (cost_metric == nx::fuzz_cost_metric::edge_hits)
+        {
+            auto const counters = nx::impl::coverage_counters();
+            max_edge_hits.resize(counters.size());
+            for (size_t i = 0; i < counters.size(); ++i)
+                if (counters[i] > max_edge_hits[i])
+                {
+                    max_edge_hits[i] = counters[i];
+                    has_new = true;
+                }
+        }
+
+        if (slowest_inputs.size() < max_slowest_inputs || last_cost > slowest_inputs.back().cost)
+        {
+            has_new |= slowest_inputs.empty() || last_cost > slowest_inputs.front().cost;
+
+            auto const is_known = std::ranges::any_of(slowest_inputs, [&](costly_input const& s)
+                                                      { return std::ranges::equal(s.input, input); });
+            if (!is_known)
+            {
+                auto const pos = std::ranges::find_if(slowest_inputs, [&](costly_input const& s) { return s.cost < last_cost; });
+                slowest_inputs.insert(pos, {.cost = last_cost, .input = {input.begin(), input.end()}});
+                if (slowest_inputs.size() > max_slowest_inputs)
+                    slowest_inputs.pop_back();
+            }
+        }
+
+        return has_new;
+    }
+
+    // "slow-<hash>" files are replayed in regression runs and let the main process collect the results of workers
+    void save_slowest_inputs()
+    {
+        for (auto const& s : slowest_inputs)
+            known_corpus_files.insert(on_disk.add(s.input, "slow-"));
+    }
+
+    // re-measures the slow inputs of all workers
+    void load_slowest_inputs()
+    {
+        slowest_inputs.clear();
+        for (auto const& file_name : on_disk.list_files())
+        {
+            if (!nx::impl::fuzz_corpus::is_slow_input(file_name))
+                continue;
+
+            nx::impl::fuzz_corpus_file const file(on_disk.dir / file_name);
+            if (!run_input(file.data()).is_failing())
+                collect_new_cost(file.data());
+        }
+    }
+
+    void print_slowest_inputs() const
+    {
+        auto const is_time = cost_metric == nx::fuzz_cost_metric::wall_time;
+        std::cout << std::format("  fuzz \"{}\": slowest inputs by {}\n", target.name, is_time ? "wall time" : "edge hits");
+        for (auto const& s : slowest_inputs)
+        {
+            auto const cost = is_time ? std::format("{:.2f} us", nx::tick_clock::to_seconds(s.cost) * 1e6)
+                                      : std::format("{} edge hits", s.cost);
+            std::cout << std::format("    {}: {}\n", cost, describe_input(s.input));
+        }
+        std::cout << std::flush;
+    }
+
+    // runs the target once and leaves the coverage of the run in the counters
+    nx::impl::captured_checks run_input(std::span<std::byte const> input)
+    {
+        ++execs;
+        current_input = input;
+
+        if (worker != nullptr)
+        {
+            worker->input_size = std::uint32_t(input.size());
+            std::memcpy(worker->input, input.data(), std::min(input.size(), max_input_size));
+            worker->execs.store(execs, std::memory_order_relaxed);
+        }
+
+        nx::impl::coverage_reset();
+        nx::impl::coverage_set_enabled(true);
+        auto const t_start = nx::tick_clock::now();
+        auto captured = nx::impl::run_captured([&] { target.fn(input); }, target.location);
+        auto const t_end = nx::tick_clock::now_ordered();
+        nx::impl::coverage_set_enabled(false);
+
+        last_cost = cost_metric == nx::fuzz_cost_metric::edge_hits ? nx::impl::coverage_total_hits() : t_end - t_start;
+        return captured;
+    }
+
+    // returns true if the input is interesting (new coverage)
+    bool execute(std::span<std::byte const> input)
+    {
+        auto captured = run_input(input);
+        if (captured.is_failing())
+        {
+            found_failure = true;
+
+            // workers only flag the input, the main process replays it for reporting
+            if (worker != nullptr)
+                worker->found_failure.store(true);
+            else
+                report_failing_input(input, std::move(captured));
+            return false;
+        }
+
+        auto is_interesting = collect_new_coverage();
+        if (cost_metric != nx::fuzz_cost_metric::none && collect_new_cost(input))
+            is_interesting = true;
+        return is_interesting;
+    }
+
+    // mutation-based exploration
+    // - stops after max_execs (if >= 0), at the deadline (if > 0), on failure, or when another worker failed
+    void explore(nx::impl::fuzz_rng& rng, std::int64_t max_execs, double max_seconds, bool save_new_inputs, bool print_progress)
+    {
+        auto const _trace = nx::trace_scope("explore", "fuzz");
+        auto const t_start = nx::tick_clock::now();
+        auto t_last_report = t_start;
+        auto t_last_sync = t_start;
+        auto const seconds_since = [](nx::tick_clock::ticks t) { return nx::tick_clock::to_seconds(nx::tick_clock::now() - t); };
+
+        std::vector<std::byte> input;
+        for (std::int64_t i = 0; max_execs < 0 || i < max_execs; ++i)
+        {
+            // reading the clock is cheap but not free, only check every few executions
+            // (unless performance fuzzing deliberately makes executions slow)
+            if (i % 64 == 0 || cost_metric != nx::fuzz_cost_metric::none)
+            {
+                if (max_seconds > 0 && seconds_since(t_start) >= max_seconds)
+                    break;
+                if (stop != nullptr && stop->load(std::memory_order_relaxed))
+                    break;
+
+                if (worker != nullptr && seconds_since(t_last_sync) >= corpus_sync_seconds)
+                {
+                    t_last_sync = nx::tick_clock::now();
+                    import_new_corpus_files();
+                }
+            }
+
+            auto const& base = corpus[rng.below(corpus.size())];
+            auto const& other = corpus[rng.below(corpus.size())];
+            input = base;
+            nx::impl::mutate(input, rng, max_input_size, other);
+
+            auto const is_interesting = execute(input);
+            if (found_failure)
+                return;
+
+            if (is_interesting)
+            {
+                corpus.push_back(input);
+                if (save_new_inputs)
+                    save_to_corpus(input);
+            }
+
+            if (print_progress && seconds_since(t_last_report) >= 1.0)
+            {
+                t_last_report = nx::tick_clock::now();
+                std::cout << std::format("  fuzz \"{}\": {} execs ({:.0f}/s), {} features on {} edges, corpus {}\n",
+                                         target.name, execs, double(execs) / seconds_since(t_start), covered_features,
+                                         nx::impl::coverage_edge_count(), corpus.size())
+                          << std::flush;
+            }
+        }
+    }
+};
+
+nx::impl::fuzz_rng make_rng(nx::impl::fuzz_target const& target, std::uint64_t stream)
+{
+    auto const seed = target.test_config.seed != 0 ? std::uint64_t(target.test_config.seed) : nx::impl::fnv1a(target.name);
+    return nx::impl::fuzz_rng{.state = seed ^ (stream * nx::impl::splitmix64_gamma)};
+}
+
+// for problems that are detected outside of a captured run (e.g. crashed workers)
+void report_fuzz_failure(fuzz_session const& session,
+                         std::string expanded,
+                         std::vector<std::string> extra_lines,
+                         std::span<std::byte const> input,
+                         std::string_view signature,
+                         size_t original_size)
+{
+    nx::impl::report_captured_checks(
+        nx::impl::captured_checks{
+            .executed_checks = 1,
+            .failed_checks = 1,
+            .errors = {nx::test_error{
+                .expr = std::format("FUZZ_TEST(\"{}\")", session.target.name),
+                .location = session.target.location,
+                .extra_lines = std::move(extra_lines),
+                .expanded = std::move(expanded),
+            }},
+        },
+        session.describe_failure(input, signature, original_size));
+}
+
+#if NX_IMPL_HAS_FORK
+// executes the input in a forked process, returns the crash signature if that process died from a signal
+std::optional<std::string> crash_signature_in_child(fuzz_session& session,
+                                                    std::span<std::byte const> input,
+                                                    nx::impl::crash_stack& record)
+{
+    record.size = 0;
+
+    std::cout << std::flush;
+    auto const pid = fork();
+    if (pid == 0)
+    {
+        nx::impl::install_crash_recorder(&record);
+        (void)session.run_input(input);
+        _exit(0);
+    }
+
+    CC_ASSERT(pid > 0, "could not fork to reproduce a crash");
+    auto status = 0;
+    waitpid(pid, &status, 0);
+    if (!WIFSIGNALED(status))
+        return std::nullopt;
+    return nx::impl::crash_signature(nx::impl::symbolize_crash_stack(record));
+}
+
+// failures of all workers, grouped by signature
+struct worker_failure
+{
+    std::string signature;
+    int signal = 0; // 0 for failing checks
+    std::vector<nx::impl::crash_frame> stack;
+    std::vector<std::byte> input; // smallest one seen
+    size_t input_size = 0;        // full size of that input, larger than input.size() if the worker stored a prefix
+    int occurrences = 1;
+};
+
+void add_worker_failure(std::vector<worker_failure>& failures, worker_failure failure)
+{
+    auto const it = std::ranges::find(failures, failure.signature, &worker_failure::signature);
+    if (it == failures.end())
+    {
+        failures.push_back(std::move(failure));
+        return;
+    }
+
+    ++it->occurrences;
+    if (failure.input_size < it->input_size)
+    {
+        it->input = std::move(failure.input);
+        it->input_size = failure.input_size;
+    }
+}
+
+// runs exploration in forked worker processes
+// - new inputs are shared through the corpus directory, coverage through shared memory
+// - failures found by workers are replayed in this process so they are reported like any other failure
+// - crashes (signals) cannot be replayed in-process, they are identified by their stack (recorded by the worker)
+//   and minimized by reproducing them in forked processes
+// - failures with the same signature (e.g. several workers hitting the same bug) are reported once
+void explore_in_workers(fuzz_session& session, nx::test_schedule_config const& config, int worker_count)
+{
+    auto const& target = session.target;
+
+    // coverage of the corpus replay is merged into the shared map before forking
+    fuzz_shared_memory shared(worker_count, session.local_seen_buckets.size());
+    std::ranges::copy(session.local_seen_buckets, shared.seen_buckets.begin());
+    session.seen_buckets = shared.seen_buckets;
+
+    // without an on-disk corpus, workers exchange inputs through a temporary one
+    auto const is_temporary_corpus = session.on_disk.dir.empty();
+    if (is_temporary_corpus)
+    {
+        session.on_disk.dir = std::filesystem::temp_directory_path()
+                           / std::format("nexus-fuzz-{}-{}", int(getpid()), sanitize_file_name(target.name));
+        for (auto const& input : session.corpus)
+            session.save_to_corpus(input);
+    }
+
+    auto const trace_file = [&, pid = int(getpid())](int worker)
+    {
+        return std::filesystem::temp_directory_path()
+             / std::format("nexus-trace-{}-{}-{}.json", pid, sanitize_file_name(target.name), worker);
+    };
+
+    std::cout << std::flush; // forked workers would print buffered output again
+    std::vector<pid_t> pids;
+    for (auto i = 0; i < worker_count; ++i)
+    {
+        auto const pid = fork();
+        if (pid == 0)
+        {
+            session.worker = &shared.workers[size_t(i)];
+            session.stop = shared.stop;
+            nx::impl::install_crash_recorder(&session.worker->crash);
+            nx::impl::trace_restart_in_child(std::format("fuzz worker {}", i));
+            auto rng = make_rng(target, std::uint64_t(i) + 1);
+            session.explore(rng, -1, config.fuzz_seconds, true, false);
+            if (session.found_failure)
+                shared.stop->store(true);
+            else if (session.cost_metric != nx::fuzz_cost_metric::none)
+                session.save_slowest_inputs();
+
+            if (nx::impl::is_tracing())
+                std::ofstream(trace_file(i)) << nx::impl::trace_export_events();
+
+            // skip atexit handlers and static destructors of the parent's state
+            _exit(session.found_failure ? 1 : 0);
+        }
+
+        CC_ASSERT(pid > 0, "could not fork fuzz worker");
+        pids.push_back(pid);
+    }
+
+    // monitor progress until all workers exited
+    auto const t_start = nx::tick_clock::now();
+    auto t_last_report = t_start;
+    std::vector<int> statuses(pids.size(), 0);
+    std::vector<bool> exited(pids.size(), false);
+    auto running = worker_count;
+    while (running > 0)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        for (size_t i = 0; i < pids.size(); ++i)
+            if (!exited[i] && waitpid(pids[i], &statuses[i], WNOHANG) == pids[i])
+            {
+                exited[i] = true;
+                --running;
+
+                // a crashed worker ends the session like a failing input does
+                if (WIFSIGNALED(statuses[i]))
+                    shared.stop->store(true);
+            }
+
+        if (running > 0 && nx::tick_clock::to_seconds(nx::tick_clock::now() - t_last_report) >= 1.0)
+        {
+            t_last_report = nx::tick_clock::now();
+            std::int64_t total_execs = 0;
+            for (auto const& w : shared.workers)
+                total_execs += w.execs.load(std::memory_order_relaxed);
+            auto const elapsed = nx::tick_clock::to_seconds(t_last_report - t_start);
+            std::cout << std::format("  fuzz \"{}\": {} workers running, {} execs ({:.0f}/s)\n", target.name, running,
+                                     total_execs, double(total_execs) / elapsed)
+                      << std::flush;
+        }
+    }
+
+    // per-worker and total throughput
+    auto const elapsed = nx::tick_clock::to_seconds(nx::tick_clock::now() - t_start);
+    std::int64_t total_execs = 0;
+    for (size_t i = 0; i < shared.workers.size(); ++i)
+    {
+        auto const execs = shared.workers[i].execs.load();
+        total_execs += execs;
+        std::cout << std::format("  fuzz \"{}\" worker {}: {} execs ({:.0f}/s)\n", target.name, i, execs,
+                                 double(execs) / elapsed);
+    }
+    std::cout << std::format("  fuzz \"{}\" total: {} execs ({:.0f}/s) on {} workers\n", target.name, total_execs,
+                             double(total_execs) / elapsed, worker_count)
+              << std::flush;
+
+    session.worker = nullptr;
+    session.stop = nullptr;
+    session.seen_buckets = session.local_seen_buckets;
+
+    // timelines of the workers (crashed workers have none)
+    for (auto i = 0; i < worker_count && nx::impl::is_tracing(); ++i)
+    {
+        {
+            nx::impl::fuzz_corpus_file const file(trace_file(i));
+            auto const events = file.data();
+            nx::impl::trace_import_events({reinterpret_cast<char const*>(events.data()), events.size()});
+        }
+        std::error_code ec;
+        std::filesystem::remove(trace_file(i), ec);
+    }
+
+    if (session.cost_metric != nx::fuzz_cost_metric::none)
+        session.load_slowest_inputs();
+
+    // reproducers must not end up in the temporary corpus
+    if (is_temporary_corpus)
+    {
+        std::error_code ec;
+        std::filesystem::remove_all(session.on_disk.dir, ec);
+        session.on_disk.dir.clear();
+    }
+
+    std::vector<worker_failure> failures;
+    for (size_t i = 0; i < pids.size(); ++i)
+    {
+        auto const& slot = shared.workers[i];
+        auto input = std::vector<std::byte>(slot.stored_input().begin(), slot.stored_input().end());
+        if (WIFSIGNALED(statuses[i]))
+        {
+            auto stack = nx::impl::symbolize_crash_stack(slot.crash);
+            auto signature = nx::impl::crash_signature(stack);
+            add_worker_failure(failures, {.signature = std::move(signature),
+                                          .signal = WTERMSIG(statuses[i]),
+                                          .stack = std::move(stack),
+                                          .input = std::move(input),
+                                          .input_size = slot.input_size});
+        }
+        else if (slot.found_failure.load())
+        {
+            auto const captured = session.run_input(input);
+            if (captured.is_failing())
+            {
+                auto const input_size = input.size();
+                add_worker_failure(failures,
+                                   {.signature = failure_signature(captured), .input = std::move(input), .input_size = input_size});
+                continue;
+            }
+
+            // a replayed prefix not failing says nothing about the determinism of the target
+            if (slot.is_input_truncated())
+                report_fuzz_failure(session,
+                                    std::format("input failed in fuzz worker {} but only its first {} of {} bytes were recorded",
+                                                i, input.size(), slot.input_size),
+                                    {std::format("fuzz workers record inputs up to {} bytes, the prefix does not fail", max_input_size)},
+                                    input, nx::impl::fuzz_content_hash(input), input.size());
+            else
+                report_fuzz_failure(session, std::format("input failed in fuzz worker {} but not when replayed", i),
+                                    {"the target is probably non-deterministic"}, input,
+                                    nx::impl::fuzz_content_hash(input), input.size());
+            session.found_failure = true;
+        }
+    }
+
+    for (auto const& failure : failures)
+    {
+        session.found_failure = true;
+
+        if (failure.signal == 0)
+        {
+            session.report_failing_input(failure.input, session.run_input(failure.input));
+            continue;
+        }
+
+        auto const _trace = nx::trace_scope("minimize crashing input", "fuzz");
+        auto const minimized = nx::impl::minimize_input(
+            failure.input,
+            [&](std::span<std::byte const> candidate)
+            { return crash_signature_in_child(session, candidate, *shared.reproduced_crash) == failure.signature; },
+            max_crash_minimize_attempts);
+
+        std::vector<std::string> lines;
+        if (failure.occurrences > 1)
+            lines.push_back(std::format("{} workers crashed with this stack", failure.occurrences));
+        if (failure.input_size > failure.input.size())
+            lines.push_back(std::format("only the first {} of {} bytes of the crashing input were recorded",
+                                        failure.input.size(), failure.input_size));
+        lines.push_back(std::format("stack signature: {}", failure.signature));
+        for (size_t f = 0; f < std::min(failure.stack.size(), reported_crash_frames); ++f)
+            lines.push_back(std::format("  #{} {}", f, nx::impl::to_string(failure.stack[f])));
+
+        report_fuzz_failure(session, std::format("fuzz worker crashed with signal {} ({})", failure.signal, strsignal(failure.signal)),
+                            std::move(lines), minimized, failure.signature, failure.input.size());
+    }
+}
+#endif
+
+// replaces the on-disk corpus by the smallest subset (greedy) that reaches the same coverage features
+// - reproducers and slow inputs are kept and not executed, they don't contribute coverage but bugs
+// - other failing inputs are kept as well, the first one is reported
+void minimize_corpus(fuzz_session& session)
+{
+    auto const& target = session.target;
+    auto const _trace = nx::trace_scope("minimize corpus", "fuzz");
+
+    if (nx::impl::coverage_edge_count() == 0)
+    {
+        std::cout << std::format("  fuzz \"{}\": no coverage instrumentation found, corpus is not minimized\n", target.name);
+        return;
+    }
+
+    std::vector<std::string> candidates;
+    std::vector<std::vector<std::uint32_t>> features;
+    std::vector<size_t> sizes;
+    size_t kept_files = 0;
+    for (auto const& file_name : session.on_disk.list_files())
+    {
+        if (nx::impl::fuzz_corpus::is_reproducer(file_name) || nx::impl::fuzz_corpus::is_slow_input(file_name))
+        {
+            ++kept_files;
+            continue;
+        }
+
+        nx::impl::fuzz_corpus_file const file(session.on_disk.dir / file_name);
+        auto captured = session.run_input(file.data());
+        if (captured.is_failing())
+        {
+            if (!session.found_failure)
+                nx::impl::report_captured_checks(std::move(captured),
+                                                 {std::format("corpus file: {}", file_name), describe_input(file.data())});
+            session.found_failure = true;
+            ++kept_files;
+            continue;
+        }
+
+        candidates.push_back(file_name);
+        features.push_back(collect_features());
+        sizes.push_back(file.data().size());
+    }
+
+    auto const cover = nx::impl::minimize_feature_cover(features, sizes);
+    std::vector<bool> is_kept(candidates.size(), false);
+    for (auto i : cover)
+        is_kept[i] = true;
+    for (size_t i = 0; i < candidates.size(); ++i)
+        if (!is_kept[i])
+            session.on_disk.remove(candidates[i]);
+
+    std::cout << std::format("  fuzz \"{}\": minimized corpus from {} to {} inputs\n", target.name,
+                             candidates.size() + kept_files, cover.size() + kept_files)
+              << std::flush;
+}
+} // namespace
+
+bool nx::impl::run_fuzz_target(fuzz_target const& target)
+{
+    auto const& config = impl::current_schedule_config();
+
+    auto const _trace = trace_scope(std::format("FUZZ_TEST(\"{}\")", target.name), "fuzz");
+
+    fuzz_session session{.target = target};
+    if (!config.fuzz_corpus_dir.empty())
+        session.on_disk.dir = std::filesystem::path(config.fuzz_corpus_dir) / sanitize_file_name(target.name);
+
+    session.local_seen_buckets.resize(coverage_counters().size());
+    session.seen_buckets = session.local_seen_buckets;
+
+    // crashes outside of forked workers (regression runs, --fuzz-jobs=1) take down the process before the input could
+    // be minimized, so the input is saved as is, under the signature of the crash
+    auto _ = impl::scoped_crash_context(
+        [&]
+        {
+            auto description = std::format("FUZZ_TEST(\"{}\") with {}", target.name, describe_input(session.current_input));
+            auto const signature = impl::current_crash_signature();
+            if (!signature.empty())
+                description += std::format(", reproducer: {}", session.write_reproducer(session.current_input, signature));
+            return description;
+        });
+
+    if (config.fuzz_minimize_corpus)
+    {
+        if (session.on_disk.dir.empty())
+            std::cout << std::format("  fuzz \"{}\": --fuzz-minimize-corpus requires --fuzz-corpus, nothing to minimize\n",
+                                     target.name);
+        else
+            minimize_corpus(session);
+
+        if (!session.found_failure)
+            impl::report_check_result(check_kind::check, cmp_op::none, std::format("FUZZ_TEST(\"{}\")", target.name),
+                                      true, {}, target.location);
+        return !session.found_failure;
+    }
+
+    if (config.fuzz)
+    {
+        session.cost_metric = config.fuzz_cost;
+        if (session.cost_metric == fuzz_cost_metric::edge_hits && coverage_edge_count() == 0)
+        {
+            std::cout << std::format("  fuzz \"{}\": edge hits require coverage instrumentation, using wall time\n",
+                                     target.name);
+            session.cost_metric = fuzz_cost_metric::wall_time;
+        }
+    }
+
+    // replay the corpus first: this is the regression part and primes the coverage map (and the slowest inputs)
+    session.replay_corpus();
+    if (session.found_failure)
+        return false;
+
+    if (session.corpus.empty())
+    {
+        // the empty input is always a valid start
+        session.corpus.emplace_back();
+        session.execute(session.corpus.back());
+        if (session.found_failure)
+            return false;
+    }
+
+    if (!config.fuzz)
+    {
+        auto rng = make_rng(target, 0);
+        session.explore(rng, regression_mutations, 0.0, false, false);
+    }
+    else
+    {
+        auto worker_count = config.fuzz_jobs > 0 ? config.fuzz_jobs : int(std::thread::hardware_concurrency());
+#if NX_IMPL_HAS_FORK
+        if (worker_count > 1)
+            explore_in_workers(session, config, worker_count);
+        else
+#else
+        if (worker_count > 1)
+            std::cout << std::format("  fuzz \"{}\": parallel fuzzing requires fork(), using a single worker\n", target.name);
+#endif
+        {
+            auto rng = make_rng(target, 0);
+            session.explore(rng, -1, config.fuzz_seconds, true, true);
+            if (!session.found_failure && session.cost_metric != fuzz_cost_metric::none)
+                session.save_slowest_inputs();
+        }
+
+        if (coverage_edge_count() == 0 && session.cost_metric == fuzz_cost_metric::none)
+            std::cout << std::format("  fuzz \"{}\": no coverage instrumentation found, mutations were unguided\n",
+                                     target.name);
+
+        if (!session.found_failure && session.cost_metric != fuzz_cost_metric::none)
+            session.print_slowest_inputs();
+    }
+
+    if (session.found_failure)
+        return false;
+
+    // a fuzz run without failures is one passing check
+    impl::report_check_result(check_kind::check, cmp_op::none, std::format("FUZZ_TEST(\"{}\")", target.name), true, {},
+                              target.location);
+    return true;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <nexus/tests/config.hh>
+
+#include <cstddef>
+#include <functional>
+#include <source_location>
+#include <span>
+#include <string>
+
+namespace nx::impl
+{
+using fuzz_function = std::function<void(std::span<std::byte const>)>;
+
+struct fuzz_target
+{
+    std::string name;
+    config::cfg test_config;
+    std::source_location location;
+    fuzz_function fn;
+};
+
+// runs a fuzz target as part of the current test
+// - regression (default): every corpus input plus a fixed number of deterministic mutations
+// - exploration (--fuzz): coverage-guided mutation until the time budget is used up
+// - corpus minimization (--fuzz-minimize-corpus): the on-disk corpus is reduced to inputs with distinct coverage
+// - the first failing input is minimized and reported as test failure (with the input attached), then fuzzing stops
+//   failing inputs are saved as "crash-<signature>" reproducers in the corpus, so later regression runs replay them
+//   the signature identifies the bug (first failing check or top frames of the crash stack), so repeated runs
+//   that hit the same bug do not pile up reproducers
+// - returns false if a failing input was found
+bool run_fuzz_target(fuzz_target const& target);
+
+} // namespace nx::impl
@@ -0,0 +1,203 @@
+#include "mutator.hh"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+using nx::impl::fuzz_rng;
+
+// boundary values that often trigger edge cases in parsers and arithmetic
+constexpr std::uint8_t interesting_8[] = {0, 1, 0x7f, 0x80, 0xff, 0x10, 0x20, 0x40, 0x64};
+constexpr std::uint16_t interesting_16[] = {0, 1, 0x7fff, 0x8000, 0xffff, 0x100, 0x200, 0x400, 0x1000};
+constexpr std::uint32_t interesting_32[] = {0, 1, 0x7fffffff, 0x80000000, 0xffffffff, 0x10000, 0x7fff, 0x8000, 0xffff};
+
+enum class mutation
+{
+    flip_bit,
+    random_byte,
+    delta_byte,
+    interesting_value,
+    insert_bytes,
+    erase_bytes,
+    copy_chunk,
+    shuffle_chunk,
+    crossover,
+
+    count
+};
+
+template <class T, size_t N>
+void overwrite_interesting(std::vector<std::byte>& data, fuzz_rng& rng, T const (&values)[N])
+{
+    if (data.size() < sizeof(T))
+        return;
+
+    auto value = values[rng.below(N)];
+    if (rng.one_in(2)) // both endiannesses are common in formats
+    {
+        T swapped = 0;
+        for (size_t i = 0; i < sizeof(T); ++i)
+            swapped = T(swapped << 8 | ((value >> (8 * i)) & 0xff));
+        value = swapped;
+    }
+
+    auto const pos = rng.below(data.size() - sizeof(T) + 1);
+    std::memcpy(data.data() + pos, &value, sizeof(T));
+}
+
+void mutate_once(std::vector<std::byte>& data, fuzz_rng& rng, size_t max_size, std::span<std::byte const> other)
+{
+    auto const kind = mutation(rng.below(size_t(mutation::count)));
+
+    // mutations that need existing bytes fall back to inserting some
+    if (data.empty() && kind != mutation::crossover)
+    {
+        auto const count = std::min<size_t>(1 + rng.below(8), max_size);
+        for (size_t i = 0; i < count; ++i)
+            data.push_back(std::byte(rng.next()));
+        return;
+    }
+
+    switch (kind)
+    {
+    case mutation::flip_bit:
+    {
+        auto const pos = rng.below(data.size());
+        data[pos] ^= std::byte(1u << rng.below(8));
+        break;
+    }
+    case mutation::random_byte:
+    {
+        data[rng.below(data.size())] = std::byte(rng.next());
+        break;
+    }
+    case mutation::delta_byte:
+    {
+        auto& b = data[rng.below(data.size())];
+        auto const delta = int(rng.below(35)) - 17;
+        b = std::byte(std::uint8_t(int(b) + delta));
+        break;
+    }
+    case mutation::interesting_value:
+    {
+        switch (rng.below(3))
+        {
+        case 0: overwrite_interesting(data, rng, interesting_8); break;
+        case 1: overwrite_interesting(data, rng, interesting_16); break;
+        default: overwrite_interesting(data, rng, interesting_32); break;
+        }
+        break;
+    }
+    case mutation::insert_bytes:
+    {
+        if (data.size() >= max_size)
+            break;
+        auto const count = std::min<size_t>(1 + rng.below(16), max_size - data.size());
+        auto const pos = rng.below(data.size() + 1);
+        auto const value = std::byte(rng.next());
+        auto const repeated = rng.one_in(2); // runs of the same byte are a common structure
+        data.insert(data.begin() + std::ptrdiff_t(pos), count, value);
+        if (!repeated)
+            for (size_t i = 0; i < count; ++i)
+                data[pos + i] = std::byte(rng.next());
+        break;
+    }
+    case mutation::erase_bytes:
+    {
+        auto const pos = rng.below(data.size());
+        auto const count = 1 + rng.below(std::min<size_t>(data.size() - pos, 16));
+        data.erase(data.begin() + std::ptrdiff_t(pos), data.begin() + std::ptrdiff_t(pos + count));
+        break;
+    }
+    case mutation::copy_chunk:
+    {
+        auto const src = rng.below(data.size());
+        auto const count = 1 + rng.below(data.size() - src);
+        std::vector<std::byte> const chunk(data.begin() + std::ptrdiff_t(src), data.begin() + std::ptrdiff_t(src + count));
+        if (rng.one_in(2) && data.size() + count <= max_size)
+        {
+            auto const dst = rng.below(data.size() + 1);
+            data.insert(data.begin() + std::ptrdiff_t(dst), chunk.begin(), chunk.end());
+        }
+        else
+        {
+            auto const dst = rng.below(data.size() - count + 1);
+            std::copy(chunk.begin(), chunk.end(), data.begin() + std::ptrdiff_t(dst));
+        }
+        break;
+    }
+    case mutation::shuffle_chunk:
+    {
+        auto const pos = rng.below(data.size());
+        auto const count = 1 + rng.below(std::min<size_t>(data.size() - pos, 8));
+        for (auto i = count - 1; i > 0; --i)
+            std::swap(data[pos + i], data[pos + rng.below(i + 1)]);
+        break;
+    }
+    case mutation::crossover:
+    {
+        if (other.empty())
+            break;
+
+        // splice: prefix of data + suffix of other
+        auto const cut = rng.below(data.size() + 1);
+        auto const other_start = rng.below(other.size());
+        data.resize(cut);
+        auto const count = std::min(other.size() - other_start, max_size - data.size());
+        data.insert(data.end(), other.begin() + std::ptrdiff_t(other_start),
+                    other.begin() + std::ptrdiff_t(other_start + count));
+        break;
+    }
+    case mutation::count: break;
+    }
+}
+} // namespace
+
+void nx::impl::mutate(std::vector<std::byte>& data, fuzz_rng& rng, size_t max_size, std::span<std::byte const> other)
+{
+    auto const count = 1 + rng.below(5);
+    for (size_t i = 0; i < count; ++i)
+        mutate_once(data, rng, max_size, other);
+
+    if (data.size() > max_size)
+        data.resize(max_size);
+}
+
+std::vector<std::byte> nx::impl::minimize_input(std::vector<std::byte> input,
+                                                std::function<bool(std::span<std::byte const>)> const& still_fails,
+                                                int max_attempts)
+{
+    auto attempts = 0;
+    auto const is_failing = [&](std::span<std::byte const> candidate)
+    { return attempts++ < max_attempts && still_fails(candidate); };
+
+    std::vector<std::byte> candidate;
+    for (auto chunk = input.size(); chunk > 0 && attempts < max_attempts; chunk /= 2)
+    {
+        // a successful removal shifts the next chunk to the same start
+        size_t start = 0;
+        while (start + chunk <= input.size() && attempts < max_attempts)
+        {
+            candidate.assign(input.begin(), input.begin() + std::ptrdiff_t(start));
+            candidate.insert(candidate.end(), input.begin() + std::ptrdiff_t(start + chunk), input.end());
+            if (is_failing(candidate))
+                input.swap(candidate);
+            else
+                start += chunk;
+        }
+    }
+
+    for (size_t i = 0; i < input.size() && attempts < max_attempts; ++i)
+    {
+        if (input[i] == std::byte(0))
+            continue;
+
+        candidate = input;
+        candidate[i] = std::byte(0);
+        if (is_failing(candidate))
+            input.swap(candidate);
+    }
+
+    return input;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <nexus/tests/hash.hh>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace nx::impl
+{
+// small, fast, deterministic PRNG for fuzzing decisions (splitmix64)
+struct fuzz_rng
+{
+    std::uint64_t state = 0;
+
+    std::uint64_t next() { return splitmix64_next(state); }
+
+    // uniform in [0, n), n must be > 0
+    std::uint64_t below(std::uint64_t n) { return next() % n; }
+
+    bool one_in(std::uint64_t n) { return below(n) == 0; }
+};
+
+// applies 1 to 5 stacked random mutations to data in place
+// - the result never exceeds max_size bytes
+// - other (if non-empty) is used for crossover
+void mutate(std::vector<std::byte>& data, fuzz_rng& rng, size_t max_size, std::span<std::byte const> other);
+
+// greedy reduction of a failing input: keeps every simpler candidate for which still_fails holds
+// - first removes chunks (from the whole input down to single bytes), then replaces bytes by zero
+// - calls still_fails at most max_attempts times
+[[nodiscard]] std::vector<std::byte> minimize_input(std::vector<std::byte> input,
+                                                    std::function<bool(std::span<std::byte const>)> const& still_fails,
+                                                    int max_attempts);
+
+} // namespace nx::impl
@@ -1,12 +1,22 @@
 #include "run.hh"
 
+#include <nexus/tests/benchmark_report.hh>
+#include <nexus/tests/durations.hh>
 #include <nexus/tests/execute.hh>
+#include <nexus/tests/parallel.hh>
 #include <nexus/tests/registry.hh>
 #include <nexus/tests/schedule.hh>
+#include <nexus/tests/trace.hh>
 
 #include <clean-core/assert.hh>
 
+#include <algorithm>
+#include <ctime>
+#include <format>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <ranges>
 
 namespace
 {
@@ -37,7 +47,28 @@ void print_help()
     // Advertise Catch2 compatibility to enable C++ TestMate IDE extension recognition
     std::cout << "Compatible with Catch2 v3.11.0 in some args\n\n";
     std::cout << "Usage:\n";
-    std::cout << "  <test-executable> [options]\n\n";
+    std::cout << "  <test-executable> [options] [test name filters...]\n\n";
+    std::cout << "Options:\n";
+    std::cout << "  -v                        verbose output\n";
+    std::cout << "  --benchmark-out=<file>    write benchmark results as Google Benchmark JSON\n";
+    std::cout << "  --trace-out=<file>        write a timeline of tests, sections, and workers (Chrome trace JSON)\n";
+    std::cout << "  --profile[=<dir>]         sample each test, write folded stacks (default dir: nexus-profile)\n";
+    std::cout << "  --profile-frequency=<hz>  profiler samples per second of CPU time (default: 1000)\n";
+    std::cout << "  --max-failures=<n>        failed checks recorded per test, the rest is counted (default: 1000)\n";
+    std::cout << "  --max-failures-per-location=<n>\n";
+    std::cout << "                            failed checks recorded per CHECK location (default: 100, 0: unlimited)\n";
+    std::cout << "  --durations[=<n>]         report the n slowest tests (default: 10), with --durations-history also regressions\n";
+    std::cout << "  --durations-history=<f>   timing history to compare against and append to\n";
+    std::cout << "  --fuzz                    explore new inputs in FUZZ_TESTs (default: corpus regression)\n";
+    std::cout << "  --fuzz-time=<seconds>     exploration time per FUZZ_TEST (default: 60)\n";
+    std::cout << "  --fuzz-jobs=<n>           forked fuzzing workers sharing corpus and coverage (0: all cores)\n";
+    std::cout << "  --fuzz-corpus=<dir>       corpus root, one subdirectory per FUZZ_TEST\n";
+    std::cout << "  --fuzz-minimize-corpus    shrink each corpus to a subset with the same coverage\n";
+    std::cout << "  --fuzz-cost=<edges|time>  also search for slow inputs and report the most expensive ones\n";
+    std::cout << "  --property-cases=<n>      generated inputs per PROPERTY (default: 100)\n";
+    std::cout << "  -j, --jobs=<n>            threads for parallel work in tests, shared by all tests (0: all cores, default: 0)\n";
+    std::cout << "  --property-jobs=<n>       PROPERTY cases evaluated in parallel (0: all jobs, default: 1)\n";
+    std::cout << "  --interleavings=<n>       thread schedules explored per INTERLEAVINGS (default: 1000)\n\n";
     std::cout << "For more information, see the nexus documentation.\n";
 }
 
@@ -62,17 +93,21 @@ void print_catch2_xml_discovery(nx::test_registry const& registry)
     std::cout << "</MatchingTests>\n";
 }
 
-void print_section_expressions(nx::test_execution::section const& sec,
+void print_section_expressions(nx::test_execution const& exec,
+                               nx::test_execution::section const& sec,
                                std::string const& indent,
                                int& error_count,
                                int max_errors)
 {
-    // Print errors/expressions for this section
-    for (auto const& error : sec.errors)
+    // Print errors/expressions for this section (subsections print their own)
+    for (auto const& error : exec.own_errors_of(sec))
     {
         if (error_count >= max_errors)
             return;
 
+        for (auto const& info : error.info)
+            std::cout << indent << "<Info>" << xml_escape(info) << "</Info>\n";
+
         std::cout << indent << "<Expression success=\"false\" ";
         std::cout << "filename=\"" << xml_escape(error.location.file_name()) << "\" ";
         std::cout << "line=\"" << error.location.line() << "\">\n";
@@ -84,13 +119,14 @@ void print_section_expressions(nx::test_execution::section const& sec,
     }
 }
 
-void print_section_recursive(nx::test_execution::section const& sec,
+void print_section_recursive(nx::test_execution const& exec,
+                             nx::test_execution::section const& sec,
                              std::string const& indent,
                              int& error_count,
                              int max_errors)
 {
     // Print expressions for this section (top-level section errors appear before subsections)
-    print_section_expressions(sec, indent, error_count, max_errors);
+    print_section_expressions(exec, sec, indent, error_count, max_errors);
 
     // Print subsections
     for (auto const& subsec : sec.subsections)
@@ -100,7 +136,7 @@ void print_section_recursive(nx::test_execution::section const& sec,
         std::cout << "line=\"" << subsec.location.line() << "\">\n";
 
         // Recursively print subsection content
-        print_section_recursive(subsec, indent + "  ", error_count, max_errors);
+        print_section_recursive(exec, subsec, indent + "  ", error_count, max_errors);
 
         // Print section summary
         // If the section is considered failing but has 0 failed checks (e.g., missing CHECK),
@@ -120,7 +156,6 @@ void print_catch2_execute_result(nx::test_schedule_execution const& execution)
 {
     // TODO(catch2-xml):
     // - Emit captured StdOut / StdErr elements (useful for failure diagnostics and hung tests).
-    // - Support INFO/CAPTURE-style contextual messages in XML, not just failed expressions.
     // - Model partial test-case runs (SECTION re-entry / partNumber) instead of only a merged section tree.
     // - Add benchmark result reporting hooks (even if unimplemented for now).
     // - Include run metadata (run name, RNG seed) for reproducibility/debugging.
@@ -144,16 +179,136 @@ void print_catch2_execute_result(nx::test_schedule_execution const& execution)
         // Print all sections and expressions recursively (capped at max_errors)
         int const max_errors = 50;
         int error_count = 0;
-        print_section_recursive(exec.root, "    ", error_count, max_errors);
+        print_section_recursive(exec, exec.root, "    ", error_count, max_errors);
+
+        // not part of Catch2's schema, unknown elements are ignored by its consumers
+        auto const& res = exec.resources;
+        std::cout << "    <ResourceUsage ";
+        std::cout << "userCpuSeconds=\"" << res.user_cpu_seconds << "\" ";
+        std::cout << "systemCpuSeconds=\"" << res.system_cpu_seconds << "\" ";
+        std::cout << "peakRssGrowthBytes=\"" << res.peak_rss_bytes << "\" ";
+        std::cout << "minorPageFaults=\"" << res.minor_page_faults << "\" ";
+        std::cout << "majorPageFaults=\"" << res.major_page_faults << "\" ";
+        std::cout << "voluntaryContextSwitches=\"" << res.voluntary_context_switches << "\" ";
+        std::cout << "involuntaryContextSwitches=\"" << res.involuntary_context_switches << "\"/>\n";
 
         // Print test case summary
+        // the nx::log records of failed tests are shown as its output
         std::cout << "    <OverallResult success=\"" << (success ? "true" : "false") << "\" ";
-        std::cout << "durationInSeconds=\"" << exec.root.duration_seconds << "\"/>\n";
+        std::cout << "durationInSeconds=\"" << exec.root.duration_seconds << "\"";
+        if (exec.log.empty())
+            std::cout << "/>\n";
+        else
+        {
+            std::cout << ">\n      <StdOut>\n";
+            for (auto const& line : exec.log)
+                std::cout << xml_escape(line) << '\n';
+            std::cout << "      </StdOut>\n    </OverallResult>\n";
+        }
         std::cout << "  </TestCase>\n";
     }
 
     std::cout << "</TestRun>\n";
 }
+
+std::string format_duration(double seconds)
+{
+    auto const ns = seconds * 1e9;
+    if (ns < 1e3)
+        return std::format("{:.2f} ns", ns);
+    if (ns < 1e6)
+        return std::format("{:.2f} us", ns / 1e3);
+    if (ns < 1e9)
+        return std::format("{:.2f} ms", ns / 1e6);
+    return std::format("{:.2f} s", ns / 1e9);
+}
+
+void print_benchmark_results(nx::test_schedule_execution const& execution)
+{
+    auto has_benchmarks = false;
+    size_t name_width = 9; // "benchmark"
+    for (auto const& exec : execution.executions)
+        for (auto const& bench : exec.benchmarks)
+        {
+            has_benchmarks = true;
+            name_width = std::max(name_width, bench.name.size());
+        }
+
+    if (!has_benchmarks)
+        return;
+
+    std::cout << "\n" << std::left << std::setw(int(name_width)) << "benchmark" << "  " << std::right << std::setw(12)
+              << "time/iter" << "  " << std::setw(12) << "cpu/iter" << "  " << std::setw(12) << "iterations" << "\n";
+    std::cout << std::string(name_width + 42, '-') << "\n";
+    for (auto const& exec : execution.executions)
+        for (auto const& bench : exec.benchmarks)
+            std::cout << std::left << std::setw(int(name_width)) << bench.name << "  " << std::right << std::setw(12)
+                      << format_duration(bench.real_time_per_iteration()) << "  " << std::setw(12)
+                      << format_duration(bench.cpu_time_per_iteration()) << "  " << std::setw(12) << bench.iterations
+                      << "\n";
+    std::cout << "\n";
+}
+
+// tests that spend a notable part of their time re-running section prefixes to reach further sections
+void print_reentry_overhead(nx::test_schedule_execution const& execution)
+{
+    constexpr double min_seconds = 1e-3;
+    constexpr double min_fraction = 0.1;
+    constexpr size_t max_shown = 10;
+
+    std::vector<nx::test_execution const*> candidates;
+    for (auto const& exec : execution.executions)
+    {
+        auto const repeated = exec.repeated_prefix_seconds();
+        if (repeated >= min_seconds && repeated >= min_fraction * exec.root.duration_seconds)
+            candidates.push_back(&exec);
+    }
+
+    if (candidates.empty())
+        return;
+
+    std::ranges::sort(candidates, std::ranges::greater{}, &nx::test_execution::repeated_prefix_seconds);
+    std::cout << "\nsection re-entry overhead (time re-running shared prefixes to reach further sections):\n";
+    for (auto const exec : candidates | std::views::take(max_shown))
+    {
+        auto const repeated = exec->repeated_prefix_seconds();
+        std::cout << std::format("  {:>10}  {:5.1f}% of {:<10}  {}\n", format_duration(repeated),
+                                 100.0 * repeated / exec->root.duration_seconds, format_duration(exec->root.duration_seconds),
+                                 exec->instance.declaration->name);
+    }
+}
+
+void print_slowest_tests(nx::test_schedule_execution const& execution, int max_shown)
+{
+    std::vector<nx::test_execution const*> tests;
+    for (auto const& exec : execution.executions)
+        tests.push_back(&exec);
+    if (tests.empty() || max_shown <= 0)
+        return;
+
+    auto const duration = [](nx::test_execution const* exec) { return exec->root.duration_seconds; };
+    std::ranges::sort(tests, std::ranges::greater{}, duration);
+    std::cout << "\nslowest tests:\n";
+    for (auto const exec : tests | std::views::take(max_shown))
+        std::cout << std::format("  {:>10}  {}\n", format_duration(duration(exec)), exec->instance.declaration->name);
+}
+
+// tests and sections that got notably slower than in earlier builds
+void print_duration_regressions(std::span<nx::duration_regression const> regressions)
+{
+    constexpr size_t max_shown = 20;
+
+    if (regressions.empty())
+        return;
+
+    std::cout << "\nslower than in earlier builds (median of up to "
+              << nx::duration_regression_config{}.history_window << " previous runs):\n";
+    for (auto const& r : regressions | std::views::take(max_shown))
+        std::cout << std::format("  {:>10} -> {:<10}  {:+6.1f}%  {}\n", format_duration(r.baseline_seconds),
+                                 format_duration(r.seconds), 100.0 * (r.seconds / r.baseline_seconds - 1.0), r.name);
+    if (regressions.size() > max_shown)
+        std::cout << "  ... and " << regressions.size() - max_shown << " more\n";
+}
 } // namespace
 
 int nx::run(int argc, char** argv)
@@ -198,9 +353,41 @@ int nx::run(int argc, char** argv)
         std::cout << std::endl; // NOLINT
     }
 
+    if (!config.trace_out_file.empty())
+    {
+        impl::start_tracing();
+        impl::trace_set_thread_name("main");
+    }
+
+    // parallel work of all tests shares one pool, instead of every test oversubscribing the machine
+    impl::configure_workers(config.jobs);
+
     // Execute the scheduled tests
     auto execution = execute_tests(schedule, config);
 
+    if (!config.trace_out_file.empty())
+    {
+        impl::stop_tracing();
+        std::ofstream out(config.trace_out_file);
+        if (!out)
+        {
+            std::cerr << "Error: Could not open trace output file `" << config.trace_out_file << "'\n";
+            return 1;
+        }
+        impl::write_trace_json(out);
+    }
+
+    if (!config.benchmark_out_file.empty())
+    {
+        std::ofstream out(config.benchmark_out_file);
+        if (!out)
+        {
+            std::cerr << "Error: Could not open benchmark output file `" << config.benchmark_out_file << "'\n";
+            return 1;
+        }
+        write_benchmark_json(out, benchmark_context::collect(argv[0]), execution);
+    }
+
     // Handle Catch2 XML results reporting for TestMate integration
     if (config.report_catch2_xml_results)
     {
@@ -208,6 +395,21 @@ int nx::run(int argc, char** argv)
         return execution.count_failed_tests() > 0 ? 1 : 0;
     }
 
+    print_benchmark_results(execution);
+    print_reentry_overhead(execution);
+
+    if (config.report_durations)
+        print_slowest_tests(execution, config.durations_top);
+
+    if (!config.durations_history_file.empty())
+    {
+        auto const history = impl::read_duration_history(config.durations_history_file);
+        auto const current = impl::collect_duration_records(execution, impl::current_build_id(), std::time(nullptr));
+        print_duration_regressions(impl::find_duration_regressions(history, current));
+        if (!impl::append_duration_history(config.durations_history_file, current))
+            std::cerr << "Error: Could not append to durations history `" << config.durations_history_file << "'\n";
+    }
+
     // Check for failures
     int const failed_tests = execution.count_failed_tests();
     int const total_tests = execution.count_total_tests();
@@ -228,6 +430,14 @@ int nx::run(int argc, char** argv)
                     std::cerr << "  " << decl->name << " at " << decl->location.file_name() << ":"
                               << decl->location.line() << "\n";
                 }
+
+                // the most recent nx::log records, the XML report has all of them
+                constexpr size_t max_printed_log_lines = 32;
+                auto const skipped = exec.log.size() - std::min(exec.log.size(), max_printed_log_lines);
+                if (skipped > 0)
+                    std::cerr << "    log: ... " << skipped << " earlier records\n";
+                for (auto const& line : exec.log | std::views::drop(skipped))
+                    std::cerr << "    log: " << line << "\n";
             }
         }
 
@@ -1,8 +1,17 @@
 #pragma once
 
+#include <nexus/tests/benchmark.hh>
 #include <nexus/tests/check.hh>
+#include <nexus/tests/concurrent.hh>
 #include <nexus/tests/config.hh>
+#include <nexus/tests/info.hh>
+#include <nexus/tests/log.hh>
+#include <nexus/tests/parallel.hh>
+#include <nexus/tests/property.hh>
+#include <nexus/tests/range_check.hh>
+#include <nexus/tests/sched.hh>
 #include <nexus/tests/section.hh>
+#include <nexus/tests/trace.hh>
 
 #include <clean-core/macros.hh>
 
@@ -0,0 +1,67 @@
+#include "benchmark.hh"
+
+#include <nexus/tests/execute.hh>
+#include <nexus/tests/profile.hh>
+#include <nexus/tests/trace.hh>
+
+#include <algorithm>
+#include <format>
+
+namespace
+{
+// a measurement shorter than this is dominated by noise and timer granularity
+constexpr double min_measurement_seconds = 0.1;
+
+// upper bounds so that bodies with mostly paused time still terminate quickly
+constexpr double max_batch_wall_seconds = 1.0;
+constexpr std::int64_t max_iterations = 1'000'000'000;
+} // namespace
+
+void nx::impl::run_benchmark(std::string name,
+                             std::source_location location,
+                             std::move_only_function<void(benchmark_state&, std::int64_t)> run_batch)
+{
+    auto const _trace = trace_scope(name, "benchmark");
+    auto const _profile = impl::scoped_profile_label(std::format("BENCHMARK {}", name));
+
+    benchmark_state state;
+    auto sw = stopwatch(/* tracks_cpu_time */ true);
+    auto const _ = impl::scoped_active_stopwatch(sw);
+
+    // grow the batch size until a single batch takes long enough
+    // (same strategy as Google Benchmark: extrapolate with 40% headroom, at most 10x per step)
+    std::int64_t iterations = 1;
+    double elapsed = 0.0;
+    resource_usage resources;
+    while (true)
+    {
+        auto const resources_at_start = impl::read_resource_usage();
+        auto const wall_start = tick_clock::now();
+        sw.start();
+        run_batch(state, iterations);
+        sw.pause();
+        auto const wall = tick_clock::to_seconds(tick_clock::now_ordered() - wall_start);
+        resources = impl::read_resource_usage().since(resources_at_start);
+        elapsed = sw.elapsed_seconds();
+
+        if (elapsed >= min_measurement_seconds || wall >= max_batch_wall_seconds || iterations >= max_iterations)
+            break;
+
+        auto multiplier = min_measurement_seconds * 1.4 / std::max(elapsed, 1e-9);
+        if (elapsed / min_measurement_seconds <= 0.1)
+            multiplier = std::min(multiplier, 10.0);
+        multiplier = std::min(multiplier, max_batch_wall_seconds / std::max(wall, 1e-9));
+        auto const next = std::int64_t(double(iterations) * multiplier);
+        iterations = std::clamp(next, iterations + 1, max_iterations);
+    }
+
+    impl::report_benchmark_result(benchmark_result{
+        .name = std::move(name),
+        .location = location,
+        .iterations = iterations,
+        .real_time_seconds = elapsed,
+        .cpu_time_seconds = sw.elapsed_cpu_seconds(),
+        .counters = std::move(state.counters),
+        .resources = resources,
+    });
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <nexus/tests/timer.hh>
+
+#include <cstdint>
+#include <format> // NOLINT(unused-includes) - used by BENCHMARK macro
+#include <functional>
+#include <map>
+#include <source_location>
+#include <string>
+#include <type_traits>
+
+namespace nx
+{
+// optional parameter of a BENCHMARK body
+// gives control over what part of an iteration is timed
+struct benchmark_state
+{
+    // excludes per-iteration setup from the measurement
+    // the calibrated timer overhead is subtracted for each paused/resumed segment
+    void pause_timing() { nx::pause_timer(); }
+    void resume_timing() { nx::resume_timer(); }
+
+    // user counters, reported next to the timings (e.g. in --benchmark-out)
+    // usage: state.counters["bytes"] = double(buffer.size());
+    std::map<std::string, double> counters;
+};
+} // namespace nx
+
+namespace nx::impl
+{
+// keeps the compiler from optimizing away benchmark results
+template <class T>
+void do_not_optimize(T const& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static void const* volatile sink;
+    sink = &value;
+#endif
+}
+
+// runs batches of iterations until the measurement is long enough and reports the result to the current test
+void run_benchmark(std::string name,
+                   std::source_location location,
+                   std::move_only_function<void(benchmark_state&, std::int64_t)> run_batch);
+
+struct benchmark_runner
+{
+    std::string name;
+    std::source_location location;
+
+    template <class Fn>
+    void operator=(Fn&& fn) // NOLINT(misc-unconventional-assign-operator,cppcoreguidelines-c-copy-assignment-signature)
+    {
+        impl::run_benchmark(std::move(name), location,
+                            [&fn](benchmark_state& state, std::int64_t iterations)
+                            {
+                                for (std::int64_t i = 0; i < iterations; ++i)
+                                {
+                                    if constexpr (std::is_invocable_v<Fn&, benchmark_state&>)
+                                    {
+                                        if constexpr (std::is_void_v<std::invoke_result_t<Fn&, benchmark_state&>>)
+                                            fn(state);
+                                        else
+                                            impl::do_not_optimize(fn(state));
+                                    }
+                                    else
+                                    {
+                                        static_assert(std::is_invocable_v<Fn&>, "BENCHMARK body must take no "
+                                                                                "arguments or nx::benchmark_state&");
+                                        if constexpr (std::is_void_v<std::invoke_result_t<Fn&>>)
+                                            fn();
+                                        else
+                                            impl::do_not_optimize(fn());
+                                    }
+                                }
+                            });
+    }
+};
+} // namespace nx::impl
+
+// BENCHMARK macro: measures the per-iteration time of a body inside a TEST
+// - the body is run in batches until the measurement is long enough
+// - non-void return values are kept alive so the work is not optimized away
+// - counts as a passing check of the surrounding test
+//
+// usage:
+//   BENCHMARK("vector push_back")
+//   {
+//       std::vector<int> v;
+//       for (auto i = 0; i < 1000; ++i)
+//           v.push_back(i);
+//       return v;
+//   };
+//
+//   BENCHMARK("sort {} elements", n)(nx::benchmark_state& state)
+//   {
+//       state.pause_timing();
+//       auto data = make_shuffled(n); // not timed
+//       state.resume_timing();
+//       std::sort(data.begin(), data.end());
+//   };
+#define BENCHMARK(name, ...)                                                                                 \
+    ::nx::impl::benchmark_runner{std::format(name __VA_OPT__(, ) __VA_ARGS__), std::source_location::current()} \
+        = [&]
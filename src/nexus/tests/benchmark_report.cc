@@ -0,0 +1,255 @@
+#include "benchmark_report.hh"
+
+#include <nexus/tests/json.hh>
+#include <nexus/tests/timer.hh>
+
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <ostream>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#define NX_IMPL_HAS_POSIX 1
+#else
+#define NX_IMPL_HAS_POSIX 0
+#endif
+
+namespace
+{
+// JSON has no inf/nan, Google Benchmark writes them as strings too
+std::string json_number(double value)
+{
+    if (std::isnan(value))
+        return "\"nan\"";
+    if (std::isinf(value))
+        return value > 0 ? "\"inf\"" : "\"-inf\"";
+    return std::format("{}", value);
+}
+
+std::string read_first_line(std::filesystem::path const& path)
+{
+    std::ifstream file(path);
+    std::string line;
+    if (file)
+        std::getline(file, line);
+    return line;
+}
+
+// e.g. "32K" -> 32768
+std::int64_t parse_cache_size(std::string_view str)
+{
+    std::int64_t value = 0;
+    size_t i = 0;
+    while (i < str.size() && str[i] >= '0' && str[i] <= '9')
+        value = value * 10 + (str[i++] - '0');
+
+    if (i < str.size())
+    {
+        switch (str[i])
+        {
+        case 'K': value *= 1024; break;
+        case 'M': value *= 1024 * 1024; break;
+        case 'G': value *= 1024 * 1024 * 1024; break;
+        default: break;
+        }
+    }
+
+    return value;
+}
+
+// e.g. "0-1,4" -> 3
+int count_cpu_list(std::string_view list)
+{
+    int count = 0;
+    while (!list.empty())
+    {
+        auto const comma = list.find(',');
+        auto const item = list.substr(0, comma);
+        auto const dash = item.find('-');
+        if (dash == std::string_view::npos)
+            count += item.empty() ? 0 : 1;
+        else
+        {
+            auto const first = std::atoi(std::string(item.substr(0, dash)).c_str());
+            auto const last = std::atoi(std::string(item.substr(dash + 1)).c_str());
+            count += last - first + 1;
+        }
+        list = comma == std::string_view::npos ? std::string_view{} : list.substr(comma + 1);
+    }
+    return count;
+}
+
+std::vector<nx::benchmark_context::cache> collect_caches()
+{
+    std::vector<nx::benchmark_context::cache> caches;
+
+    std::error_code ec;
+    std::filesystem::path const cache_dir = "/sys/devices/system/cpu/cpu0/cache";
+    for (auto i = 0;; ++i)
+    {
+        auto const index_dir = cache_dir / std::format("index{}", i);
+        if (!std::filesystem::exists(index_dir, ec))
+            break;
+
+        caches.push_back({
+            .type = read_first_line(index_dir / "type"),
+            .level = std::atoi(read_first_line(index_dir / "level").c_str()),
+            .size = parse_cache_size(read_first_line(index_dir / "size")),
+            .num_sharing = count_cpu_list(read_first_line(index_dir / "shared_cpu_list")),
+        });
+    }
+
+    return caches;
+}
+
+double collect_mhz_per_cpu()
+{
+    // maximum frequency is the most stable number, current frequency fluctuates
+    auto const max_khz = read_first_line("/sys/devices/system/cpu/cpu0/cpufreq/cpuinfo_max_freq");
+    if (!max_khz.empty())
+        return std::atof(max_khz.c_str()) / 1000.0;
+
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line))
+        if (line.starts_with("cpu MHz"))
+            if (auto const colon = line.find(':'); colon != std::string::npos)
+                return std::atof(line.c_str() + colon + 1);
+
+    // invariant TSC ticks at the nominal frequency
+    if (nx::tick_clock::is_tsc())
+        return 1e-6 / nx::tick_clock::seconds_per_tick();
+
+    return 0.0;
+}
+
+std::string collect_date()
+{
+    auto const now = std::time(nullptr);
+    std::tm local_time{};
+#if NX_IMPL_HAS_POSIX
+    localtime_r(&now, &local_time);
+#else
+    localtime_s(&local_time, &now);
+#endif
+
+    char buffer[64];
+    auto const len = std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S%z", &local_time);
+    std::string date(buffer, len);
+
+    // +0100 -> +01:00 (ISO 8601 extended format, as written by Google Benchmark)
+    if (date.size() >= 5)
+        date.insert(date.size() - 2, ":");
+    return date;
+}
+} // namespace
+
+nx::benchmark_context nx::benchmark_context::collect(std::string_view executable)
+{
+    benchmark_context context;
+
+    context.date = collect_date();
+    context.executable = executable;
+    context.num_cpus = int(std::thread::hardware_concurrency());
+    context.mhz_per_cpu = collect_mhz_per_cpu();
+    context.caches = collect_caches();
+
+#if NX_IMPL_HAS_POSIX
+    char host_name[256] = {};
+    if (gethostname(host_name, sizeof(host_name) - 1) == 0)
+        context.host_name = host_name;
+
+    double load_avg[3] = {};
+    auto const load_count = getloadavg(load_avg, 3);
+    for (auto i = 0; i < load_count; ++i)
+        context.load_avg.push_back(load_avg[i]);
+#endif
+
+    auto const governor = read_first_line("/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor");
+    context.cpu_scaling_enabled = !governor.empty() && governor != "performance";
+
+#ifdef NDEBUG
+    context.library_build_type = "release";
+#else
+    context.library_build_type = "debug";
+#endif
+
+    return context;
+}
+
+void nx::write_benchmark_json(std::ostream& out, benchmark_context const& context, test_schedule_execution const& execution)
+{
+    out << "{\n";
+    out << "  \"context\": {\n";
+    out << "    \"date\": \"" << impl::json_escape(context.date) << "\",\n";
+    out << "    \"host_name\": \"" << impl::json_escape(context.host_name) << "\",\n";
+    out << "    \"executable\": \"" << impl::json_escape(context.executable) << "\",\n";
+    out << "    \"num_cpus\": " << context.num_cpus << ",\n";
+    out << "    \"mhz_per_cpu\": " << json_number(context.mhz_per_cpu) << ",\n";
+    out << "    \"cpu_scaling_enabled\": " << (context.cpu_scaling_enabled ? "true" : "false") << ",\n";
+    out << "    \"caches\": [";
+    for (size_t i = 0; i < context.caches.size(); ++i)
+    {
+        auto const& c = context.caches[i];
+        out << (i == 0 ? "\n" : ",\n");
+        out << "      {\n";
+        out << "        \"type\": \"" << impl::json_escape(c.type) << "\",\n";
+        out << "        \"level\": " << c.level << ",\n";
+        out << "        \"size\": " << c.size << ",\n";
+        out << "        \"num_sharing\": " << c.num_sharing << "\n";
+        out << "      }";
+    }
+    out << (context.caches.empty() ? "],\n" : "\n    ],\n");
+    out << "    \"load_avg\": [";
+    for (size_t i = 0; i < context.load_avg.size(); ++i)
+        out << (i == 0 ? "" : ",") << json_number(context.load_avg[i]);
+    out << "],\n";
+    out << "    \"library_build_type\": \"" << impl::json_escape(context.library_build_type) << "\"\n";
+    out << "  },\n";
+
+    out << "  \"benchmarks\": [";
+    auto family_index = 0;
+    for (auto const& exec : execution.executions)
+    {
+        for (auto const& bench : exec.benchmarks)
+        {
+            // each nexus benchmark is its own family with a single instance and repetition
+            out << (family_index == 0 ? "\n" : ",\n");
+            out << "    {\n";
+            out << "      \"name\": \"" << impl::json_escape(bench.name) << "\",\n";
+            out << "      \"family_index\": " << family_index << ",\n";
+            out << "      \"per_family_instance_index\": 0,\n";
+            out << "      \"run_name\": \"" << impl::json_escape(bench.name) << "\",\n";
+            out << "      \"run_type\": \"iteration\",\n";
+            out << "      \"repetitions\": 1,\n";
+            out << "      \"repetition_index\": 0,\n";
+            out << "      \"threads\": 1,\n";
+            out << "      \"iterations\": " << bench.iterations << ",\n";
+            out << "      \"real_time\": " << json_number(bench.real_time_per_iteration() * 1e9) << ",\n";
+            out << "      \"cpu_time\": " << json_number(bench.cpu_time_per_iteration() * 1e9) << ",\n";
+            out << "      \"time_unit\": \"ns\"";
+            for (auto const& [name, value] : bench.counters)
+                out << ",\n      \"" << impl::json_escape(name) << "\": " << json_number(value);
+
+            // resource usage per iteration, extra fields are ignored by Google Benchmark tooling
+            auto const per_iteration = [&](auto value)
+            { return json_number(bench.iterations > 0 ? double(value) / double(bench.iterations) : 0.0); };
+            auto const& res = bench.resources;
+            out << ",\n      \"system_time\": " << per_iteration(res.system_cpu_seconds * 1e9);
+            out << ",\n      \"peak_rss_growth_bytes\": " << res.peak_rss_bytes;
+            out << ",\n      \"minor_page_faults\": " << per_iteration(res.minor_page_faults);
+            out << ",\n      \"major_page_faults\": " << per_iteration(res.major_page_faults);
+            out << ",\n      \"voluntary_context_switches\": " << per_iteration(res.voluntary_context_switches);
+            out << ",\n      \"involuntary_context_switches\": " << per_iteration(res.involuntary_context_switches);
+            out << "\n    }";
+            ++family_index;
+        }
+    }
+    out << (family_index == 0 ? "]\n" : "\n  ]\n");
+    out << "}\n";
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <nexus/tests/execute.hh>
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace nx
+{
+// machine description that accompanies benchmark results
+// mirrors the "context" block of Google Benchmark's JSON output
+struct benchmark_context
+{
+    struct cache
+    {
+        std::string type; // "Data", "Instruction", or "Unified"
+        int level = 0;
+        std::int64_t size = 0; // in bytes
+        int num_sharing = 0;   // logical CPUs sharing this cache
+    };
+
+    std::string date; // ISO 8601, local time
+    std::string host_name;
+    std::string executable;
+    int num_cpus = 0;
+    double mhz_per_cpu = 0.0;
+    bool cpu_scaling_enabled = false;
+    std::vector<cache> caches;
+    std::vector<double> load_avg;
+    std::string library_build_type; // "debug" or "release"
+
+    // best effort, fields that cannot be determined keep their defaults
+    static benchmark_context collect(std::string_view executable);
+};
+
+// writes all benchmark results of the execution in Google Benchmark's JSON schema
+// (so tools like compare.py and existing dashboards can consume them)
+void write_benchmark_json(std::ostream& out, benchmark_context const& context, test_schedule_execution const& execution);
+
+} // namespace nx
@@ -33,6 +33,18 @@ nx::impl::check_handle nx::impl::check_handle::make(check_kind kind,
     return handle;
 }
 
+nx::impl::check_handle nx::impl::check_handle::make(check_kind kind,
+                                                    cmp_op op,
+                                                    char const* expr_text,
+                                                    bool passed,
+                                                    std::source_location loc,
+                                                    std::vector<std::string> extra_lines)
+{
+    auto handle = make(kind, op, expr_text, passed, loc);
+    handle.ctx->extra_lines = std::move(extra_lines);
+    return handle;
+}
+
 nx::impl::check_handle::~check_handle() noexcept(false)
 {
     if (ctx)
@@ -1,10 +1,14 @@
 #pragma once
 
+#include <nexus/tests/container_diff.hh>
+
 #include <clean-core/string.hh>
 #include <clean-core/to_debug_string.hh>
 
 #include <source_location>
+#include <string>
 #include <type_traits>
+#include <vector>
 
 // TODO: remove once cc is far enough again
 #include <memory>
@@ -151,6 +155,13 @@ struct check_handle final
     }
 
     static check_handle make(check_kind kind, cmp_op op, char const* expr_text, bool passed, std::source_location loc);
+    // with pre-formatted extra lines (e.g. for range checks)
+    static check_handle make(check_kind kind,
+                             cmp_op op,
+                             char const* expr_text,
+                             bool passed,
+                             std::source_location loc,
+                             std::vector<std::string> extra_lines);
 
 private:
     check_handle add_extra_line(cc::string line) &&;
@@ -163,9 +174,14 @@ check_handle make_check_handle(check_kind kind,
                                binary_expr_capture<L, R> const& expr,
                                std::source_location loc)
 {
-    return check_handle::make(kind, expr.op, expr_text, expr.passed, loc) //
-        .dump(expr.lhs)                                                   //
-        .dump(expr.rhs);
+    if (expr.passed)
+        return check_handle::make(kind, expr.op, expr_text, true, loc);
+
+    // lhs and rhs dumps first (the expanded expression), then the diff of containers
+    std::vector<std::string> lines = {bounded_debug_string(expr.lhs), bounded_debug_string(expr.rhs)};
+    if (expr.op == cmp_op::equal)
+        append_container_diff(lines, expr.lhs, expr.rhs);
+    return check_handle::make(kind, expr.op, expr_text, false, loc, std::move(lines));
 }
 
 template <class T>
@@ -0,0 +1,81 @@
+#include "concurrent.hh"
+
+#include <nexus/tests/crash.hh>
+#include <nexus/tests/execute.hh>
+#include <nexus/tests/hash.hh>
+#include <nexus/tests/registry.hh>
+#include <nexus/tests/trace.hh>
+
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <format>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace
+{
+thread_local int g_concurrent_thread_index = -1;
+thread_local int g_concurrent_iteration = -1;
+thread_local std::uint64_t g_concurrent_seed = 0;
+} // namespace
+
+int nx::concurrent_thread_index() { return g_concurrent_thread_index; }
+int nx::concurrent_iteration() { return g_concurrent_iteration; }
+std::uint64_t nx::concurrent_seed() { return g_concurrent_seed; }
+
+void nx::impl::run_concurrently(test_declaration const& declaration)
+{
+    auto const& config = declaration.test_config;
+    auto const threads = std::max(config.concurrent_threads, 1);
+    auto const iterations = std::max(config.concurrent_iterations, 1);
+    auto const seed = config.seed != 0 ? splitmix64_mix(std::uint64_t(config.seed)) : fnv1a(declaration.name);
+
+    // all threads pass the barrier before each iteration, so they start the body at (almost) the same time
+    // a failure stops all threads after the iteration: the barrier completion decides once for everyone,
+    // reading has_failed after the barrier would race with threads still failing in the current iteration
+    std::atomic<bool> has_failed = false;
+    bool should_stop = false;
+    std::barrier start(threads, [&]() noexcept { should_stop = has_failed.load(std::memory_order_relaxed); });
+
+    auto const work = [&](int thread_index)
+    {
+        trace_set_thread_name(std::format("concurrent thread {}", thread_index));
+        auto _crash = scoped_crash_context(
+            [&] { return std::format("concurrent thread {} in iteration {}", thread_index, g_concurrent_iteration); });
+
+        g_concurrent_thread_index = thread_index;
+        for (auto i = 0; i < iterations; ++i)
+        {
+            start.arrive_and_wait();
+            if (should_stop)
+                break;
+
+            g_concurrent_iteration = i;
+            g_concurrent_seed = splitmix64_mix(seed ^ splitmix64_mix((std::uint64_t(i) << 32) | std::uint64_t(thread_index)));
+
+            // REQUIRE and exceptions end the body of this thread, the others are unaffected
+            auto captured = run_captured([&] { (*declaration.function)(); }, declaration.location);
+            if (!captured.is_failing())
+            {
+                report_captured_checks(std::move(captured), {});
+                continue;
+            }
+
+            has_failed.store(true, std::memory_order_relaxed);
+            report_captured_checks(std::move(captured),
+                                   {std::format("in iteration {} of {} on thread {} of {} (concurrent_seed {})", i,
+                                                iterations, thread_index, threads, g_concurrent_seed)});
+        }
+
+        g_concurrent_thread_index = -1;
+        g_concurrent_iteration = -1;
+        g_concurrent_seed = 0;
+    };
+
+    std::vector<std::jthread> workers;
+    workers.reserve(size_t(threads));
+    for (auto t = 0; t < threads; ++t)
+        workers.emplace_back(work, t);
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+
+namespace nx
+{
+struct test_declaration;
+
+// inside the body of a test with nx::config::concurrent (-1 or 0 elsewhere)
+// - thread index in [0, threads)
+// - iteration in [0, iterations)
+// - seed that differs per thread and iteration, deterministic per test (derived from nx::config::seed or the test name)
+[[nodiscard]] int concurrent_thread_index();
+[[nodiscard]] int concurrent_iteration();
+[[nodiscard]] std::uint64_t concurrent_seed();
+} // namespace nx
+
+namespace nx::impl
+{
+// runs the test function as configured by nx::config::concurrent
+// checks are attributed to the current test like those of any thread started by it (see report_check_result)
+void run_concurrently(test_declaration const& declaration);
+} // namespace nx::impl
@@ -6,4 +6,10 @@ void nx::impl::apply_config_item(config::cfg& result, config::cfg const& rhs)
 
     if (rhs.seed != 0)
         result.seed = rhs.seed;
+
+    if (rhs.concurrent_threads != 0)
+    {
+        result.concurrent_threads = rhs.concurrent_threads;
+        result.concurrent_iterations = rhs.concurrent_iterations;
+    }
 }
@@ -6,6 +6,10 @@ struct cfg
 {
     bool enabled = true;
     int seed = 0;
+
+    // see concurrent(threads, iterations)
+    int concurrent_threads = 0;
+    int concurrent_iterations = 0;
 };
 
 constexpr struct
@@ -23,6 +27,27 @@ constexpr auto seed(int value)
     return seeder{value};
 }
 
+// runs the test body on `threads` threads at once, `iterations` times
+// - all threads are released together from a barrier in each iteration, to maximize contention
+// - checks of all threads count for the test, iterations stop after the first one with a failure
+// - REQUIRE ends the body of its thread for the current iteration
+// - nx::concurrent_thread_index(), nx::concurrent_iteration(), and nx::concurrent_seed() tell the threads apart
+// - SECTION is not supported in the body
+constexpr auto concurrent(int threads, int iterations = 100)
+{
+    struct concurrency
+    {
+        int threads;
+        int iterations;
+        void apply(cfg& result) const
+        {
+            result.concurrent_threads = threads;
+            result.concurrent_iterations = iterations;
+        }
+    };
+    return concurrency{threads, iterations};
+}
+
 } // namespace nx::config
 
 namespace nx::impl
@@ -0,0 +1,321 @@
+#pragma once
+
+#include <clean-core/to_debug_string.hh>
+
+#include <algorithm>
+#include <cstddef>
+#include <format>
+#include <iterator>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace nx::impl
+{
+// failure output of CHECK(a == b) for containers, bounded in size no matter how large the containers are
+// - both sides are dumped with at most max_dumped_elements elements (head and tail)
+// - sequences get an edit script (Myers diff), maps the keys that differ
+// - at most max_diff_lines diff lines (head and tail), only those are formatted
+// - elements are dumped bounded as well (nested ranges) and cut beyond max_element_chars
+// - the diff costs O((n + m) * d) comparisons for d differences, and d is bounded by max_diff_edits
+
+constexpr size_t max_dumped_elements = 16;
+constexpr size_t max_diff_lines = 24;
+constexpr size_t max_element_chars = 256;
+
+// the edit script search gives up beyond this many edits and falls back to an element-wise comparison
+constexpr size_t max_diff_edits = 128;
+
+template <class T>
+std::string debug_string(T const& value)
+{
+    return std::format("{}", cc::to_debug_string(value));
+}
+
+// strings are ranges, but are better dumped (and compared) as a whole
+template <class T>
+concept string_like = std::is_convertible_v<T const&, std::string_view>;
+
+template <class T>
+concept dumpable_sequence = std::ranges::forward_range<T const> && std::ranges::sized_range<T const> && !string_like<T>;
+
+template <class L, class R>
+concept diffable_maps = dumpable_sequence<L> && dumpable_sequence<R>
+                     && std::same_as<typename L::key_type, typename R::key_type>
+                     && requires(L const& l, R const& r, typename L::key_type const& key) {
+                            l.at(key) == r.at(key); // excludes multimaps, whose equality is positional
+                            l.find(key) != l.end();
+                            r.find(key) != r.end();
+                        };
+
+template <class L, class R>
+concept diffable_sequences = dumpable_sequence<L> && dumpable_sequence<R> && !diffable_maps<L, R>
+                          && requires(std::ranges::range_reference_t<L const> a, std::ranges::range_reference_t<R const> b) {
+                                 bool(a == b);
+                             };
+
+// keeps the first and the last items of a possibly long list
+template <class T>
+struct bounded_list
+{
+    size_t head_size = max_diff_lines * 2 / 3;
+    size_t tail_size = max_diff_lines - max_diff_lines * 2 / 3;
+
+    std::vector<T> head;
+    std::vector<T> tail; // ring buffer once full
+    size_t count = 0;
+
+    void add(T item)
+    {
+        if (head.size() < head_size)
+            head.push_back(std::move(item));
+        else if (tail.size() < tail_size)
+            tail.push_back(std::move(item));
+        else
+            tail[(count - head_size) % tail_size] = std::move(item);
+        ++count;
+    }
+
+    // "... N more ..." between head and tail if anything was dropped
+    template <class F>
+    void format_to(std::vector<std::string>& lines, F&& format_item) const
+    {
+        for (auto const& item : head)
+            lines.push_back(format_item(item));
+        if (count > head.size() + tail.size())
+            lines.push_back(std::format("... {} more ...", count - head.size() - tail.size()));
+        auto const tail_start = tail.size() < tail_size ? 0 : (count - head_size) % tail_size;
+        for (size_t i = 0; i < tail.size(); ++i)
+            lines.push_back(format_item(tail[(tail_start + i) % tail.size()]));
+    }
+};
+
+template <class T>
+std::string bounded_debug_string(T const& value);
+
+// one element of a dump or diff line, e.g. "[1, 2, 3, ...] (1000 elements)" or "\"aaaa... (9000 more chars)"
+template <class T>
+std::string element_debug_string(T const& value)
+{
+    auto result = bounded_debug_string(value);
+    if (result.size() <= max_element_chars)
+        return result;
+
+    auto const dropped = result.size() - max_element_chars;
+    result.resize(max_element_chars);
+    return std::format("{}... ({} more chars)", result, dropped);
+}
+
+// "[a, b, c, ..., y, z] (1000 elements)" for large ranges, cc::to_debug_string otherwise
+// elements of ranges are bounded by element_debug_string, so nested ranges stay small too
+template <class T>
+std::string bounded_debug_string(T const& value)
+{
+    if constexpr (dumpable_sequence<T>)
+    {
+        auto const size = size_t(std::ranges::size(value));
+        if (size > max_dumped_elements)
+        {
+            auto const tail = max_dumped_elements / 4;
+            auto const head = max_dumped_elements - tail;
+
+            std::string result = "[";
+            auto it = std::ranges::begin(value);
+            for (size_t i = 0; i < head; ++i, ++it)
+                result += element_debug_string(*it) + ", ";
+            result += "...";
+            std::ranges::advance(it, std::ranges::range_difference_t<T const>(size - head - tail));
+            for (size_t i = 0; i < tail; ++i, ++it)
+                result += ", " + element_debug_string(*it);
+            return std::format("{}] ({} elements)", result, size);
+        }
+
+        // small ranges of ranges (or strings): only the elements can be large
+        if constexpr (dumpable_sequence<std::ranges::range_value_t<T const>>
+                      || string_like<std::ranges::range_value_t<T const>>)
+        {
+            std::string result = "[";
+            for (auto const& e : value)
+                result += (result.size() > 1 ? ", " : "") + element_debug_string(e);
+            return result + "]";
+        }
+    }
+    return debug_string(value);
+}
+
+// i -> i-th element, without copying random access ranges
+template <dumpable_sequence Rng>
+auto indexed_elements(Rng const& rng)
+{
+    if constexpr (std::ranges::random_access_range<Rng const>)
+        return [it = std::ranges::begin(rng)](size_t i) -> decltype(auto)
+        { return it[std::ranges::range_difference_t<Rng const>(i)]; };
+    else
+    {
+        std::vector<std::ranges::iterator_t<Rng const>> its;
+        its.reserve(size_t(std::ranges::size(rng)));
+        for (auto it = std::ranges::begin(rng); it != std::ranges::end(rng); ++it)
+            its.push_back(it);
+        return [its = std::move(its)](size_t i) -> decltype(auto) { return *its[i]; };
+    }
+}
+
+// delete lhs[lhs_index] or insert rhs[rhs_index]
+struct diff_edit
+{
+    bool is_insert = false;
+    size_t lhs_index = 0;
+    size_t rhs_index = 0;
+};
+
+// shortest edit script turning a[0, n) into b[0, m) (Myers, "An O(ND) Difference Algorithm and Its Variations")
+// returns false (and no edits) if that takes more than max_edits edits
+template <class F>
+bool find_edit_script(size_t n, size_t m, F&& is_equal, size_t max_edits, std::vector<diff_edit>& edits)
+{
+    using index = std::ptrdiff_t;
+    auto const max_d = index(std::min(max_edits, n + m));
+    auto const offset = max_d + 1;
+
+    // v[offset + k]: furthest x on diagonal k = x - y, one copy per d for the backtracking (O(max_d^2) memory)
+    std::vector<index> v(size_t(2 * max_d + 3), 0);
+    std::vector<std::vector<index>> trace;
+    for (index d = 0; d <= max_d; ++d)
+    {
+        trace.push_back(v);
+        for (auto k = -d; k <= d; k += 2)
+        {
+            auto const go_down = k == -d || (k != d && v[offset + k - 1] < v[offset + k + 1]);
+            auto x = go_down ? v[offset + k + 1] : v[offset + k - 1] + 1;
+            auto y = x - k;
+            while (x < index(n) && y < index(m) && is_equal(size_t(x), size_t(y)))
+                ++x, ++y;
+            v[offset + k] = x;
+
+            if (x < index(n) || y < index(m))
+                continue;
+
+            // backtrack from (n, m) through the furthest points of each d
+            edits.clear();
+            for (auto bd = d; bd > 0; --bd)
+            {
+                auto const& pv = trace[size_t(bd)];
+                auto const bk = x - y;
+                auto const down = bk == -bd || (bk != bd && pv[offset + bk - 1] < pv[offset + bk + 1]);
+                auto const prev_k = down ? bk + 1 : bk - 1;
+                auto const prev_x = pv[offset + prev_k];
+                auto const prev_y = prev_x - prev_k;
+                edits.push_back({.is_insert = down, .lhs_index = size_t(prev_x), .rhs_index = size_t(prev_y)});
+                x = prev_x;
+                y = prev_y;
+            }
+            std::ranges::reverse(edits);
+            return true;
+        }
+    }
+    return false;
+}
+
+template <class L, class R>
+    requires diffable_sequences<L, R>
+void append_container_diff(std::vector<std::string>& lines, L const& lhs, R const& rhs)
+{
+    auto const a = indexed_elements(lhs);
+    auto const b = indexed_elements(rhs);
+    auto const n = size_t(std::ranges::size(lhs));
+    auto const m = size_t(std::ranges::size(rhs));
+    auto const is_equal = [&](size_t i, size_t j) { return bool(a(i) == b(j)); };
+
+    if (n != m)
+        lines.push_back(std::format("sizes differ: {} vs {}", n, m));
+
+    // common prefix and suffix cost no edits, the search only sees the differing middle
+    size_t prefix = 0;
+    while (prefix < n && prefix < m && is_equal(prefix, prefix))
+        ++prefix;
+    size_t suffix = 0;
+    while (suffix < n - prefix && suffix < m - prefix && is_equal(n - 1 - suffix, m - 1 - suffix))
+        ++suffix;
+
+    std::vector<diff_edit> edits;
+    auto const has_script = find_edit_script(
+        n - prefix - suffix, m - prefix - suffix, [&](size_t i, size_t j) { return is_equal(prefix + i, prefix + j); },
+        max_diff_edits, edits);
+
+    if (has_script)
+    {
+        bounded_list<diff_edit> shown;
+        for (auto const& e : edits)
+            shown.add({.is_insert = e.is_insert, .lhs_index = prefix + e.lhs_index, .rhs_index = prefix + e.rhs_index});
+
+        lines.push_back(std::format("diff ({} edits, - only in lhs, + only in rhs):", edits.size()));
+        shown.format_to(lines,
+                        [&](diff_edit const& e)
+                        {
+                            return e.is_insert
+                                     ? std::format("+ rhs[{}]: {}", e.rhs_index, element_debug_string(b(e.rhs_index)))
+                                     : std::format("- lhs[{}]: {}", e.lhs_index, element_debug_string(a(e.lhs_index)));
+                        });
+        return;
+    }
+
+    // too different for an edit script to be useful
+    bounded_list<size_t> mismatches;
+    for (auto i = prefix; i < std::min(n, m); ++i)
+        if (!is_equal(i, i))
+            mismatches.add(i);
+
+    lines.push_back(std::format("more than {} edits, {} elements differ by position:", max_diff_edits, mismatches.count));
+    mismatches.format_to(lines,
+                         [&](size_t i)
+                         {
+                             return std::format("[{}]: {} vs {}", i, element_debug_string(a(i)),
+                                                element_debug_string(b(i)));
+                         });
+}
+
+template <class L, class R>
+    requires diffable_maps<L, R>
+void append_container_diff(std::vector<std::string>& lines, L const& lhs, R const& rhs)
+{
+    struct key_difference
+    {
+        typename L::const_iterator lhs_it; // end if only in rhs
+        typename R::const_iterator rhs_it; // end if only in lhs
+    };
+
+    bounded_list<key_difference> differences;
+    for (auto it = lhs.begin(); it != lhs.end(); ++it)
+        if (auto const rit = rhs.find(it->first); rit == rhs.end() || !bool(it->second == rit->second))
+            differences.add({it, rit});
+    for (auto rit = rhs.begin(); rit != rhs.end(); ++rit)
+        if (lhs.find(rit->first) == lhs.end())
+            differences.add({lhs.end(), rit});
+
+    if (lhs.size() != rhs.size())
+        lines.push_back(std::format("sizes differ: {} vs {}", lhs.size(), rhs.size()));
+    lines.push_back(std::format("{} keys differ (- only in lhs, + only in rhs, ~ different values):", differences.count));
+    differences.format_to(lines,
+                          [&](key_difference const& d)
+                          {
+                              if (d.rhs_it == rhs.end())
+                                  return std::format("- {}: {}", element_debug_string(d.lhs_it->first),
+                                                     element_debug_string(d.lhs_it->second));
+                              if (d.lhs_it == lhs.end())
+                                  return std::format("+ {}: {}", element_debug_string(d.rhs_it->first),
+                                                     element_debug_string(d.rhs_it->second));
+                              return std::format("~ {}: {} vs {}", element_debug_string(d.lhs_it->first),
+                                                 element_debug_string(d.lhs_it->second),
+                                                 element_debug_string(d.rhs_it->second));
+                          });
+}
+
+// nothing beyond the dumps for everything else
+template <class L, class R>
+void append_container_diff(std::vector<std::string>&, L const&, R const&)
+{
+}
+
+} // namespace nx::impl
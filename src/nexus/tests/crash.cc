@@ -0,0 +1,248 @@
+#include "crash.hh"
+
+#include <nexus/tests/hash.hh>
+
+#include <algorithm>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <format>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#define NX_IMPL_HAS_SIGACTION 1
+#else
+#define NX_IMPL_HAS_SIGACTION 0
+#endif
+
+#if NX_IMPL_HAS_SIGACTION && __has_include(<execinfo.h>) && __has_include(<dlfcn.h>)
+#include <dlfcn.h>
+#include <execinfo.h>
+#define NX_IMPL_HAS_BACKTRACE 1
+#else
+#define NX_IMPL_HAS_BACKTRACE 0
+#endif
+
+#if __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#define NX_IMPL_HAS_DEMANGLE 1
+#else
+#define NX_IMPL_HAS_DEMANGLE 0
+#endif
+
+namespace
+{
+// number of frames that make up the crash signature
+constexpr size_t signature_frames = 3;
+
+// number of frames printed for in-process crashes
+constexpr size_t reported_frames = 16;
+
+nx::impl::crash_stack* g_crash_record = nullptr;
+
+thread_local std::vector<std::function<std::string()> const*> g_crash_contexts;
+
+// only set while an in-process crash is reported
+std::string g_crash_signature;
+
+[[maybe_unused]] std::string demangle(char const* name)
+{
+#if NX_IMPL_HAS_DEMANGLE
+    auto status = 0;
+    auto const demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+    if (status == 0 && demangled != nullptr)
+    {
+        std::string result = demangled;
+        std::free(demangled); // NOLINT(cppcoreguidelines-no-malloc)
+        return result;
+    }
+#endif
+    return name;
+}
+
+void record_stack(nx::impl::crash_stack& stack)
+{
+#if NX_IMPL_HAS_BACKTRACE
+    stack.size = backtrace(stack.frames, nx::impl::max_crash_frames);
+#else
+    stack.size = 0;
+#endif
+}
+
+#if NX_IMPL_HAS_SIGACTION
+constexpr int fatal_signals[] = {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT};
+
+// the handler may run on a stack that just overflowed
+alignas(16) std::byte g_alt_stack[64 * 1024];
+
+// not async-signal-safe (formatting, dladdr), but the process is about to die anyway
+void report_crash(int sig)
+{
+    nx::impl::crash_stack stack;
+    record_stack(stack);
+    auto const frames = nx::impl::symbolize_crash_stack(stack);
+    g_crash_signature = nx::impl::crash_signature(frames);
+
+    auto text = std::format("\nfatal signal {} ({})\n", sig, strsignal(sig));
+    for (auto const describe : g_crash_contexts)
+        text += std::format("  in {}\n", (*describe)());
+    text += std::format("  stack (signature {}):\n", g_crash_signature);
+    for (size_t i = 0; i < std::min(frames.size(), reported_frames); ++i)
+        text += std::format("    #{} {}\n", i, nx::impl::to_string(frames[i]));
+
+    auto const written = ::write(STDERR_FILENO, text.data(), text.size());
+    (void)written;
+}
+
+void handle_fatal_signal(int sig)
+{
+    if (g_crash_record != nullptr)
+        record_stack(*g_crash_record);
+    else
+        report_crash(sig);
+
+    // the signal is blocked while handling it, so the process dies right after returning
+    std::signal(sig, SIG_DFL);
+    std::raise(sig);
+}
+#endif
+
+void install_handlers()
+{
+#if NX_IMPL_HAS_SIGACTION
+    [[maybe_unused]] static bool const is_installed = []
+    {
+        stack_t alt_stack = {};
+        alt_stack.ss_sp = g_alt_stack;
+        alt_stack.ss_size = sizeof(g_alt_stack);
+        sigaltstack(&alt_stack, nullptr);
+
+        // the first backtrace call may allocate (loading the unwinder), which must not happen in the handler
+        nx::impl::crash_stack warm_up;
+        record_stack(warm_up);
+
+        for (auto sig : fatal_signals)
+        {
+            struct sigaction previous = {};
+            sigaction(sig, nullptr, &previous);
+            if (previous.sa_handler != SIG_DFL)
+                continue;
+
+            struct sigaction action = {};
+            action.sa_handler = handle_fatal_signal;
+            action.sa_flags = SA_ONSTACK;
+            sigemptyset(&action.sa_mask);
+            sigaction(sig, &action, nullptr);
+        }
+        return true;
+    }();
+#endif
+}
+} // namespace
+
+std::string nx::impl::to_string(crash_frame const& frame)
+{
+    if (frame.function.empty())
+        return std::format("{}+0x{:x}", frame.module.empty() ? "?" : frame.module, frame.offset);
+    return std::format("{}+0x{:x} in {}", frame.function, frame.offset, frame.module);
+}
+
+size_t nx::impl::count_signal_handler_frames(std::span<void* const> frames, bool include_libc_callers)
+{
+#if NX_IMPL_HAS_BACKTRACE
+    Dl_info libc = {};
+    dladdr(reinterpret_cast<void*>(&std::abort), &libc);
+    auto const is_libc = [&](void* pc)
+    {
+        Dl_info info = {};
+        return libc.dli_fname != nullptr && dladdr(pc, &info) != 0 && info.dli_fname != nullptr
+            && std::strcmp(info.dli_fname, libc.dli_fname) == 0;
+    };
+
+    // the stack starts with the handler, followed by the signal trampoline (in libc)
+    size_t count = 0;
+    while (count < frames.size() && !is_libc(frames[count]))
+        ++count;
+    if (count == frames.size())
+        return 0; // no trampoline found (e.g. static linking), keep everything
+
+    ++count;
+    while (include_libc_callers && count < frames.size() && is_libc(frames[count]))
+        ++count;
+    return count;
+#else
+    (void)frames;
+    (void)include_libc_callers;
+    return 0;
+#endif
+}
+
+std::vector<nx::impl::crash_frame> nx::impl::symbolize_frames(std::span<void* const> frames)
+{
+    std::vector<crash_frame> result;
+    result.reserve(frames.size());
+    for (auto const address : frames)
+    {
+        auto const pc = reinterpret_cast<std::uintptr_t>(address);
+
+        crash_frame frame;
+        frame.offset = pc;
+
+#if NX_IMPL_HAS_BACKTRACE
+        // return addresses point behind the call, the call itself belongs to the right function
+        Dl_info info = {};
+        if (dladdr(reinterpret_cast<void*>(pc - 1), &info) != 0)
+        {
+            if (info.dli_fname != nullptr)
+                frame.module = std::filesystem::path(info.dli_fname).filename().string();
+
+            if (info.dli_sname != nullptr && info.dli_saddr != nullptr)
+            {
+                frame.function = demangle(info.dli_sname);
+                frame.offset = pc - reinterpret_cast<std::uintptr_t>(info.dli_saddr);
+            }
+            else
+                frame.offset = pc - reinterpret_cast<std::uintptr_t>(info.dli_fbase);
+        }
+#endif
+
+        result.push_back(std::move(frame));
+    }
+    return result;
+}
+
+std::vector<nx::impl::crash_frame> nx::impl::symbolize_crash_stack(crash_stack const& stack)
+{
+    auto const frames = std::span<void* const>(stack.frames, size_t(std::clamp(stack.size, 0, max_crash_frames)));
+    return symbolize_frames(frames.subspan(count_signal_handler_frames(frames, true)));
+}
+
+std::string nx::impl::crash_signature(std::span<crash_frame const> frames)
+{
+    std::string key;
+    for (auto const& frame : frames.first(std::min(frames.size(), signature_frames)))
+    {
+        key += frame.function.empty() ? std::format("{}+0x{:x}", frame.module, frame.offset) : frame.function;
+        key += '\n';
+    }
+    return std::format("{:016x}", fnv1a(key));
+}
+
+std::string_view nx::impl::current_crash_signature() { return g_crash_signature; }
+
+void nx::impl::install_crash_reporter() { install_handlers(); }
+
+void nx::impl::install_crash_recorder(crash_stack* record)
+{
+    g_crash_record = record;
+    install_handlers();
+}
+
+nx::impl::scoped_crash_context::scoped_crash_context(std::function<std::string()> describe)
+  : _describe(std::move(describe))
+{
+    g_crash_contexts.push_back(&_describe);
+}
+
+nx::impl::scoped_crash_context::~scoped_crash_context() { g_crash_contexts.pop_back(); }
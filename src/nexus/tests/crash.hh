@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace nx::impl
+{
+constexpr int max_crash_frames = 64;
+
+// raw return addresses of a crashed thread, recorded inside the signal handler
+// plain data, so it can live in memory shared with a parent process
+// (a forked child has the address space layout of its parent, so the parent can symbolize it)
+struct crash_stack
+{
+    int size = 0;
+    void* frames[max_crash_frames] = {};
+};
+
+struct crash_frame
+{
+    std::string function;      // demangled, empty if the symbol is not exported
+    std::string module;        // file name of the executable or shared library
+    std::uintptr_t offset = 0; // relative to the function if known, otherwise to the module
+};
+
+// "function+0x1f in module" or "module+0x12ab"
+[[nodiscard]] std::string to_string(crash_frame const& frame);
+
+// resolves raw return addresses (dladdr)
+[[nodiscard]] std::vector<crash_frame> symbolize_frames(std::span<void* const> frames);
+
+// number of frames on top of a stack recorded inside a signal handler that belong to the signal handling:
+// the handler itself and the libc trampoline, with include_libc_callers also abort, raise, ... that sent the signal
+[[nodiscard]] size_t count_signal_handler_frames(std::span<void* const> frames, bool include_libc_callers);
+
+// resolves the frames of a recorded stack, starting at the crash site
+[[nodiscard]] std::vector<crash_frame> symbolize_crash_stack(crash_stack const& stack);
+
+// hash of the top frames as 16 hex digits, crashes with the same signature are treated as the same bug
+// only function names are used where available, so that different crash sites within a function are grouped
+[[nodiscard]] std::string crash_signature(std::span<crash_frame const> frames);
+
+// installs handlers for fatal signals (SIGSEGV, SIGABRT, ...) that report in-process crashes
+// - prints the crash contexts of the crashing thread, its symbolized stack, and the crash signature to stderr
+// - the process still dies from the signal afterwards
+// - handlers of others (e.g. sanitizers) are left alone
+// - called by execute_tests, installs only once
+void install_crash_reporter();
+
+// like install_crash_reporter, but only records the stack into `record` instead of printing it
+// intended for forked children whose parent reports the crash
+void install_crash_recorder(crash_stack* record);
+
+// signature of the in-process crash that is currently being reported, empty otherwise
+// lets crash contexts name what they save about the crash (e.g. fuzz reproducers) after the bug
+[[nodiscard]] std::string_view current_crash_signature();
+
+// describes what the current thread is doing, shown in reports of in-process crashes (outermost first)
+// the description is only evaluated when a crash happens
+struct scoped_crash_context
+{
+    explicit scoped_crash_context(std::function<std::string()> describe);
+    scoped_crash_context(scoped_crash_context&&) = delete;
+    scoped_crash_context(scoped_crash_context const&) = delete;
+    scoped_crash_context& operator=(scoped_crash_context&&) = delete;
+    scoped_crash_context& operator=(scoped_crash_context const&) = delete;
+    ~scoped_crash_context();
+
+private:
+    std::function<std::string()> _describe;
+};
+
+} // namespace nx::impl
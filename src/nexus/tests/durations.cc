@@ -0,0 +1,264 @@
+#include "durations.hh"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <unordered_map>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#define NX_IMPL_HAS_POSIX_APPEND 1
+#else
+#define NX_IMPL_HAS_POSIX_APPEND 0
+#endif
+
+#if defined(__linux__) && __has_include(<link.h>)
+#include <link.h>
+#define NX_IMPL_HAS_BUILD_ID_NOTE 1
+#else
+#define NX_IMPL_HAS_BUILD_ID_NOTE 0
+#endif
+
+#if defined(__APPLE__)
+#include <mach-o/dyld.h>
+#define NX_IMPL_HAS_NS_EXECUTABLE_PATH 1
+#else
+#define NX_IMPL_HAS_NS_EXECUTABLE_PATH 0
+#endif
+
+namespace
+{
+// tabs and newlines separate fields and records
+std::string history_name(std::string_view name)
+{
+    std::string result(name);
+    for (auto& c : result)
+        if (c == '\t' || c == '\n' || c == '\r')
+            c = ' ';
+    return result;
+}
+
+void collect_section_records(nx::test_execution::section const& sec,
+                             std::string const& prefix,
+                             nx::duration_record const& base,
+                             std::vector<nx::duration_record>& records)
+{
+    for (auto const& subsec : sec.subsections)
+    {
+        auto record = base;
+        record.name = prefix + " > " + history_name(subsec.name);
+        record.seconds = subsec.duration_seconds;
+        records.push_back(record);
+        collect_section_records(subsec, record.name, base, records);
+    }
+}
+
+#if NX_IMPL_HAS_BUILD_ID_NOTE
+// NT_GNU_BUILD_ID note of the main executable (the first object reported by dl_iterate_phdr)
+std::string read_build_id_note()
+{
+    std::string result;
+    dl_iterate_phdr(
+        [](dl_phdr_info* info, size_t, void* data)
+        {
+            auto& id = *static_cast<std::string*>(data);
+            for (auto i = 0; i < info->dlpi_phnum; ++i)
+            {
+                auto const& phdr = info->dlpi_phdr[i];
+                if (phdr.p_type != PT_NOTE)
+                    continue;
+
+                auto const* p = reinterpret_cast<unsigned char const*>(info->dlpi_addr + phdr.p_vaddr);
+                auto const* const end = p + phdr.p_memsz;
+                while (p + sizeof(ElfW(Nhdr)) <= end)
+                {
+                    auto const* note = reinterpret_cast<ElfW(Nhdr) const*>(p);
+                    auto const* name = p + sizeof(ElfW(Nhdr));
+                    auto const* desc = name + ((note->n_namesz + 3) & ~3u);
+                    if (note->n_type == NT_GNU_BUILD_ID && note->n_namesz == 4 && std::equal(name, name + 4, "GNU"))
+                    {
+                        for (auto j = 0u; j < note->n_descsz; ++j)
+                            id += std::format("{:02x}", desc[j]);
+                        return 1;
+                    }
+                    p = desc + ((note->n_descsz + 3) & ~3u);
+                }
+            }
+            return 1; // only the main executable
+        },
+        &result);
+    return result;
+}
+#endif
+
+// path of the running executable, empty if unknown (e.g. on platforms without /proc and _NSGetExecutablePath)
+std::filesystem::path executable_path()
+{
+#if NX_IMPL_HAS_NS_EXECUTABLE_PATH
+    std::uint32_t size = 0;
+    _NSGetExecutablePath(nullptr, &size); // only queries the size
+    std::string path(size, '\0');
+    if (_NSGetExecutablePath(path.data(), &size) != 0)
+        return {};
+    path.resize(std::strlen(path.c_str()));
+    std::error_code ec;
+    auto canonical = std::filesystem::canonical(path, ec);
+    return ec ? std::filesystem::path() : canonical;
+#else
+    std::error_code ec;
+    auto exe = std::filesystem::read_symlink("/proc/self/exe", ec);
+    return ec ? std::filesystem::path() : exe;
+#endif
+}
+} // namespace
+
+std::string nx::impl::current_build_id()
+{
+    static std::string const id = []
+    {
+#if NX_IMPL_HAS_BUILD_ID_NOTE
+        if (auto note = read_build_id_note(); !note.empty())
+            return note;
+#endif
+        // every rebuild changes size or modification time of the executable
+        std::error_code ec;
+        auto const exe = executable_path();
+        if (exe.empty())
+            return std::string("unknown");
+        auto const size = std::filesystem::file_size(exe, ec);
+        auto const time = std::filesystem::last_write_time(exe, ec);
+        if (ec)
+            return std::string("unknown");
+        return std::format("{:x}-{:x}", size, time.time_since_epoch().count());
+    }();
+    return id;
+}
+
+std::vector<nx::duration_record> nx::impl::collect_duration_records(test_schedule_execution const& execution,
+                                                                    std::string_view build_id,
+                                                                    std::int64_t timestamp)
+{
+    std::vector<duration_record> records;
+    for (auto const& exec : execution.executions)
+    {
+        // failing tests often end early, their durations would skew the baseline
+        if (exec.instance.declaration == nullptr || exec.is_considered_failing())
+            continue;
+
+        auto record = duration_record{
+            .build_id = std::string(build_id),
+            .timestamp = timestamp,
+            .seconds = exec.root.duration_seconds,
+            .name = history_name(exec.instance.declaration->name),
+        };
+        records.push_back(record);
+        collect_section_records(exec.root, record.name, record, records);
+    }
+    return records;
+}
+
+std::vector<nx::duration_record> nx::impl::read_duration_history(std::filesystem::path const& path)
+{
+    std::vector<duration_record> records;
+
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line))
+    {
+        // build id \t timestamp \t seconds \t name
+        auto const tab0 = line.find('\t');
+        auto const tab1 = tab0 == std::string::npos ? tab0 : line.find('\t', tab0 + 1);
+        auto const tab2 = tab1 == std::string::npos ? tab1 : line.find('\t', tab1 + 1);
+        if (tab2 == std::string::npos)
+            continue;
+
+        duration_record record;
+        record.build_id = line.substr(0, tab0);
+        auto const* const data = line.data();
+        if (std::from_chars(data + tab0 + 1, data + tab1, record.timestamp).ec != std::errc{}
+            || std::from_chars(data + tab1 + 1, data + tab2, record.seconds).ec != std::errc{})
+            continue;
+        record.name = line.substr(tab2 + 1);
+        records.push_back(std::move(record));
+    }
+    return records;
+}
+
+bool nx::impl::append_duration_history(std::filesystem::path const& path, std::span<duration_record const> records)
+{
+    std::string text;
+    for (auto const& r : records)
+        text += std::format("{}\t{}\t{:.6g}\t{}\n", r.build_id, r.timestamp, r.seconds, r.name);
+
+#if NX_IMPL_HAS_POSIX_APPEND
+    // a single write(2) to an O_APPEND descriptor, so that runs appending concurrently don't interleave their lines
+    // (holds for local files, a short write falls back to appending the rest)
+    auto const fd = ::open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return false;
+
+    size_t written = 0;
+    while (written < text.size())
+    {
+        auto const n = ::write(fd, text.data() + written, text.size() - written);
+        if (n < 0)
+            break;
+        written += size_t(n);
+    }
+    ::close(fd);
+    return written == text.size();
+#else
+    // no atomicity guarantees for concurrent runs here
+    std::ofstream out(path, std::ios::app);
+    out << text;
+    return bool(out);
+#endif
+}
+
+std::vector<nx::duration_regression> nx::impl::find_duration_regressions(std::span<duration_record const> history,
+                                                                         std::span<duration_record const> current,
+                                                                         duration_regression_config const& config)
+{
+    std::vector<duration_regression> regressions;
+    if (current.empty())
+        return regressions;
+
+    // runs of this build are not a baseline, they already contain the change
+    std::unordered_map<std::string_view, std::vector<double>> history_by_name;
+    for (auto const& r : current)
+        history_by_name.emplace(r.name, std::vector<double>{});
+    for (auto const& r : history)
+        if (r.build_id != current.front().build_id)
+            if (auto it = history_by_name.find(r.name); it != history_by_name.end())
+                it->second.push_back(r.seconds);
+
+    for (auto const& r : current)
+    {
+        auto runs = history_by_name[r.name];
+        if (int(runs.size()) < config.min_history_runs)
+            continue;
+
+        // the file is in chronological order
+        if (int(runs.size()) > config.history_window)
+            runs.erase(runs.begin(), runs.end() - config.history_window);
+
+        auto const mid = runs.begin() + std::ptrdiff_t(runs.size() / 2);
+        std::ranges::nth_element(runs, mid);
+        auto const baseline = *mid;
+
+        if (r.seconds > baseline * config.min_ratio && r.seconds - baseline >= config.min_seconds_added)
+            regressions.push_back({
+                .name = r.name,
+                .baseline_seconds = baseline,
+                .seconds = r.seconds,
+                .history_runs = int(runs.size()),
+            });
+    }
+
+    std::ranges::sort(regressions, std::ranges::greater{},
+                      [](duration_regression const& r) { return r.seconds - r.baseline_seconds; });
+    return regressions;
+}
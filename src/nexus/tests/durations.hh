@@ -0,0 +1,64 @@
+#pragma once
+
+#include <nexus/tests/execute.hh>
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace nx
+{
+// one duration of a test or section in the timing history
+// sections are named "test > section > subsection"
+struct duration_record
+{
+    std::string build_id;
+    std::int64_t timestamp = 0; // unix seconds
+    double seconds = 0.0;       // inclusive, over all passes
+    std::string name;
+};
+
+// a test or section that got notably slower than its own history
+struct duration_regression
+{
+    std::string name;
+    double baseline_seconds = 0.0; // median of the compared history
+    double seconds = 0.0;          // this run
+    int history_runs = 0;
+};
+
+struct duration_regression_config
+{
+    int history_window = 20;         // most recent runs of earlier builds that form the baseline
+    int min_history_runs = 3;        // fewer runs are too noisy to compare against
+    double min_ratio = 1.2;          // slower than baseline * min_ratio ...
+    double min_seconds_added = 5e-3; // ... and by at least this much (timer noise of short tests)
+};
+} // namespace nx
+
+namespace nx::impl
+{
+// identifies the running executable: the GNU build id where available, otherwise derived from
+// size and modification time of the executable (found via /proc/self/exe or _NSGetExecutablePath),
+// "unknown" if neither can be determined
+[[nodiscard]] std::string current_build_id();
+
+// records of all passing tests and their sections
+[[nodiscard]] std::vector<duration_record> collect_duration_records(test_schedule_execution const& execution,
+                                                                    std::string_view build_id,
+                                                                    std::int64_t timestamp);
+
+// the history is an append-only text file, one "build id \t timestamp \t seconds \t name" line per record
+// unreadable lines are skipped, a missing file is an empty history
+[[nodiscard]] std::vector<duration_record> read_duration_history(std::filesystem::path const& path);
+bool append_duration_history(std::filesystem::path const& path, std::span<duration_record const> records);
+
+// compares each current record against the history of the same name from other builds
+// sorted by added time, largest first
+[[nodiscard]] std::vector<duration_regression> find_duration_regressions(std::span<duration_record const> history,
+                                                                         std::span<duration_record const> current,
+                                                                         duration_regression_config const& config = {});
+} // namespace nx::impl
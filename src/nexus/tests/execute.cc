@@ -1,23 +1,72 @@
 #include "execute.hh"
 
 #include <nexus/tests/check.hh>
+#include <nexus/tests/concurrent.hh>
+#include <nexus/tests/crash.hh>
+#include <nexus/tests/info.hh>
+#include <nexus/tests/log.hh>
+#include <nexus/tests/profile.hh>
 #include <nexus/tests/section.hh>
+#include <nexus/tests/timer.hh>
+#include <nexus/tests/trace.hh>
 
 #include <clean-core/assert-handler.hh>
 #include <clean-core/assert.hh>
 
-#include <chrono>
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
 #include <iomanip>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <tuple>
 #include <unordered_map>
+#include <unordered_set>
 
 
+// interned strings, node-based so that views stay valid while the pool grows
+struct nx::impl::string_pool
+{
+    std::string_view intern(std::string str) { return *_strings.insert(std::move(str)).first; }
+
+    test_error_view intern(test_error error)
+    {
+        test_error_view result = {
+            .expr = intern(std::move(error.expr)),
+            .location = error.location,
+            .extra_lines = {},
+            .expanded = intern(std::move(error.expanded)),
+            .info = {},
+        };
+        result.extra_lines.reserve(error.extra_lines.size());
+        for (auto& line : error.extra_lines)
+            result.extra_lines.push_back(intern(std::move(line)));
+        result.info.reserve(error.info.size());
+        for (auto& line : error.info)
+            result.info.push_back(intern(std::move(line)));
+        return result;
+    }
+
+private:
+    std::unordered_set<std::string> _strings;
+};
+
 namespace nx
 {
 namespace
 {
+// 49999950 -> "49,999,950"
+std::string format_count(std::int64_t count)
+{
+    auto digits = std::to_string(count);
+    for (auto i = std::ssize(digits) - 3; i > (count < 0 ? 1 : 0); i -= 3)
+        digits.insert(size_t(i), ",");
+    return digits;
+}
+
 struct test_section
 {
     std::unordered_map<std::string, std::unique_ptr<test_section>> subsections;
@@ -32,61 +81,107 @@ struct test_section
     // associated stats
     int executed_checks = 0;
     int failed_checks = 0;
-    std::vector<test_error> errors;
-    double duration_seconds = 0.0;
+    std::vector<test_error_view> errors;
+
+    // timing across passes, see test_execution::section
+    int entries = 0;
+    double total_seconds = 0.0;
+    double self_seconds = 0.0;
+    double repeated_seconds = 0.0;
+
+    // current entry, times are elapsed seconds of the pass stopwatch
+    double entry_start = 0.0;
+    double entry_subsection_seconds = 0.0;
+
+    void enter(double now)
+    {
+        ++entries;
+        entry_start = now;
+        entry_subsection_seconds = 0.0;
+    }
+
+    void leave(double now, test_section* parent)
+    {
+        auto const inclusive = now - entry_start;
+        auto const self = std::max(inclusive - entry_subsection_seconds, 0.0);
+        total_seconds += inclusive;
+        self_seconds += self;
+        if (entries > 1)
+            repeated_seconds += self;
+        if (parent != nullptr)
+            parent->entry_subsection_seconds += inclusive;
+    }
+
+    [[nodiscard]] int total_executed_checks() const
+    {
+        auto result = executed_checks;
+        for (auto subsec : subsections_ordered)
+            result += subsec->total_executed_checks();
+        return result;
+    }
+
+    [[nodiscard]] int total_failed_checks() const
+    {
+        auto result = failed_checks;
+        for (auto subsec : subsections_ordered)
+            result += subsec->total_failed_checks();
+        return result;
+    }
 
     // accumulates stats for non-leaf sections
     // adds errors for "no checks" and "unreachable subsections"
     // computes "in_considered_failing"
-    // populates the result with that
-    void finalize_section_to(test_execution::section& sec) const
+    // populates the result with that, errors are moved to the end of exec.errors (own first, then subsections)
+    void finalize_section_to(test_execution::section& sec, test_execution& exec, impl::string_pool& strings)
     {
         sec.name = name;
         sec.location = location;
         sec.is_considered_failing = false;
-        sec.executed_checks = executed_checks;
-        sec.failed_checks = failed_checks;
-        sec.errors = errors;
-        sec.duration_seconds = duration_seconds;
-
-        // populate and aggregate subsections
+        sec.executed_checks = total_executed_checks();
+        sec.failed_checks = total_failed_checks();
+        sec.entries = entries;
+        sec.duration_seconds = total_seconds;
+        sec.self_seconds = self_seconds;
+        sec.repeated_seconds = repeated_seconds;
+
+        sec.first_error = int(exec.errors.size());
+        for (auto& e : errors)
+            exec.errors.push_back(std::move(e));
+
+        // unreachable section
         for (auto subsec : subsections_ordered)
-        {
-            auto& ssec = sec.subsections.emplace_back();
-            subsec->finalize_section_to(ssec);
-
-            // accumulate
-            sec.executed_checks += ssec.executed_checks;
-            sec.failed_checks += ssec.failed_checks;
-            sec.duration_seconds += ssec.duration_seconds;
-            for (auto const& e : ssec.errors)
-                sec.errors.push_back(e);
-            sec.is_considered_failing |= ssec.is_considered_failing;
-
-            // unreachable section
             if (is_done && !subsec->is_done)
             {
-                sec.errors.push_back(test_error{
+                exec.errors.push_back(strings.intern(test_error{
                     .expr = "unreachable section",
                     .location = subsec->location,
                     .extra_lines = {},
                     .expanded = std::format("section \"{}\" was discovered but unreachable from parent", subsec->name),
-                });
+                }));
                 sec.is_considered_failing = true;
             }
-        }
 
         // we record missing CHECK/REQUIRE for _all_ sections, even intermediate ones
         if (sec.executed_checks == 0)
         {
-            sec.errors.push_back(test_error{
+            exec.errors.push_back(strings.intern(test_error{
                 .expr = "no CHECK/REQUIRE",
                 .location = location,
                 .extra_lines = {"This is often a bug and can be silenced via CHECK(true)"},
                 .expanded = "test did not contain CHECK/REQUIRE",
-            });
+            }));
             sec.is_considered_failing = true;
         }
+        sec.own_error_count = int(exec.errors.size()) - sec.first_error;
+
+        // populate subsections
+        for (auto subsec : subsections_ordered)
+        {
+            auto& ssec = sec.subsections.emplace_back();
+            subsec->finalize_section_to(ssec, exec, strings);
+            sec.is_considered_failing |= ssec.is_considered_failing;
+        }
+        sec.error_count = int(exec.errors.size()) - sec.first_error;
 
         // final checks
         sec.is_considered_failing |= sec.failed_checks > 0;
@@ -94,16 +189,199 @@ struct test_section
     }
 };
 
+// checks reported on threads without a test context, e.g. workers started by the test
+// every thread appends to its own buffer, the test thread merges them at the end of each pass
+struct foreign_check_buffer
+{
+    std::mutex mutex; // only contended while the test thread merges
+
+    int executed_checks = 0;
+    int failed_checks = 0;
+    std::vector<test_error> failures;
+
+    // failures beyond max_failures_per_test are not even formatted, only counted per location
+    struct suppressed_failures
+    {
+        char const* kind = nullptr;
+        std::string expr;
+        std::source_location location;
+        std::int64_t count = 0;
+    };
+    std::map<std::tuple<char const*, std::uint_least32_t, std::uint_least32_t>, suppressed_failures> suppressed;
+};
+
+struct foreign_check_sink
+{
+    int max_failures_per_thread = 0;
+
+    std::mutex mutex; // guards buffers
+    std::vector<std::unique_ptr<foreign_check_buffer>> buffers;
+};
+
+// sink of the innermost running test, replaced by the test thread at the begin and end of each test
+// threads cache it and only look it up again once the generation changed
+std::mutex g_foreign_sink_mutex;
+std::shared_ptr<foreign_check_sink> g_foreign_sink;
+std::atomic<std::uint64_t> g_foreign_sink_generation = 0;
+
+thread_local std::uint64_t g_thread_foreign_generation = 0;
+thread_local std::shared_ptr<foreign_check_sink> g_thread_foreign_sink;
+thread_local foreign_check_buffer* g_thread_foreign_buffer = nullptr;
+
+// returns the previous sink
+std::shared_ptr<foreign_check_sink> exchange_foreign_sink(std::shared_ptr<foreign_check_sink> sink)
+{
+    auto lock = std::lock_guard(g_foreign_sink_mutex);
+    std::swap(sink, g_foreign_sink);
+    g_foreign_sink_generation.fetch_add(1, std::memory_order_release);
+    return sink;
+}
+
+// buffer of this thread in the sink of the running test, nullptr if no test is running
+foreign_check_buffer* thread_foreign_buffer()
+{
+    if (g_foreign_sink_generation.load(std::memory_order_acquire) != g_thread_foreign_generation)
+    {
+        {
+            auto lock = std::lock_guard(g_foreign_sink_mutex);
+            g_thread_foreign_sink = g_foreign_sink;
+            g_thread_foreign_generation = g_foreign_sink_generation.load(std::memory_order_relaxed);
+        }
+
+        g_thread_foreign_buffer = nullptr;
+        if (g_thread_foreign_sink != nullptr)
+        {
+            auto lock = std::lock_guard(g_thread_foreign_sink->mutex);
+            g_thread_foreign_buffer = g_thread_foreign_sink->buffers.emplace_back(std::make_unique<foreign_check_buffer>()).get();
+        }
+    }
+    return g_thread_foreign_buffer;
+}
+
 struct test_context
 {
     nx::test_execution* execution = nullptr;
+    nx::test_schedule_config const* config = nullptr;
+    stopwatch const* pass_timer = nullptr; // measures the current pass, respects pause_timer()
+    std::shared_ptr<impl::string_pool> strings;
     std::unique_ptr<test_section> root_section;
     std::vector<test_section*> curr_section;
 
     // current stats
     int executed_checks = 0;
     int failed_checks = 0;
-    std::vector<test_error> errors;
+    std::vector<test_error_view> errors;
+
+    // checks of other threads while this test runs, and the sink of the enclosing test to restore afterwards
+    std::shared_ptr<foreign_check_sink> foreign_checks;
+    std::shared_ptr<foreign_check_sink> outer_foreign_checks;
+
+    // failures beyond the caps of the config are only counted (per location, over all passes)
+    struct location_failures
+    {
+        std::string kind; // "CHECK", "REQUIRE", ...
+        std::string expr;
+        std::source_location location;
+        int recorded = 0;
+        std::int64_t suppressed = 0;
+    };
+    int recorded_failures = 0;
+    std::vector<location_failures> failures_by_location; // in order of the first failure
+    std::map<std::tuple<char const*, std::uint_least32_t, std::uint_least32_t>, size_t> failure_location_index;
+
+    location_failures& failures_at(std::string_view kind, std::string_view expr, std::source_location location)
+    {
+        auto const key = std::tuple(location.file_name(), location.line(), location.column());
+        auto [it, is_new] = failure_location_index.emplace(key, failures_by_location.size());
+        if (is_new)
+            failures_by_location.push_back({
+                .kind = std::string(kind),
+                .expr = std::string(expr),
+                .location = location,
+            });
+        return failures_by_location[it->second];
+    }
+
+    // true if a failure at this location should be recorded, otherwise it is counted as suppressed
+    bool should_record_failure(std::string_view kind, std::string_view expr, std::source_location location)
+    {
+        auto& failures = failures_at(kind, expr, location);
+        auto const max_per_test = config->max_failures_per_test;
+        auto const max_per_location = config->max_failures_per_location;
+        if ((max_per_test > 0 && recorded_failures >= max_per_test)
+            || (max_per_location > 0 && failures.recorded >= max_per_location))
+        {
+            ++failures.suppressed;
+            return false;
+        }
+
+        ++recorded_failures;
+        ++failures.recorded;
+        return true;
+    }
+
+    // failed checks are subject to the caps, errors of the framework (exceptions, misuse) are not
+    void add_failure(test_error error)
+    {
+        if (error.kind == nullptr || should_record_failure(error.kind, error.expr, error.location))
+            errors.push_back(strings->intern(std::move(error)));
+    }
+    void add_error(test_error error) { errors.push_back(strings->intern(std::move(error))); }
+
+    // moves the checks reported by other threads so far into the current stats
+    void merge_foreign_checks()
+    {
+        auto sink_lock = std::lock_guard(foreign_checks->mutex);
+        for (auto const& buffer : foreign_checks->buffers)
+        {
+            auto lock = std::lock_guard(buffer->mutex);
+            executed_checks += cc::exchange(buffer->executed_checks, 0);
+            failed_checks += cc::exchange(buffer->failed_checks, 0);
+            for (auto& error : buffer->failures)
+                add_failure(std::move(error));
+            buffer->failures.clear();
+
+            for (auto const& [key, suppressed] : buffer->suppressed)
+                failures_at(suppressed.kind, suppressed.expr, suppressed.location).suppressed += suppressed.count;
+            buffer->suppressed.clear();
+        }
+    }
+
+    // one error per location with suppressed failures, added to the root section at the end of the test
+    // (in front, so that reporters with their own limits still show them)
+    void add_suppressed_failure_errors()
+    {
+        std::vector<test_error_view> summaries;
+        for (auto const& failures : failures_by_location)
+        {
+            if (failures.suppressed == 0)
+                continue;
+
+            auto const file = std::filesystem::path(failures.location.file_name()).filename().string();
+            auto const times = failures.suppressed == 1 ? "time" : "times";
+
+            // no failure recorded at all if the per-test cap was reached before this location first failed
+            auto const is_unrecorded = failures.recorded == 0;
+            auto const extra_line
+                = is_unrecorded ? std::format("no failures were recorded here, the test already reached {} recorded "
+                                              "failures (see --max-failures)",
+                                              config->max_failures_per_test)
+                : failures.recorded == 1
+                    ? std::string("only the first failure was recorded (see --max-failures, --max-failures-per-location)")
+                    : std::format("only the first {} failures were recorded (see --max-failures, "
+                                  "--max-failures-per-location)",
+                                  failures.recorded);
+            summaries.push_back(strings->intern(test_error{
+                .expr = failures.expr,
+                .location = failures.location,
+                .extra_lines = {extra_line},
+                .expanded = std::format("{} at {}:{} failed {} {}{}", failures.kind, file, failures.location.line(),
+                                        format_count(failures.suppressed), is_unrecorded ? "" : "more ", times),
+            }));
+        }
+        root_section->errors.insert(root_section->errors.begin(), std::make_move_iterator(summaries.begin()),
+                                    std::make_move_iterator(summaries.end()));
+    }
 
     // the first section we close becomes the current "leaf" section
     // after a run, all checks & errors are associated to the current leaf
@@ -125,12 +403,21 @@ struct test_duplicate_section
 
 thread_local std::vector<test_context> g_context_stack;
 
-void test_execute_begin(nx::test_execution& execution)
+// innermost run_captured call, takes precedence over the test context
+thread_local std::vector<impl::captured_checks*> g_capture_stack;
+
+void test_execute_begin(nx::test_execution& execution, nx::test_schedule_config const& config)
 {
     g_context_stack.push_back(test_context{
         .execution = &execution,
+        .config = &config,
+        .strings = std::make_shared<impl::string_pool>(),
         .root_section = std::make_unique<test_section>(),
     });
+    auto& ctx = g_context_stack.back();
+    ctx.foreign_checks = std::make_shared<foreign_check_sink>();
+    ctx.foreign_checks->max_failures_per_thread = config.max_failures_per_test;
+    ctx.outer_foreign_checks = exchange_foreign_sink(ctx.foreign_checks);
     g_context_stack.back().root_section->location = execution.instance.declaration->location;
     g_context_stack.back().curr_section.push_back(g_context_stack.back().root_section.get());
 }
@@ -142,7 +429,17 @@ void test_execute_end()
     auto& ctx = g_context_stack.back();
     CC_ASSERT(ctx.execution != nullptr, "should always have a valid execution");
 
-    ctx.root_section->finalize_section_to(ctx.execution->root);
+    // checks of threads that were still running after the last pass
+    exchange_foreign_sink(ctx.outer_foreign_checks);
+    ctx.merge_foreign_checks();
+    ctx.root_section->executed_checks += cc::exchange(ctx.executed_checks, 0);
+    ctx.root_section->failed_checks += cc::exchange(ctx.failed_checks, 0);
+    for (auto& e : cc::exchange(ctx.errors, {}))
+        ctx.root_section->errors.push_back(std::move(e));
+
+    ctx.add_suppressed_failure_errors();
+    ctx.root_section->finalize_section_to(ctx.execution->root, *ctx.execution, *ctx.strings);
+    ctx.execution->strings = std::move(ctx.strings);
 
     g_context_stack.pop_back();
 }
@@ -163,12 +460,151 @@ char const* op_to_string(impl::cmp_op op)
     }
     return "?";
 }
+
+double sum_repeated_seconds(test_execution::section const& sec)
+{
+    auto result = sec.repeated_seconds;
+    for (auto const& subsec : sec.subsections)
+        result += sum_repeated_seconds(subsec);
+    return result;
+}
+
+std::string format_expanded(impl::cmp_op op, std::string const& expr, std::vector<std::string> const& extra_lines)
+{
+    if (op == impl::cmp_op::none)
+        return std::format("'{}' failed", expr);
+    return std::format("{} {} {}", extra_lines[0], op_to_string(op), extra_lines[1]);
+}
+
+// failures of threads without test context are only formatted below the cap, beyond that only counted
+// the buffer must be locked
+bool is_foreign_buffer_full(foreign_check_buffer const& buffer)
+{
+    auto const max_failures = g_thread_foreign_sink->max_failures_per_thread;
+    return max_failures > 0 && buffer.failures.size() >= size_t(max_failures);
+}
+
+void add_suppressed_foreign_failure(foreign_check_buffer& buffer,
+                                    char const* kind,
+                                    std::string expr,
+                                    std::source_location location,
+                                    std::int64_t count = 1)
+{
+    auto const key = std::tuple(location.file_name(), location.line(), location.column());
+    auto& suppressed = buffer.suppressed[key];
+    if (suppressed.count == 0)
+    {
+        suppressed.kind = kind;
+        suppressed.expr = std::move(expr);
+        suppressed.location = location;
+    }
+    suppressed.count += count;
+}
+
+// a check on a thread without test context (e.g. a worker started by the test) goes to the buffer of that thread
+// a failing REQUIRE cannot abort the test from here, so it is recorded and the thread continues
+void report_foreign_check_result(impl::check_kind kind,
+                                 impl::cmp_op op,
+                                 std::string expr,
+                                 bool passed,
+                                 std::vector<std::string> extra_lines,
+                                 std::source_location location)
+{
+    auto const buffer = thread_foreign_buffer();
+    if (buffer == nullptr)
+        return; // no test running
+
+    auto lock = std::lock_guard(buffer->mutex);
+    ++buffer->executed_checks;
+    if (passed)
+        return;
+
+    ++buffer->failed_checks;
+    auto const kind_name = kind == impl::check_kind::require ? "REQUIRE" : "CHECK";
+    if (is_foreign_buffer_full(*buffer))
+    {
+        add_suppressed_foreign_failure(*buffer, kind_name, std::move(expr), location);
+        return;
+    }
+
+    if (kind == impl::check_kind::require)
+        extra_lines.push_back("REQUIRE failed on a thread not running the test, that thread was not aborted");
+    auto expanded = format_expanded(op, expr, extra_lines);
+    buffer->failures.push_back(test_error{
+        .expr = std::move(expr),
+        .location = location,
+        .extra_lines = std::move(extra_lines),
+        .expanded = std::move(expanded),
+        .info = impl::format_info_stack(),
+        .kind = kind_name,
+    });
+}
+
+// run_captured results on a thread without test context
+void report_foreign_captured_checks(impl::captured_checks captured, std::vector<std::string> const& extra_lines)
+{
+    auto const buffer = thread_foreign_buffer();
+    if (buffer == nullptr)
+        return; // no test running
+
+    auto lock = std::lock_guard(buffer->mutex);
+    buffer->executed_checks += captured.executed_checks;
+    buffer->failed_checks += captured.failed_checks;
+    for (auto& e : captured.errors)
+    {
+        if (e.kind != nullptr && is_foreign_buffer_full(*buffer))
+        {
+            add_suppressed_foreign_failure(*buffer, e.kind, std::move(e.expr), e.location);
+            continue;
+        }
+        e.extra_lines.insert(e.extra_lines.end(), extra_lines.begin(), extra_lines.end());
+        buffer->failures.push_back(std::move(e));
+    }
+    for (auto& s : captured.suppressed)
+        add_suppressed_foreign_failure(*buffer, s.kind, std::move(s.expr), s.location, s.count);
+}
+
+// wrong use of the framework, reported like a check result on any thread but not subject to the failure caps
+void report_usage_error(test_error error)
+{
+    if (!g_capture_stack.empty())
+    {
+        g_capture_stack.back()->errors.push_back(std::move(error));
+        return;
+    }
+
+    if (!g_context_stack.empty())
+    {
+        g_context_stack.back().add_error(std::move(error));
+        return;
+    }
+
+    auto const buffer = thread_foreign_buffer();
+    if (buffer == nullptr)
+        return; // no test running
+
+    auto lock = std::lock_guard(buffer->mutex);
+    buffer->failures.push_back(std::move(error));
+}
 } // namespace
 } // namespace nx
 
 
 nx::impl::raii_section_opener nx::impl::test_open_section(std::string name, std::source_location location)
 {
+    // e.g. in concurrent() bodies or pool tasks: only the thread running the test explores sections
+    if (g_context_stack.empty())
+    {
+        auto expanded = std::format("section \"{}\" opened on a thread not running the test", name);
+        report_usage_error(test_error{
+            .expr = std::format("SECTION(\"{}\")", name),
+            .location = location,
+            .extra_lines = {"sections can only be used on the thread running the test, this one was skipped"},
+            .expanded = std::move(expanded),
+        });
+        return raii_section_opener(false);
+    }
+
     auto& ctx = g_context_stack.back();
 
     auto& curr_sec = *ctx.curr_section.back();
@@ -206,10 +642,16 @@ nx::impl::raii_section_opener nx::impl::test_open_section(std::string name, std:
     // .. otherwise enter it
     ctx.curr_section.push_back(subsec.get());
     subsec->next_open_section = nullptr;
-    return raii_section_opener(true);
+    subsec->enter(ctx.pass_timer->elapsed_seconds());
+    auto const is_traced = impl::is_tracing();
+    if (is_traced)
+        impl::trace_begin(subsec->name, "section");
+    impl::profile_push_label(subsec->name);
+    return raii_section_opener(true, is_traced);
 }
 
-nx::impl::raii_section_opener::raii_section_opener(bool is_opened) : _is_opened(is_opened)
+nx::impl::raii_section_opener::raii_section_opener(bool is_opened, bool is_traced)
+  : _is_opened(is_opened), _is_traced(is_traced)
 {
 }
 
@@ -217,11 +659,15 @@ nx::impl::raii_section_opener::~raii_section_opener()
 {
     if (_is_opened)
     {
+        // only opened with a test context, which outlives every section of its thread
+        CC_ASSERT(!g_context_stack.empty(), "section closed on a thread without test context");
         auto& ctx = g_context_stack.back();
         auto& subsec = *ctx.curr_section.back();
 
         CC_ASSERT(ctx.curr_section.size() >= 2, "should always have at least this + root on the stack");
 
+        subsec.leave(ctx.pass_timer->elapsed_seconds(), ctx.curr_section[ctx.curr_section.size() - 2]);
+
         // if after the section we have no subsecs => found & executed a leaf!
         // (no next open, might have unreachable still)
         // also applies to our way back up
@@ -238,6 +684,9 @@ nx::impl::raii_section_opener::~raii_section_opener()
         }
 
         ctx.curr_section.pop_back();
+        if (_is_traced)
+            impl::trace_end();
+        impl::profile_pop_label();
     }
 }
 
@@ -248,8 +697,38 @@ void nx::impl::report_check_result(check_kind kind,
                                    std::vector<std::string> extra_lines,
                                    std::source_location location)
 {
+    if (!g_capture_stack.empty())
+    {
+        auto& captured = *g_capture_stack.back();
+        ++captured.executed_checks;
+        if (!passed)
+        {
+            ++captured.failed_checks;
+            auto const kind_name = kind == check_kind::require ? "REQUIRE" : "CHECK";
+            if (captured.should_record_failure(kind_name, expr, location))
+            {
+                auto expanded = format_expanded(op, expr, extra_lines);
+                captured.errors.push_back(test_error{
+                    .expr = std::move(expr),
+                    .location = location,
+                    .extra_lines = std::move(extra_lines),
+                    .expanded = std::move(expanded),
+                    .info = format_info_stack(),
+                    .kind = kind_name,
+                });
+            }
+
+            if (kind == check_kind::require)
+                throw test_require_failed{};
+        }
+        return;
+    }
+
     if (g_context_stack.empty())
-        return; // No active test context
+    {
+        report_foreign_check_result(kind, op, std::move(expr), passed, std::move(extra_lines), location);
+        return;
+    }
 
     auto& ctx = g_context_stack.back();
 
@@ -261,19 +740,20 @@ void nx::impl::report_check_result(check_kind kind,
     {
         ++ctx.failed_checks;
 
-        std::string expanded;
-        if (op == cmp_op::none)
-            expanded = std::format("'{}' failed", expr);
-        else
-            expanded = std::format("{} {} {}", extra_lines[0], op_to_string(op), extra_lines[1]);
-
-        // Add test error
-        ctx.errors.push_back(test_error{
-            .expr = std::move(expr),
-            .location = location,
-            .extra_lines = std::move(extra_lines),
-            .expanded = std::move(expanded),
-        });
+        // Add test error (unless over the failure caps)
+        auto const kind_name = kind == check_kind::require ? "REQUIRE" : "CHECK";
+        if (ctx.should_record_failure(kind_name, expr, location))
+        {
+            auto expanded = format_expanded(op, expr, extra_lines);
+            ctx.errors.push_back(ctx.strings->intern(test_error{
+                .expr = std::move(expr),
+                .location = location,
+                .extra_lines = std::move(extra_lines),
+                .expanded = std::move(expanded),
+                .info = format_info_stack(),
+                .kind = kind_name,
+            }));
+        }
 
         // If this was a REQUIRE, throw exception to abort test execution
         if (kind == check_kind::require)
@@ -281,11 +761,193 @@ void nx::impl::report_check_result(check_kind kind,
     }
 }
 
+void nx::impl::report_benchmark_result(benchmark_result result)
+{
+    if (g_context_stack.empty())
+        return; // No active test context
+
+    auto& ctx = g_context_stack.back();
+
+    // a finished benchmark is a passing check, so benchmark-only tests are not flagged as "no CHECK/REQUIRE"
+    ++ctx.executed_checks;
+    ctx.execution->benchmarks.push_back(std::move(result));
+}
+
+nx::test_schedule_config const& nx::impl::current_schedule_config()
+{
+    static test_schedule_config const default_config;
+    if (g_context_stack.empty())
+        return default_config;
+    return *g_context_stack.back().config;
+}
+
+nx::test_declaration const* nx::impl::current_test_declaration()
+{
+    if (g_context_stack.empty())
+        return nullptr;
+    return g_context_stack.back().execution->instance.declaration;
+}
+
+nx::impl::captured_checks nx::impl::run_captured(void (*fn)(void*), void* userdata, std::source_location location)
+{
+    captured_checks result;
+    g_capture_stack.push_back(&result);
+
+    try
+    {
+        auto _ = cc::impl::scoped_assertion_handler(
+            [](cc::impl::assertion_info const& info)
+            {
+                // failing assertion has same semantics as REQUIRE -> it aborts
+                nx::impl::report_check_result(impl::check_kind::require, impl::cmp_op::none, info.expression, false,
+                                              {info.message}, info.location);
+            });
+
+        fn(userdata);
+    }
+    catch (test_require_failed const&) // NOLINT(bugprone-empty-catch)
+    {
+        // already captured in report_check_result
+    }
+    catch (std::exception const& e)
+    {
+        result.errors.push_back(test_error{
+            .expr = std::format("uncaught exception: {}", e.what()),
+            .location = location,
+            .extra_lines = {},
+            .expanded = std::format("uncaught exception: {}", e.what()),
+        });
+    }
+    catch (...)
+    {
+        result.errors.push_back(test_error{
+            .expr = "uncaught unknown exception",
+            .location = location,
+            .extra_lines = {},
+            .expanded = "uncaught unknown exception",
+        });
+    }
+
+    g_capture_stack.pop_back();
+    return result;
+}
+
+void nx::impl::abort_silently() { throw test_require_failed{}; }
+
+bool nx::impl::is_require_unwind(std::exception_ptr const& error)
+{
+    try
+    {
+        std::rethrow_exception(error);
+    }
+    catch (test_require_failed const&)
+    {
+        return true;
+    }
+    catch (...)
+    {
+        return false;
+    }
+}
+
+void nx::impl::report_captured_checks(captured_checks captured, std::vector<std::string> const& extra_lines)
+{
+    if (!g_capture_stack.empty())
+    {
+        // nested capture: simply forward to the outer one
+        g_capture_stack.back()->merge(std::move(captured), extra_lines);
+        return;
+    }
+
+    if (g_context_stack.empty())
+    {
+        report_foreign_captured_checks(std::move(captured), extra_lines);
+        return;
+    }
+
+    auto& ctx = g_context_stack.back();
+    ctx.executed_checks += captured.executed_checks;
+    ctx.failed_checks += captured.failed_checks;
+    for (auto& e : captured.errors)
+    {
+        e.extra_lines.insert(e.extra_lines.end(), extra_lines.begin(), extra_lines.end());
+        ctx.add_failure(std::move(e));
+    }
+    for (auto const& s : captured.suppressed)
+        ctx.failures_at(s.kind, s.expr, s.location).suppressed += s.count;
+}
+
+bool nx::impl::captured_checks::should_record_failure(char const* kind, std::string_view expr, std::source_location location)
+{
+    auto const& config = impl::current_schedule_config();
+    auto& recorded = recorded_per_location[std::tuple(location.file_name(), location.line(), location.column())];
+    if ((config.max_failures_per_test > 0 && recorded_failures >= config.max_failures_per_test)
+        || (config.max_failures_per_location > 0 && recorded >= config.max_failures_per_location))
+    {
+        add_suppressed_failures(kind, expr, location, 1);
+        return false;
+    }
+
+    ++recorded_failures;
+    ++recorded;
+    return true;
+}
+
+void nx::impl::captured_checks::add_suppressed_failures(char const* kind,
+                                                        std::string_view expr,
+                                                        std::source_location location,
+                                                        std::int64_t count)
+{
+    auto const it = std::ranges::find_if(suppressed,
+                                         [&](suppressed_failures const& s)
+                                         {
+                                             return s.location.file_name() == location.file_name()
+                                                 && s.location.line() == location.line()
+                                                 && s.location.column() == location.column();
+                                         });
+    if (it != suppressed.end())
+    {
+        it->count += count;
+        return;
+    }
+    suppressed.push_back({.kind = kind, .expr = std::string(expr), .location = location, .count = count});
+}
+
+void nx::impl::captured_checks::merge(captured_checks other, std::vector<std::string> const& extra_lines)
+{
+    executed_checks += other.executed_checks;
+    failed_checks += other.failed_checks;
+    for (auto& e : other.errors)
+    {
+        if (e.kind != nullptr && !should_record_failure(e.kind, e.expr, e.location))
+            continue;
+        e.extra_lines.insert(e.extra_lines.end(), extra_lines.begin(), extra_lines.end());
+        errors.push_back(std::move(e));
+    }
+    for (auto const& s : other.suppressed)
+        add_suppressed_failures(s.kind, s.expr, s.location, s.count);
+}
+
 bool nx::test_execution::is_considered_failing() const
 {
     return root.is_considered_failing;
 }
 
+std::span<nx::test_error_view const> nx::test_execution::errors_of(section const& sec) const
+{
+    return std::span(errors).subspan(size_t(sec.first_error), size_t(sec.error_count));
+}
+
+std::span<nx::test_error_view const> nx::test_execution::own_errors_of(section const& sec) const
+{
+    return std::span(errors).subspan(size_t(sec.first_error), size_t(sec.own_error_count));
+}
+
+double nx::test_execution::repeated_prefix_seconds() const
+{
+    return sum_repeated_seconds(root);
+}
+
 int nx::test_schedule_execution::count_total_tests() const
 {
     return int(executions.size());
@@ -324,6 +986,8 @@ nx::test_schedule_execution nx::execute_tests(test_schedule const& schedule, tes
 {
     test_schedule_execution result;
 
+    impl::install_crash_reporter();
+
     if (config.verbose)
     {
         std::cout << "executing " << schedule.instances.size() << " tests\n" << std::flush;
@@ -336,8 +1000,18 @@ nx::test_schedule_execution nx::execute_tests(test_schedule const& schedule, tes
         test_execution execution;
         execution.instance = instance;
 
+        auto _crash = impl::scoped_crash_context([&] { return std::format("test \"{}\"", instance.declaration->name); });
+        auto _trace = trace_scope(instance.declaration->name, "test");
+
+        // nested test runs are attributed to the profile of the outer test
+        auto const is_profiling = !config.profile_dir.empty() && impl::start_profiling(config.profile_frequency);
+        impl::profile_push_label(instance.declaration->name);
+
+        auto const resources_at_start = impl::read_resource_usage();
+        auto const test_log = impl::scoped_test_log();
+
         // Set up test context for check reporting
-        test_execute_begin(execution);
+        test_execute_begin(execution, config);
 
         // Execute the test function if it exists
         auto section_num = 0;
@@ -361,10 +1035,20 @@ nx::test_schedule_execution nx::execute_tests(test_schedule const& schedule, tes
                               << std::flush;
             }
             section_num++;
-            auto const t_section_start = std::chrono::high_resolution_clock::now();
+
+            // every re-entry is its own span, so repeated prefix code shows up in the timeline
+            auto _trace_pass = trace_scope(std::format("pass {}", section_num), "pass");
+
+            // pause_timer() / resume_timer() inside the test act on this
+            stopwatch section_timer;
+            section_timer.start();
+            g_context_stack.back().pass_timer = &section_timer;
+            g_context_stack.back().root_section->enter(0.0);
 
             try
             {
+                auto _timer = impl::scoped_active_stopwatch(section_timer);
+
                 auto _ = cc::impl::scoped_assertion_handler(
                     [](cc::impl::assertion_info const& info)
                     {
@@ -373,7 +1057,10 @@ nx::test_schedule_execution nx::execute_tests(test_schedule const& schedule, tes
                                                       false, {info.message}, info.location);
                     });
 
-                (*instance.declaration->function)();
+                if (instance.declaration->test_config.concurrent_threads > 0)
+                    impl::run_concurrently(*instance.declaration);
+                else
+                    (*instance.declaration->function)();
             }
             catch (test_require_failed const&) // NOLINT(bugprone-empty-catch)
             {
@@ -382,7 +1069,7 @@ nx::test_schedule_execution nx::execute_tests(test_schedule const& schedule, tes
             }
             catch (test_duplicate_section const& e)
             {
-                g_context_stack.back().errors.push_back(test_error{
+                g_context_stack.back().add_error(test_error{
                     .expr = std::format("duplicate section: \"{}\"", e.name),
                     .location = e.location,
                     .extra_lines = {},
@@ -392,7 +1079,7 @@ nx::test_schedule_execution nx::execute_tests(test_schedule const& schedule, tes
             }
             catch (std::exception const& e)
             {
-                g_context_stack.back().errors.push_back(test_error{
+                g_context_stack.back().add_error(test_error{
                     .expr = std::format("uncaught exception: {}", e.what()),
                     .location = instance.declaration->location,
                     .extra_lines = {},
@@ -401,7 +1088,7 @@ nx::test_schedule_execution nx::execute_tests(test_schedule const& schedule, tes
             }
             catch (...)
             {
-                g_context_stack.back().errors.push_back(test_error{
+                g_context_stack.back().add_error(test_error{
                     .expr = "uncaught unknown exception",
                     .location = instance.declaration->location,
                     .extra_lines = {},
@@ -416,8 +1103,10 @@ nx::test_schedule_execution nx::execute_tests(test_schedule const& schedule, tes
             CC_ASSERT(sec != nullptr, "should always have a leaf section");
             {
                 auto& ctx = g_context_stack.back();
-                auto const t_section_end = std::chrono::high_resolution_clock::now();
-                sec->duration_seconds = std::chrono::duration<double>(t_section_end - t_section_start).count();
+                ctx.merge_foreign_checks();
+                section_timer.pause();
+                ctx.root_section->leave(section_timer.elapsed_seconds(), nullptr);
+                ctx.pass_timer = nullptr;
                 sec->executed_checks = cc::exchange(ctx.executed_checks, 0);
                 sec->failed_checks = cc::exchange(ctx.failed_checks, 0);
                 sec->errors = cc::exchange(ctx.errors, {});
@@ -437,6 +1126,27 @@ nx::test_schedule_execution nx::execute_tests(test_schedule const& schedule, tes
 
         // Clean up test context
         test_execute_end();
+        execution.resources = impl::read_resource_usage().since(resources_at_start);
+        if (execution.is_considered_failing())
+            execution.log = test_log.collect();
+
+        impl::profile_pop_label();
+        if (is_profiling)
+        {
+            auto const profile = impl::stop_profiling();
+            if (profile.samples > 0)
+            {
+                auto const path = impl::write_test_profile(config.profile_dir, instance.declaration->name, profile);
+                if (path.empty())
+                    std::cerr << "Error: Could not write profile to `" << config.profile_dir << "'\n";
+                else if (config.verbose)
+                    std::cout << "    profile: " << profile.samples << " samples in " << path.string() << '\n'
+                              << std::flush;
+            }
+            if (profile.dropped_samples > 0)
+                std::cerr << "Warning: profile of \"" << instance.declaration->name << "\" dropped "
+                          << profile.dropped_samples << " samples (buffer full)\n";
+        }
 
         if (config.verbose)
         {
@@ -444,8 +1154,19 @@ nx::test_schedule_execution nx::execute_tests(test_schedule const& schedule, tes
             std::cout << "    ... in " << std::fixed << std::setprecision(2) << duration_ms << " ms ("
                       << execution.root.executed_checks << " checks, "      //
                       << execution.root.failed_checks << " failed checks, " //
-                      << execution.root.errors.size() << " errors)\n"
+                      << execution.root.error_count << " errors)\n"
                       << std::flush;
+
+            if (auto const repeated = execution.repeated_prefix_seconds(); repeated > 0.0)
+                std::cout << "    ... of which " << repeated * 1000.0 << " ms re-ran section prefixes\n" << std::flush;
+
+            std::cout << "    ... " << to_string(execution.resources) << '\n' << std::flush;
+
+            for (auto const& bench : execution.benchmarks)
+                std::cout << "    benchmark \"" << bench.name << "\": " << std::setprecision(2)
+                          << bench.real_time_per_iteration() * 1e9 << " ns/iter (" << bench.iterations << " iterations, "
+                          << to_string(bench.resources) << ")\n"
+                          << std::flush;
         }
 
         result.executions.push_back(std::move(execution));
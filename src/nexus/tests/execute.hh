@@ -1,9 +1,18 @@
 #pragma once
 
+#include <nexus/tests/resources.hh>
 #include <nexus/tests/schedule.hh>
 
+#include <cstdint>
+#include <exception>
+#include <map>
+#include <memory>
 #include <source_location>
+#include <span>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
 #include <vector>
 
 
@@ -12,6 +21,7 @@ namespace nx::impl
 {
 enum class check_kind;
 enum class cmp_op;
+struct string_pool;
 } // namespace nx::impl
 
 namespace nx
@@ -23,6 +33,47 @@ struct test_error
     std::vector<std::string> extra_lines;
     std::string expanded; // shown inline next to the code at location (important for VSCode DX)
     // NOTE: if expr == expanded, C++ TestMate just shows "failed" instead of anything useful, so make sure they are always different
+    std::vector<std::string> info; // INFO/CAPTURE messages in scope when the check failed, outermost first
+
+    // "CHECK" or "REQUIRE" for failed checks, nullptr for other errors (exceptions, crashes, ...)
+    // only failed checks count towards max_failures_per_test / _per_location and are summarized beyond them
+    char const* kind = nullptr;
+};
+
+// a test_error as stored in the results of a test
+// the strings are interned and owned by the test_execution, so a CHECK failing in a loop stores its text only once
+struct test_error_view
+{
+    std::string_view expr;
+    std::source_location location;
+    std::vector<std::string_view> extra_lines;
+    std::string_view expanded;
+    std::vector<std::string_view> info;
+};
+
+struct benchmark_result
+{
+    std::string name;
+    std::source_location location;
+
+    // of the final measured batch
+    std::int64_t iterations = 0;
+    double real_time_seconds = 0.0; // total, excluding paused time
+    double cpu_time_seconds = 0.0;  // total thread CPU time, excluding paused time
+
+    std::map<std::string, double> counters;
+
+    // of the final measured batch, including paused time
+    resource_usage resources;
+
+    [[nodiscard]] double real_time_per_iteration() const
+    {
+        return iterations > 0 ? real_time_seconds / double(iterations) : 0.0;
+    }
+    [[nodiscard]] double cpu_time_per_iteration() const
+    {
+        return iterations > 0 ? cpu_time_seconds / double(iterations) : 0.0;
+    }
 };
 
 struct test_execution
@@ -35,13 +86,25 @@ struct test_execution
         std::source_location location;
         std::vector<section> subsections;
 
-        // NOTE: only valid for leaf sections
-        std::vector<test_error> errors;
+        // range in test_execution::errors, see errors_of / own_errors_of
+        // own errors come first, followed by the ranges of the subsections
+        int first_error = 0;
+        int own_error_count = 0;
+        int error_count = 0; // including subsections
 
-        // stats
+        // stats, including subsections
         int executed_checks = 0;
         int failed_checks = 0;
+
+        // times summed over all passes (re-entries) that entered this section
+        // - duration_seconds: inclusive, i.e. with subsections
+        // - self_seconds: exclusive, i.e. code of this section outside of its subsections
+        // - repeated_seconds: self time of all but the first pass, i.e. prefix (and suffix) code that only ran
+        //   again to reach the next subsection
+        int entries = 0;
         double duration_seconds = 0.0;
+        double self_seconds = 0.0;
+        double repeated_seconds = 0.0;
 
         // result
         bool is_considered_failing = false;
@@ -50,7 +113,32 @@ struct test_execution
     // note: global stats == root stats
     section root;
 
+    // failures of all sections, each stored once (sections refer to them by index range)
+    std::vector<test_error_view> errors;
+
+    // backing storage of the strings in errors, shared so that copies of the execution stay valid
+    std::shared_ptr<impl::string_pool const> strings;
+
+    // in order of execution, across all sections
+    std::vector<benchmark_result> benchmarks;
+
+    // nx::log records of all threads in time order, only kept if the test failed
+    std::vector<std::string> log;
+
+    // consumed by the thread running the test, over all passes
+    // (threads started by the test, e.g. PROPERTY workers, are not included)
+    resource_usage resources;
+
     [[nodiscard]] bool is_considered_failing() const;
+
+    // errors of the section and its subsections
+    [[nodiscard]] std::span<test_error_view const> errors_of(section const& sec) const;
+    // errors reported while the section was the innermost one, or found about it (e.g. missing checks)
+    [[nodiscard]] std::span<test_error_view const> own_errors_of(section const& sec) const;
+
+    // time spent re-executing section prefixes, summed over all sections
+    // high values suggest splitting the test or moving expensive shared setup out of it
+    [[nodiscard]] double repeated_prefix_seconds() const;
 };
 
 struct test_schedule_execution
@@ -69,10 +157,79 @@ test_schedule_execution execute_tests(test_schedule const& schedule, test_schedu
 
 namespace nx::impl
 {
+// records a check in the current test (or run_captured call) of this thread
+// checks on other threads, e.g. workers started by the test, are attributed to the test running at that time:
+// - they are buffered per thread and merged into the current section at the end of each pass
+// - a failing REQUIRE is recorded but cannot abort the test from there, the thread just continues
+// - checks after the test ended (threads that were not joined) are lost
 void report_check_result(check_kind kind,
                          cmp_op op,
                          std::string expr,
                          bool passed,
                          std::vector<std::string> extra_lines,
                          std::source_location location);
+
+// records the benchmark in the current test execution (counts as a passing check)
+void report_benchmark_result(benchmark_result result);
+
+// config of the innermost running execute_tests on this thread (defaults if none is running)
+test_schedule_config const& current_schedule_config();
+
+// declaration of the test running on this thread (nullptr if none is running)
+test_declaration const* current_test_declaration();
+
+// checks of a run_captured call, kept out of the current test until explicitly reported
+struct captured_checks
+{
+    int executed_checks = 0;
+    int failed_checks = 0;
+    std::vector<test_error> errors;
+
+    // failed checks beyond max_failures_per_test / _per_location of the current test are not formatted, only counted
+    struct suppressed_failures
+    {
+        char const* kind = nullptr;
+        std::string expr;
+        std::source_location location;
+        std::int64_t count = 0;
+    };
+    std::vector<suppressed_failures> suppressed; // in order of the first suppressed failure per location
+
+    int recorded_failures = 0;
+    std::map<std::tuple<char const*, std::uint_least32_t, std::uint_least32_t>, int> recorded_per_location;
+
+    [[nodiscard]] bool is_failing() const { return failed_checks > 0 || !errors.empty(); }
+
+    // true if a failure at location is within the caps (and counts it as recorded), otherwise it is counted as suppressed
+    bool should_record_failure(char const* kind, std::string_view expr, std::source_location location);
+    void add_suppressed_failures(char const* kind, std::string_view expr, std::source_location location, std::int64_t count);
+
+    // adds all checks of other, its failures are subject to the caps of this capture
+    // extra_lines are appended to each error
+    void merge(captured_checks other, std::vector<std::string> const& extra_lines = {});
+};
+
+// runs fn so that CHECK/REQUIRE results, failed assertions, and uncaught exceptions are captured
+// - REQUIRE failures and exceptions end fn early, like they end a test
+// - uncaught exceptions are attributed to location
+// - works on threads without an active test
+// - SECTION is not supported inside fn
+captured_checks run_captured(void (*fn)(void*), void* userdata, std::source_location location);
+
+template <class F>
+captured_checks run_captured(F&& fn, std::source_location location)
+{
+    return impl::run_captured([](void* f) { (*static_cast<std::remove_reference_t<F>*>(f))(); }, &fn, location);
+}
+
+// ends the current run_captured call (or the current test) like a failed REQUIRE, but without recording anything
+// e.g. to unwind threads of an aborted run after its failure was recorded elsewhere
+[[noreturn]] void abort_silently();
+
+// true if error is the unwinding of a failed REQUIRE (or abort_silently), which run_captured ends quietly
+[[nodiscard]] bool is_require_unwind(std::exception_ptr const& error);
+
+// adds previously captured checks to the current test (on other threads like report_check_result)
+// extra_lines are appended to each error (e.g. the input that triggered it)
+void report_captured_checks(captured_checks captured, std::vector<std::string> const& extra_lines);
 }
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace nx::impl
+{
+constexpr std::uint64_t fnv1a_offset_basis = 0xcbf29ce484222325ull;
+
+// 64 bit FNV-1a, used for seeds, content hashes, and signatures
+// passing a previous hash as start chains hashes (e.g. a name seeded by a test seed)
+[[nodiscard]] constexpr std::uint64_t fnv1a(std::span<std::byte const> data, std::uint64_t hash = fnv1a_offset_basis)
+{
+    for (auto b : data)
+        hash = (hash ^ std::uint64_t(b)) * 0x100000001b3ull;
+    return hash;
+}
+[[nodiscard]] constexpr std::uint64_t fnv1a(std::string_view str, std::uint64_t hash = fnv1a_offset_basis)
+{
+    for (auto c : str)
+        hash = (hash ^ std::uint64_t(static_cast<unsigned char>(c))) * 0x100000001b3ull;
+    return hash;
+}
+
+// increment of the splitmix64 state, also a good odd constant to spread stream indices
+constexpr std::uint64_t splitmix64_gamma = 0x9e3779b97f4a7c15ull;
+
+// splitmix64 finalizer: a bijection that spreads every input bit over the whole result
+[[nodiscard]] constexpr std::uint64_t splitmix64_mix(std::uint64_t z)
+{
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+// small, fast, deterministic PRNG step (splitmix64): advances state and returns the next value
+constexpr std::uint64_t splitmix64_next(std::uint64_t& state) { return splitmix64_mix(state += splitmix64_gamma); }
+
+} // namespace nx::impl
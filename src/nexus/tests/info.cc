@@ -0,0 +1,72 @@
+#include "info.hh"
+
+#include <clean-core/assert.hh>
+
+namespace
+{
+struct info_entry
+{
+    nx::impl::info_formatter format = nullptr;
+    void const* data = nullptr;
+};
+
+// only grows, so that pushing in a loop does not allocate after the first iteration
+thread_local std::vector<info_entry> g_info_stack;
+} // namespace
+
+void nx::impl::push_info(info_formatter format, void const* data) { g_info_stack.push_back({format, data}); }
+
+void nx::impl::pop_info()
+{
+    CC_ASSERT(!g_info_stack.empty(), "unbalanced INFO/CAPTURE scopes");
+    g_info_stack.pop_back();
+}
+
+std::vector<std::string> nx::impl::format_info_stack()
+{
+    std::vector<std::string> lines;
+    lines.reserve(g_info_stack.size());
+    for (auto const& entry : g_info_stack)
+        lines.push_back(entry.format(entry.data));
+    return lines;
+}
+
+std::vector<std::string_view> nx::impl::split_capture_names(std::string_view names)
+{
+    std::vector<std::string_view> result;
+    auto depth = 0;
+    char quote = 0;
+    size_t start = 0;
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        auto const c = names[i];
+        if (quote != 0)
+        {
+            if (c == '\\')
+                ++i;
+            else if (c == quote)
+                quote = 0;
+        }
+        else if (c == '"' || c == '\'')
+            quote = c;
+        else if (c == '(' || c == '[' || c == '{')
+            ++depth;
+        else if (c == ')' || c == ']' || c == '}')
+            --depth;
+        else if (c == ',' && depth == 0)
+        {
+            result.push_back(names.substr(start, i - start));
+            start = i + 1;
+        }
+    }
+    result.push_back(names.substr(start));
+
+    for (auto& name : result)
+    {
+        while (!name.empty() && name.front() == ' ')
+            name.remove_prefix(1);
+        while (!name.empty() && name.back() == ' ')
+            name.remove_suffix(1);
+    }
+    return result;
+}
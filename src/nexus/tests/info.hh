@@ -0,0 +1,87 @@
+#pragma once
+
+#include <nexus/tests/container_diff.hh>
+
+#include <clean-core/macros.hh>
+
+#include <format> // NOLINT(unused-includes) - used by INFO macro
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace nx::impl
+{
+// INFO/CAPTURE messages of the current thread
+// - only formatted when a check fails while they are in scope, then attached to its test_error
+// - entering and leaving a scope neither allocates nor formats, so they are cheap in hot loops
+// - values are read when the check fails, not when the message is declared
+
+using info_formatter = std::string (*)(void const* data);
+
+void push_info(info_formatter format, void const* data);
+void pop_info();
+
+// the messages currently in scope on this thread, outermost first
+[[nodiscard]] std::vector<std::string> format_info_stack();
+
+template <class F>
+struct scoped_info
+{
+    explicit scoped_info(F describe) : _describe(std::move(describe)) { push_info(&format, this); }
+    scoped_info(scoped_info&&) = delete;
+    scoped_info(scoped_info const&) = delete;
+    scoped_info& operator=(scoped_info&&) = delete;
+    scoped_info& operator=(scoped_info const&) = delete;
+    ~scoped_info() { pop_info(); }
+
+private:
+    static std::string format(void const* self) { return static_cast<scoped_info const*>(self)->_describe(); }
+
+    F _describe;
+};
+
+// "a, v[i], f(x, y)" -> {"a", "v[i]", "f(x, y)"}, i.e. splits at top-level commas only
+[[nodiscard]] std::vector<std::string_view> split_capture_names(std::string_view names);
+
+// "a := 1, b := [1, 2]" for CAPTURE(a, b)
+template <class... Args>
+std::string format_captures(std::string_view names, Args const&... values)
+{
+    auto const split = split_capture_names(names);
+    std::string result;
+    size_t i = 0;
+    auto const append = [&](auto const& value)
+    {
+        if (i > 0)
+            result += ", ";
+        result += std::format("{} := {}", i < split.size() ? split[i] : "?", bounded_debug_string(value));
+        ++i;
+    };
+    (append(values), ...);
+    return result;
+}
+
+} // namespace nx::impl
+
+// INFO macro: std::format-style message that is reported with every check failing in the current scope
+// the arguments are captured by reference and only formatted on failure
+//
+// Examples:
+//   for (auto i = 0; i < n; ++i)
+//   {
+//       INFO("iteration {} of {}", i, n);
+//       CHECK(f(i) >= 0);
+//   }
+#define INFO(...) \
+    ::nx::impl::scoped_info CC_MACRO_JOIN(_nx_info_, __COUNTER__)([&] { return "info: " + std::format(__VA_ARGS__); })
+
+// CAPTURE macro: reports names and values of the given expressions with every check failing in the current scope
+// the expressions are evaluated on failure
+//
+// Examples:
+//   CAPTURE(x, y);        // "x := 3, y := 4"
+//   CAPTURE(v.size());    // "v.size() := 10"
+#define CAPTURE(...)                                         \
+    ::nx::impl::scoped_info CC_MACRO_JOIN(_nx_capture_, __COUNTER__)( \
+        [&] { return ::nx::impl::format_captures(#__VA_ARGS__, __VA_ARGS__); })
@@ -0,0 +1,29 @@
+#include "json.hh"
+
+#include <format>
+
+std::string nx::impl::json_escape(std::string_view str)
+{
+    std::string result;
+    result.reserve(str.size());
+
+    for (auto c : str)
+    {
+        switch (c)
+        {
+        case '"': result += "\\\""; break;
+        case '\\': result += "\\\\"; break;
+        case '\n': result += "\\n"; break;
+        case '\r': result += "\\r"; break;
+        case '\t': result += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+                result += std::format("\\u{:04x}", int(c));
+            else
+                result += c;
+            break;
+        }
+    }
+
+    return result;
+}
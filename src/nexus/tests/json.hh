@@ -0,0 +1,10 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace nx::impl
+{
+// escapes str for use inside a JSON string literal (quotes, backslashes, and control characters)
+[[nodiscard]] std::string json_escape(std::string_view str);
+} // namespace nx::impl
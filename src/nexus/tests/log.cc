@@ -0,0 +1,209 @@
+#include "log.hh"
+
+#include <nexus/tests/timer.hh>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace
+{
+struct log_record
+{
+    // odd while being written, 2 * index + 2 once complete
+    // (a seqlock, so that a reader can detect records that a still running thread overwrote meanwhile)
+    std::atomic<std::uint64_t> sequence = 0;
+
+    // only accessed via load_relaxed / store_relaxed: a reader racing with the writer gets a torn copy,
+    // which the sequence check discards, but no data race
+    std::uint64_t test_id = 0;
+    std::uint64_t time = 0; // tick_clock ticks
+    nx::impl::log_formatter format = nullptr;
+    char const* fmt_data = nullptr;
+    size_t fmt_size = 0;
+    std::uint32_t size = 0;
+    bool is_truncated = false;
+    std::uint64_t payload[nx::impl::log_record_payload_size / sizeof(std::uint64_t)] = {};
+};
+static_assert(nx::impl::log_record_payload_size % sizeof(std::uint64_t) == 0);
+
+template <class T>
+void store_relaxed(T& field, std::type_identity_t<T> value)
+{
+    std::atomic_ref<T>(field).store(value, std::memory_order_relaxed);
+}
+
+template <class T>
+T load_relaxed(T& field)
+{
+    return std::atomic_ref<T>(field).load(std::memory_order_relaxed);
+}
+
+struct log_buffer
+{
+    int thread_index = 0;
+
+    // number of records ever written, the ring holds the last log_buffer_records of them
+    std::atomic<std::uint64_t> head = 0;
+
+    // index of the first record of the most recent test that logged on this thread
+    // so that the report can say how many of its records were overwritten
+    std::atomic<std::uint64_t> test_id = 0;
+    std::atomic<std::uint64_t> test_first_index = 0;
+
+    log_record records[nx::impl::log_buffer_records];
+};
+
+std::atomic<std::uint64_t> g_log_test_id = 0;
+std::atomic<std::uint64_t> g_next_log_test_id = 1;
+
+// buffers of all threads that logged, kept alive until the next test starts so that records of ended threads can be reported
+std::mutex g_log_buffers_mutex;
+std::vector<std::shared_ptr<log_buffer>> g_log_buffers;
+int g_next_thread_index = 0;
+
+thread_local std::shared_ptr<log_buffer> g_thread_log_buffer;
+
+log_buffer& thread_log_buffer()
+{
+    if (g_thread_log_buffer == nullptr)
+    {
+        auto buffer = std::make_shared<log_buffer>();
+        auto lock = std::lock_guard(g_log_buffers_mutex);
+        buffer->thread_index = g_next_thread_index++;
+        g_log_buffers.push_back(buffer);
+        g_thread_log_buffer = std::move(buffer);
+    }
+    return *g_thread_log_buffer;
+}
+} // namespace
+
+bool nx::impl::is_logging() { return g_log_test_id.load(std::memory_order_relaxed) != 0; }
+
+void nx::impl::write_log_record(
+    std::string_view fmt, log_formatter format, std::byte const* payload, std::uint32_t size, bool is_truncated)
+{
+    auto const test_id = g_log_test_id.load(std::memory_order_relaxed);
+    if (test_id == 0)
+        return;
+
+    auto& buffer = thread_log_buffer();
+    auto const index = buffer.head.load(std::memory_order_relaxed);
+    if (buffer.test_id.load(std::memory_order_relaxed) != test_id)
+    {
+        buffer.test_first_index.store(index, std::memory_order_relaxed);
+        buffer.test_id.store(test_id, std::memory_order_relaxed);
+    }
+
+    auto& record = buffer.records[index % log_buffer_records];
+    record.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    store_relaxed(record.test_id, test_id);
+    store_relaxed(record.time, tick_clock::now());
+    store_relaxed(record.format, format);
+    store_relaxed(record.fmt_data, fmt.data());
+    store_relaxed(record.fmt_size, fmt.size());
+    store_relaxed(record.size, size);
+    store_relaxed(record.is_truncated, is_truncated);
+    for (size_t offset = 0; offset < size; offset += sizeof(std::uint64_t))
+    {
+        std::uint64_t word = 0;
+        std::memcpy(&word, payload + offset, std::min<size_t>(sizeof(word), size - offset));
+        store_relaxed(record.payload[offset / sizeof(word)], word);
+    }
+    record.sequence.store(2 * index + 2, std::memory_order_release);
+    buffer.head.store(index + 1, std::memory_order_release);
+}
+
+nx::impl::scoped_test_log::scoped_test_log()
+{
+    _test_id = g_next_log_test_id.fetch_add(1, std::memory_order_relaxed);
+    _previous_test_id = g_log_test_id.exchange(_test_id, std::memory_order_relaxed);
+    _start_time = tick_clock::now();
+
+    // buffers of threads that ended can only hold records of earlier tests
+    // in a nested run, the outer test is still open and might report them, so only a top-level test prunes
+    if (_previous_test_id == 0)
+    {
+        auto lock = std::lock_guard(g_log_buffers_mutex);
+        std::erase_if(g_log_buffers, [](auto const& buffer) { return buffer.use_count() == 1; });
+    }
+}
+
+nx::impl::scoped_test_log::~scoped_test_log() { g_log_test_id.store(_previous_test_id, std::memory_order_relaxed); }
+
+std::vector<std::string> nx::impl::scoped_test_log::collect() const
+{
+    struct entry
+    {
+        std::uint64_t time = 0;
+        int thread_index = 0;
+        std::string text;
+    };
+    std::vector<entry> entries;
+    std::vector<std::pair<int, std::uint64_t>> overwritten; // thread index, number of records
+
+    auto lock = std::lock_guard(g_log_buffers_mutex);
+    for (auto const& buffer : g_log_buffers)
+    {
+        auto const head = buffer->head.load(std::memory_order_acquire);
+        auto const oldest = head > log_buffer_records ? head - log_buffer_records : 0;
+        for (auto index = oldest; index < head; ++index)
+        {
+            auto& record = buffer->records[index % log_buffer_records];
+            auto const sequence = record.sequence.load(std::memory_order_acquire);
+            if (sequence != 2 * index + 2 || load_relaxed(record.test_id) != _test_id)
+                continue;
+
+            // copy first, the owning thread might still be running and overwrite the record meanwhile
+            auto const time = load_relaxed(record.time);
+            auto const format = load_relaxed(record.format);
+            auto const fmt = std::string_view(load_relaxed(record.fmt_data), load_relaxed(record.fmt_size));
+            auto const size = std::min<size_t>(load_relaxed(record.size), log_record_payload_size);
+            auto const is_truncated = load_relaxed(record.is_truncated);
+            std::byte payload[log_record_payload_size];
+            for (size_t offset = 0; offset < size; offset += sizeof(std::uint64_t))
+            {
+                auto const word = load_relaxed(record.payload[offset / sizeof(std::uint64_t)]);
+                std::memcpy(payload + offset, &word, std::min<size_t>(sizeof(word), size - offset));
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (record.sequence.load(std::memory_order_relaxed) != sequence)
+                continue;
+
+            auto text = format != nullptr ? format(fmt, payload)
+                                          : std::string(reinterpret_cast<char const*>(payload), size);
+            if (is_truncated)
+                text += " [truncated]";
+            entries.push_back({time, buffer->thread_index, std::move(text)});
+        }
+
+        if (buffer->test_id.load(std::memory_order_relaxed) == _test_id)
+            if (auto const first = buffer->test_first_index.load(std::memory_order_relaxed); first < oldest)
+                overwritten.emplace_back(buffer->thread_index, oldest - first);
+    }
+
+    std::ranges::stable_sort(entries, {}, &entry::time);
+
+    // threads are numbered in order of their first record in this test
+    std::unordered_map<int, int> thread_numbers;
+    auto const thread_number = [&](int thread_index)
+    { return thread_numbers.emplace(thread_index, int(thread_numbers.size())).first->second; };
+
+    std::vector<std::string> lines;
+    lines.reserve(overwritten.size() + entries.size());
+    for (auto const& e : entries)
+    {
+        auto const ms = e.time >= _start_time ? tick_clock::to_seconds(e.time - _start_time) * 1e3 : 0.0;
+        lines.push_back(std::format("[+{:.3f} ms] [thread {}] {}", ms, thread_number(e.thread_index), e.text));
+    }
+    for (auto const& [thread_index, dropped] : overwritten)
+        lines.insert(lines.begin(), std::format("[thread {}] {} older records were overwritten (ring buffer of {})",
+                                                thread_number(thread_index), dropped, log_buffer_records));
+    return lines;
+}
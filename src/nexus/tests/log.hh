@@ -0,0 +1,111 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace nx::impl
+{
+// nx::log records are kept in a fixed-size ring buffer per thread (older records are overwritten)
+// - writing a record is wait-free: no locks, no allocation, and usually no formatting
+// - records are only formatted when the test they belong to fails, and discarded otherwise
+// - records of all threads are reported, also of threads that already ended
+// - outside of tests, nx::log does nothing
+
+constexpr size_t log_buffer_records = 1024;
+constexpr size_t log_record_payload_size = 128; // bytes of preformatted text or deferred arguments
+
+// formats the deferred arguments of a record
+using log_formatter = std::string (*)(std::string_view fmt, std::byte const* args);
+
+// true while a test is running, i.e. while nx::log records anything
+[[nodiscard]] bool is_logging();
+
+// appends a record to this thread's ring buffer (wait-free), a no-op if no test is running
+// payload is the preformatted text if format is nullptr, otherwise the deferred arguments for format(fmt, payload)
+void write_log_record(
+    std::string_view fmt, log_formatter format, std::byte const* payload, std::uint32_t size, bool is_truncated);
+
+// arguments that are formatted later are copied bitwise, so they must not refer to anything
+template <class T>
+concept deferrable_log_arg = std::is_arithmetic_v<T> || std::is_enum_v<T>;
+
+template <class... Args>
+std::string format_log_args(std::string_view fmt, std::byte const* data)
+{
+    size_t offset = 0;
+    [[maybe_unused]] auto const read = [&]<class T>(std::type_identity<T>)
+    {
+        T value;
+        std::memcpy(&value, data + offset, sizeof(T));
+        offset += sizeof(T);
+        return value;
+    };
+    // braced initialization reads the arguments in order
+    std::tuple<Args...> args{read(std::type_identity<Args>{})...};
+    return std::apply([&](auto const&... a) { return std::vformat(fmt, std::make_format_args(a...)); }, args);
+}
+
+// attributes the records of all threads to a test while in scope (tests run one at a time, nested runs are restored)
+struct scoped_test_log
+{
+    scoped_test_log();
+    scoped_test_log(scoped_test_log&&) = delete;
+    scoped_test_log(scoped_test_log const&) = delete;
+    scoped_test_log& operator=(scoped_test_log&&) = delete;
+    scoped_test_log& operator=(scoped_test_log const&) = delete;
+    ~scoped_test_log();
+
+    // "[+1.250 ms] [thread 2] text" for every record of the test that is still buffered, in time order
+    [[nodiscard]] std::vector<std::string> collect() const;
+
+private:
+    std::uint64_t _test_id = 0;
+    std::uint64_t _previous_test_id = 0;
+    std::uint64_t _start_time = 0;
+};
+} // namespace nx::impl
+
+namespace nx
+{
+// std::format-style debug log of the current test, only reported if the test fails
+// cheap enough to stay enabled in hot and heavily concurrent code:
+// - arithmetic and enum arguments are copied and only formatted on failure
+// - anything else (e.g. strings) is formatted right away, truncated to 128 bytes
+//
+// usage:
+//   nx::log("worker {} took item {}", worker_id, item);
+template <class... Args>
+void log(std::format_string<Args...> fmt, Args&&... args)
+{
+    if (!impl::is_logging())
+        return;
+
+    std::byte payload[impl::log_record_payload_size];
+    constexpr auto deferred_size = (size_t(0) + ... + sizeof(std::remove_cvref_t<Args>));
+    if constexpr ((impl::deferrable_log_arg<std::remove_cvref_t<Args>> && ...)
+                  && deferred_size <= impl::log_record_payload_size)
+    {
+        size_t offset = 0;
+        ((std::memcpy(payload + offset, &args, sizeof(args)), offset += sizeof(args)), ...);
+        impl::write_log_record(fmt.get(), &impl::format_log_args<std::remove_cvref_t<Args>...>, payload,
+                               std::uint32_t(deferred_size), false);
+    }
+    else
+    {
+        auto const result = std::format_to_n(reinterpret_cast<char*>(payload), impl::log_record_payload_size, fmt,
+                                             std::forward<Args>(args)...);
+        auto const size = std::uint32_t(std::min<std::ptrdiff_t>(result.size, impl::log_record_payload_size));
+        impl::write_log_record(fmt.get(), nullptr, payload, size,
+                               result.size > std::ptrdiff_t(impl::log_record_payload_size));
+    }
+}
+} // namespace nx
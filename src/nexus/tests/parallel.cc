@@ -0,0 +1,171 @@
+#include "parallel.hh"
+
+#include <nexus/tests/execute.hh>
+#include <nexus/tests/trace.hh>
+
+#include <condition_variable>
+#include <deque>
+#include <format>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+std::atomic<int> g_configured_jobs = 0;
+
+struct worker_pool
+{
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    std::deque<std::move_only_function<void()>> tasks;
+    bool is_stopping = false;
+    std::vector<std::thread> threads;
+
+    explicit worker_pool(int thread_count)
+    {
+        threads.reserve(size_t(std::max(thread_count, 0)));
+        for (auto i = 0; i < thread_count; ++i)
+            threads.emplace_back([this, name = std::format("worker {}", i + 1)] { work(name); });
+    }
+
+    worker_pool(worker_pool&&) = delete;
+    worker_pool(worker_pool const&) = delete;
+    worker_pool& operator=(worker_pool&&) = delete;
+    worker_pool& operator=(worker_pool const&) = delete;
+
+    ~worker_pool()
+    {
+        {
+            auto lock = std::lock_guard(mutex);
+            is_stopping = true;
+        }
+        wakeup.notify_all();
+        for (auto& t : threads)
+            t.join();
+    }
+
+    void work(std::string const& name)
+    {
+        auto lock = std::unique_lock(mutex);
+        while (true)
+        {
+            wakeup.wait(lock, [&] { return is_stopping || !tasks.empty(); });
+            if (tasks.empty())
+                return; // stopping
+
+            auto task = std::move(tasks.front());
+            tasks.pop_front();
+            lock.unlock();
+
+            // tracing may start after the pool, so the track is named whenever a task runs
+            nx::impl::trace_set_thread_name(name);
+            task();
+            lock.lock();
+        }
+    }
+};
+
+worker_pool& shared_pool()
+{
+    // the calling thread also works while it waits, so the pool has one thread less than worker_count()
+    static worker_pool pool(nx::worker_count() - 1);
+    return pool;
+}
+} // namespace
+
+void nx::impl::configure_workers(int jobs) { g_configured_jobs.store(jobs, std::memory_order_relaxed); }
+
+int nx::worker_count()
+{
+    auto const jobs = g_configured_jobs.load(std::memory_order_relaxed);
+    return std::max(jobs > 0 ? jobs : int(std::thread::hardware_concurrency()), 1);
+}
+
+void nx::impl::submit_task(std::move_only_function<void()> task)
+{
+    auto& pool = shared_pool();
+    {
+        auto lock = std::lock_guard(pool.mutex);
+        pool.tasks.push_back(std::move(task));
+    }
+    pool.wakeup.notify_all(); // workers and waiting threads share the condition
+}
+
+void nx::impl::run_tasks_until(std::function<bool()> const& is_done)
+{
+    auto& pool = shared_pool();
+    auto lock = std::unique_lock(pool.mutex);
+    while (true)
+    {
+        pool.wakeup.wait(lock, [&] { return is_done() || !pool.tasks.empty(); });
+        if (is_done())
+            return;
+
+        auto task = std::move(pool.tasks.front());
+        pool.tasks.pop_front();
+        lock.unlock();
+        task();
+        lock.lock();
+    }
+}
+
+void nx::impl::notify_task_waiters()
+{
+    auto& pool = shared_pool();
+    {
+        // so that a waiter cannot miss the notification between evaluating is_done and sleeping
+        auto lock = std::lock_guard(pool.mutex);
+    }
+    pool.wakeup.notify_all();
+}
+
+std::exception_ptr nx::impl::run_task_body(void (*fn)(void*), void* userdata, std::source_location location)
+{
+    std::exception_ptr error;
+    auto captured = impl::run_captured(
+        [&]
+        {
+            try
+            {
+                fn(userdata);
+            }
+            catch (...)
+            {
+                // REQUIRE unwinds into run_captured, everything else is handed to the caller
+                if (impl::is_require_unwind(std::current_exception()))
+                    throw;
+                error = std::current_exception();
+            }
+        },
+        location);
+    impl::report_captured_checks(std::move(captured), {});
+    return error;
+}
+
+nx::task_group::~task_group()
+{
+    impl::run_tasks_until([this] { return _pending.load(std::memory_order_acquire) == 0; });
+}
+
+void nx::task_group::wait()
+{
+    impl::run_tasks_until([this] { return _pending.load(std::memory_order_acquire) == 0; });
+
+    auto lock = std::lock_guard(_error_mutex);
+    if (auto error = std::exchange(_error, nullptr))
+        std::rethrow_exception(error);
+}
+
+void nx::task_group::set_error(std::exception_ptr error)
+{
+    auto lock = std::lock_guard(_error_mutex);
+    if (_error == nullptr)
+        _error = std::move(error);
+}
+
+void nx::task_group::finish_task()
+{
+    if (_pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        impl::notify_task_waiters();
+}
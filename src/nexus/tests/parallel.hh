@@ -0,0 +1,166 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <source_location>
+#include <type_traits>
+#include <utility>
+
+namespace nx::impl
+{
+// one worker pool per process, shared by the runner and all tests (PROPERTY cases, nx::parallel_for, nx::task_group)
+// - threads that wait for their tasks run queued tasks meanwhile, so nested parallelism cannot run out of threads
+// - checks in tasks count for the current test (see report_captured_checks)
+// - REQUIRE in a task ends only that task (or that index of parallel_for), on the pool and on the waiting thread
+
+// sets the number of threads working on parallel tasks, including the waiting one (0: one per hardware thread)
+// only effective before the pool is first used
+void configure_workers(int jobs);
+
+// queues a task for the pool
+void submit_task(std::move_only_function<void()> task);
+
+// runs queued tasks until is_done() holds, sleeps while the queue is empty
+// is_done is evaluated with the pool locked, its state must be changed before calling notify_task_waiters
+void run_tasks_until(std::function<bool()> const& is_done);
+void notify_task_waiters();
+
+// runs fn under run_captured and reports its checks, so that a REQUIRE in fn only ends fn
+// other exceptions are not captured but returned, so the caller can propagate them
+[[nodiscard]] std::exception_ptr run_task_body(void (*fn)(void*), void* userdata, std::source_location location);
+
+template <class F>
+[[nodiscard]] std::exception_ptr run_task_body(F&& fn, std::source_location location)
+{
+    return impl::run_task_body([](void* f) { (*static_cast<std::remove_reference_t<F>*>(f))(); }, &fn, location);
+}
+} // namespace nx::impl
+
+namespace nx
+{
+// number of threads working on parallel tasks (the pool and the waiting thread), see -j / --jobs
+[[nodiscard]] int worker_count();
+
+// a set of tasks that run on the shared worker pool
+// - wait() helps with queued tasks instead of blocking, so tasks can use task_groups themselves
+// - the first exception thrown by a task is rethrown by wait(), the destructor waits but drops it
+// - a failed REQUIRE ends its task and is reported for the current test, it is not rethrown
+//
+// usage:
+//   nx::task_group group;
+//   group.run([&] { build_index(a); });
+//   group.run([&] { build_index(b); });
+//   group.wait();
+struct task_group
+{
+    task_group() = default;
+    task_group(task_group&&) = delete;
+    task_group(task_group const&) = delete;
+    task_group& operator=(task_group&&) = delete;
+    task_group& operator=(task_group const&) = delete;
+    ~task_group();
+
+    template <class F>
+    void run(F&& fn, std::source_location location = std::source_location::current())
+    {
+        _pending.fetch_add(1, std::memory_order_relaxed);
+        impl::submit_task(
+            [this, f = std::forward<F>(fn), location]() mutable
+            {
+                if (auto error = impl::run_task_body(f, location))
+                    set_error(std::move(error));
+                finish_task();
+            });
+    }
+
+    void wait();
+
+private:
+    void set_error(std::exception_ptr error);
+    void finish_task();
+
+    std::atomic<int> _pending = 0;
+    std::mutex _error_mutex;
+    std::exception_ptr _error;
+};
+
+// calls fn(i) for every i in [begin, end) on the shared worker pool (and the calling thread), in no particular order
+// - indices are claimed in chunks, so uneven costs per index balance out
+// - a failed REQUIRE ends only the call for its index, exceptions are rethrown after all workers stopped
+//
+// usage:
+//   nx::parallel_for(0, int(images.size()), [&](int i) { results[i] = process(images[i]); });
+template <std::integral I, class F>
+void parallel_for(I begin, I end, F&& fn, std::source_location location = std::source_location::current())
+{
+    if (!(begin < end))
+        return;
+
+    // unsigned arithmetic, so that ranges spanning more than half of a signed I cannot overflow
+    using U = std::make_unsigned_t<I>;
+    auto const count = std::uint64_t(U(U(end) - U(begin)));
+
+    // calls fn for the indices [first, last), a failed REQUIRE skips to the next index
+    auto const run_indices = [&](std::uint64_t first, std::uint64_t last)
+    {
+        auto k = first;
+        while (k < last)
+        {
+            auto error = impl::run_task_body(
+                [&]
+                {
+                    for (; k < last; ++k)
+                        fn(I(U(U(begin) + U(k))));
+                },
+                location);
+            if (error)
+                std::rethrow_exception(error);
+            ++k; // the index whose REQUIRE failed (or past last if all succeeded)
+        }
+    };
+
+    auto const workers = std::uint64_t(worker_count());
+    if (workers <= 1 || count == 1)
+    {
+        run_indices(0, count);
+        return;
+    }
+
+    // about 8 chunks per worker
+    auto const chunk = std::max<std::uint64_t>(1, count / (workers * 8));
+    std::atomic<std::uint64_t> next = 0;
+    auto const work = [&]
+    {
+        while (true)
+        {
+            auto const first = next.fetch_add(chunk, std::memory_order_relaxed);
+            if (first >= count)
+                return;
+            run_indices(first, std::min(first + chunk, count));
+        }
+    };
+
+    task_group group;
+    for (std::uint64_t t = 1; t < std::min(workers, (count + chunk - 1) / chunk); ++t)
+        group.run(work, location);
+
+    // tasks reference this frame, so they must finish before an exception of this thread leaves it
+    std::exception_ptr error;
+    try
+    {
+        work();
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+    }
+    group.wait();
+    if (error)
+        std::rethrow_exception(error);
+}
+} // namespace nx
@@ -0,0 +1,302 @@
+#include "profile.hh"
+
+#include <nexus/tests/crash.hh>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <format>
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#if (defined(__unix__) || defined(__APPLE__)) && __has_include(<execinfo.h>)
+#include <execinfo.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/time.h>
+#define NX_IMPL_HAS_SIGPROF 1
+#else
+#define NX_IMPL_HAS_SIGPROF 0
+#endif
+
+namespace
+{
+constexpr int max_profile_frames = 48;
+
+// ~30 s of samples at 1 kHz, allocated up front because the signal handler must not allocate
+constexpr size_t max_profile_samples = size_t(1) << 15;
+
+struct profile_sample
+{
+    std::atomic<bool> is_complete = false; // the timer may still fire while stop_profiling reads the samples
+    int label = 0;
+    bool is_other_thread = false; // the labels only describe the thread that runs the tests
+    int size = 0;
+    void* frames[max_profile_frames] = {};
+};
+
+std::atomic<bool> g_is_profiling = false;
+std::vector<profile_sample> g_samples;
+std::atomic<size_t> g_sample_count = 0;
+
+// label paths are interned, samples only store the id of the current path
+std::atomic<int> g_current_label = 0;
+std::vector<std::string> g_label_paths = {""};
+std::unordered_map<std::string, int> g_label_ids = {{"", 0}};
+std::vector<int> g_label_stack;
+
+int intern_label_path(std::string path)
+{
+    auto const [it, is_new] = g_label_ids.emplace(path, int(g_label_paths.size()));
+    if (is_new)
+        g_label_paths.push_back(std::move(path));
+    return it->second;
+}
+
+// ';' separates frames, the last ' ' the count, so neither may end up in names
+std::string folded_name(std::string_view name)
+{
+    std::string result(name);
+    for (auto& c : result)
+        if (c == ';')
+            c = ':';
+        else if (c == '\n' || c == '\r')
+            c = ' ';
+    return result;
+}
+
+// test names are free-form, file names are not
+std::string sanitize_file_name(std::string_view name)
+{
+    std::string result;
+    for (auto c : name)
+    {
+        auto const is_safe = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-'
+                          || c == '_' || c == '.';
+        result += is_safe ? c : '_';
+    }
+    return result;
+}
+
+// profile files written by this process, so that tests whose names sanitize to the same file name don't overwrite each other
+std::mutex g_profile_paths_mutex;
+std::set<std::filesystem::path> g_profile_paths;
+
+#if NX_IMPL_HAS_SIGPROF
+struct sigaction g_previous_action = {};
+
+// ITIMER_PROF measures the CPU time of the whole process, so SIGPROF arrives on whichever thread is running
+pthread_t g_profiled_thread = {};
+
+// the first backtrace call may allocate (loading the unwinder), which must not happen in the handler
+void warm_up_backtrace()
+{
+    static auto const is_warm = []
+    {
+        void* frames[1];
+        return backtrace(frames, 1) >= 0;
+    }();
+    (void)is_warm;
+}
+
+void handle_profile_signal(int)
+{
+    auto const saved_errno = errno;
+    auto const i = g_sample_count.fetch_add(1, std::memory_order_relaxed);
+    if (i < g_samples.size())
+    {
+        auto& sample = g_samples[i];
+        sample.label = g_current_label.load(std::memory_order_relaxed);
+        sample.is_other_thread = !pthread_equal(pthread_self(), g_profiled_thread);
+        sample.size = backtrace(sample.frames, max_profile_frames);
+        sample.is_complete.store(true, std::memory_order_release);
+    }
+    errno = saved_errno;
+}
+
+void set_profile_timer(int samples_per_second)
+{
+    itimerval timer = {};
+    if (samples_per_second > 0)
+    {
+        timer.it_interval.tv_usec = std::max(1'000'000 / samples_per_second, 1);
+        timer.it_value = timer.it_interval;
+    }
+    setitimer(ITIMER_PROF, &timer, nullptr);
+}
+#endif
+
+// frames of one sample from the outermost to the innermost
+// the test runner itself (main ... execute_tests) is dropped, the labels already say which test ran
+std::string fold_frames(std::span<nx::impl::crash_frame const> frames)
+{
+    auto end = frames.size();
+    for (size_t i = 0; i < frames.size(); ++i)
+        if (frames[i].function.starts_with("nx::execute_tests("))
+        {
+            end = i;
+            break;
+        }
+
+    std::string result;
+    std::string previous;
+    for (auto i = end; i-- > 0;)
+    {
+        auto const& frame = frames[i];
+        auto name = frame.function.empty() ? std::format("[{}]", frame.module.empty() ? "?" : frame.module)
+                                           : folded_name(frame.function);
+
+        // consecutive frames of stripped code are indistinguishable anyway
+        if (frame.function.empty() && name == previous)
+            continue;
+
+        if (!result.empty())
+            result += ';';
+        result += name;
+        previous = std::move(name);
+    }
+    return result;
+}
+} // namespace
+
+bool nx::impl::start_profiling(int samples_per_second)
+{
+#if NX_IMPL_HAS_SIGPROF
+    if (g_is_profiling || samples_per_second <= 0)
+        return false;
+
+    if (g_samples.size() != max_profile_samples)
+        g_samples = std::vector<profile_sample>(max_profile_samples);
+    g_sample_count = 0;
+    g_label_stack.clear();
+    g_current_label = 0;
+
+    g_profiled_thread = pthread_self();
+    warm_up_backtrace();
+
+    struct sigaction action = {};
+    action.sa_handler = handle_profile_signal;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGPROF, &action, &g_previous_action);
+
+    g_is_profiling = true;
+    set_profile_timer(samples_per_second);
+    return true;
+#else
+    (void)samples_per_second;
+    return false;
+#endif
+}
+
+nx::impl::profile_result nx::impl::stop_profiling()
+{
+    profile_result result;
+#if NX_IMPL_HAS_SIGPROF
+    if (!g_is_profiling)
+        return result;
+
+    set_profile_timer(0);
+    g_is_profiling = false;
+
+    auto const count = g_sample_count.exchange(g_samples.size(), std::memory_order_relaxed);
+    auto const recorded = std::min(count, g_samples.size());
+    result.dropped_samples = std::int64_t(count - recorded);
+
+    // many samples share return addresses, dladdr and demangling are the expensive part
+    std::unordered_map<void*, crash_frame> symbols;
+    std::vector<crash_frame> frames;
+    for (size_t i = 0; i < recorded; ++i)
+    {
+        auto& sample = g_samples[i];
+        if (!sample.is_complete.exchange(false, std::memory_order_acquire))
+            continue;
+
+        auto const raw = std::span<void* const>(sample.frames, size_t(std::max(sample.size, 0)));
+        frames.clear();
+        for (auto const address : raw.subspan(count_signal_handler_frames(raw, false)))
+        {
+            auto it = symbols.find(address);
+            if (it == symbols.end())
+                it = symbols.emplace(address, std::move(symbolize_frames({&address, 1}).front())).first;
+            frames.push_back(it->second);
+        }
+
+        auto stack = g_label_paths[sample.label];
+        if (sample.is_other_thread)
+            stack += stack.empty() ? "[other thread]" : ";[other thread]";
+        auto const folded = fold_frames(frames);
+        if (!stack.empty() && !folded.empty())
+            stack += ';';
+        stack += folded;
+        if (stack.empty())
+            stack = "[unknown]";
+
+        result.folded_stacks[stack] += 1;
+        result.samples += 1;
+    }
+
+    sigaction(SIGPROF, &g_previous_action, nullptr);
+#endif
+    return result;
+}
+
+bool nx::impl::is_profiling() { return g_is_profiling.load(std::memory_order_relaxed); }
+
+void nx::impl::profile_push_label(std::string_view label)
+{
+    if (!is_profiling())
+        return;
+
+    auto path = g_label_paths[g_label_stack.empty() ? 0 : g_label_stack.back()];
+    if (!path.empty())
+        path += ';';
+    path += folded_name(label);
+
+    auto const id = intern_label_path(std::move(path));
+    g_label_stack.push_back(id);
+    g_current_label.store(id, std::memory_order_relaxed);
+}
+
+void nx::impl::profile_pop_label()
+{
+    if (g_label_stack.empty())
+        return; // pushed before profiling started
+
+    g_label_stack.pop_back();
+    g_current_label.store(g_label_stack.empty() ? 0 : g_label_stack.back(), std::memory_order_relaxed);
+}
+
+void nx::impl::write_folded_stacks(std::ostream& out, profile_result const& result)
+{
+    for (auto const& [stack, count] : result.folded_stacks)
+        out << stack << ' ' << count << '\n';
+}
+
+std::filesystem::path nx::impl::write_test_profile(std::filesystem::path const& dir,
+                                                   std::string_view test_name,
+                                                   profile_result const& result)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+
+    // e.g. "a/b" and "a?b" both become "a_b", the second one is written to "a_b-2.folded"
+    auto const name = sanitize_file_name(test_name);
+    auto path = dir / (name + ".folded");
+    {
+        auto lock = std::lock_guard(g_profile_paths_mutex);
+        for (auto i = 2; !g_profile_paths.insert(path).second; ++i)
+            path = dir / std::format("{}-{}.folded", name, i);
+    }
+
+    std::ofstream out(path);
+    if (!out)
+        return {};
+
+    write_folded_stacks(out, result);
+    return path;
+}
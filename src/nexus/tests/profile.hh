@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <string_view>
+
+namespace nx::impl
+{
+// sampling profiler behind --profile (SIGPROF on the CPU time of the process)
+// - every sample is attributed to the label stack at that time (test, sections, benchmarks)
+// - the labels are those of the thread that runs the tests, samples of other threads
+//   (e.g. the worker pool) additionally get an "[other thread]" frame below them
+// - functions without exported symbols are shown as [module], link with -rdynamic (ENABLE_EXPORTS) for names
+// - forked processes (fuzz workers) are not sampled
+
+struct profile_result
+{
+    // "label;...;outer frame;...;inner frame" -> number of samples
+    std::map<std::string, std::int64_t> folded_stacks;
+    std::int64_t samples = 0;
+    std::int64_t dropped_samples = 0; // sample buffer was full
+};
+
+// returns false if the profiler is already running (e.g. for nested test runs) or not supported
+bool start_profiling(int samples_per_second);
+
+// stops sampling and symbolizes the samples since start_profiling
+[[nodiscard]] profile_result stop_profiling();
+
+[[nodiscard]] bool is_profiling();
+
+// label stack that samples are attributed to, only to be used from the thread that runs the tests
+// no-ops unless profiling
+void profile_push_label(std::string_view label);
+void profile_pop_label();
+
+struct scoped_profile_label
+{
+    explicit scoped_profile_label(std::string_view label) { profile_push_label(label); }
+    scoped_profile_label(scoped_profile_label&&) = delete;
+    scoped_profile_label(scoped_profile_label const&) = delete;
+    scoped_profile_label& operator=(scoped_profile_label&&) = delete;
+    scoped_profile_label& operator=(scoped_profile_label const&) = delete;
+    ~scoped_profile_label() { profile_pop_label(); }
+};
+
+// one "stack count" line per folded stack, the input format of flamegraph.pl, inferno, and speedscope
+void write_folded_stacks(std::ostream& out, profile_result const& result);
+
+// writes the profile of a test to <dir>/<test name>.folded (creating dir), returns the path or empty on error
+// test names that map to a file already written by this process get a "-2", "-3", ... suffix
+std::filesystem::path write_test_profile(std::filesystem::path const& dir,
+                                         std::string_view test_name,
+                                         profile_result const& result);
+
+} // namespace nx::impl
@@ -0,0 +1,101 @@
+#include "property.hh"
+
+#include <nexus/tests/check.hh>
+#include <nexus/tests/hash.hh>
+#include <nexus/tests/parallel.hh>
+#include <nexus/tests/registry.hh>
+#include <nexus/tests/trace.hh>
+
+#include <atomic>
+
+nx::impl::property_settings nx::impl::current_property_settings(std::string_view property_name)
+{
+    auto const& config = impl::current_schedule_config();
+
+    property_settings settings;
+    settings.cases = std::max(config.property_cases, 1);
+    settings.jobs = config.property_jobs > 0 ? config.property_jobs : worker_count();
+
+    // an explicit seed applies to all properties of the test, the name still distinguishes them
+    auto const declaration = impl::current_test_declaration();
+    if (declaration != nullptr && declaration->test_config.seed != 0)
+        settings.seed = fnv1a(property_name, std::uint64_t(declaration->test_config.seed));
+    else
+        settings.seed = fnv1a(property_name, fnv1a(declaration != nullptr ? declaration->name : ""));
+
+    return settings;
+}
+
+int nx::impl::find_first_failing_case(int count, int jobs, std::function<bool(int)> const& is_failing)
+{
+    if (jobs <= 1 || count <= 1)
+    {
+        auto const _trace = trace_scope("cases", "property");
+        for (auto i = 0; i < count; ++i)
+            if (is_failing(i))
+                return i;
+        return -1;
+    }
+
+    // cases are claimed in order, so once a failure is known, all later cases can be skipped
+    // every case before the smallest failing one is still evaluated, which makes the result independent of jobs
+    std::atomic<int> next_case = 0;
+    std::atomic<int> first_failing = count;
+    auto const work = [&]
+    {
+        auto const _trace = trace_scope("cases", "property");
+        while (true)
+        {
+            auto const i = next_case.fetch_add(1);
+            if (i >= first_failing.load())
+                return;
+
+            if (is_failing(i))
+            {
+                auto known = first_failing.load();
+                while (i < known && !first_failing.compare_exchange_weak(known, i))
+                {
+                }
+            }
+        }
+    };
+
+    // the cases run on the shared worker pool, so jobs only bounds their parallelism
+    {
+        task_group group;
+        for (auto j = 1; j < std::min(jobs, count); ++j)
+            group.run(work);
+        work();
+        group.wait();
+    }
+
+    return first_failing == count ? -1 : first_failing.load();
+}
+
+void nx::impl::report_property_result(std::string_view name,
+                                      std::source_location location,
+                                      std::optional<captured_checks> counterexample,
+                                      std::vector<std::string> const& extra_lines)
+{
+    auto const expr = std::format("PROPERTY(\"{}\")", name);
+    if (!counterexample.has_value())
+    {
+        impl::report_check_result(check_kind::check, cmp_op::none, expr, true, {}, location);
+        return;
+    }
+
+    // a property that fails randomly may pass again for the shrunk input
+    if (!counterexample->is_failing())
+    {
+        counterexample->executed_checks += 1;
+        counterexample->failed_checks += 1;
+        counterexample->errors.push_back(test_error{
+            .expr = expr,
+            .location = location,
+            .extra_lines = {"the property is probably non-deterministic"},
+            .expanded = "property failed, but passed when the counterexample was replayed",
+        });
+    }
+
+    impl::report_captured_checks(std::move(*counterexample), extra_lines);
+}
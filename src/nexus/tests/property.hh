@@ -0,0 +1,464 @@
+#pragma once
+
+#include <nexus/tests/crash.hh>
+#include <nexus/tests/execute.hh>
+#include <nexus/tests/hash.hh>
+#include <nexus/tests/trace.hh>
+
+#include <clean-core/to_debug_string.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace nx::gen
+{
+// deterministic PRNG handed to generators (splitmix64)
+struct rng
+{
+    std::uint64_t state = 0;
+
+    std::uint64_t next() { return impl::splitmix64_next(state); }
+
+    // uniform in [0, n), n must be > 0
+    std::uint64_t below(std::uint64_t n) { return next() % n; }
+
+    bool one_in(std::uint64_t n) { return below(n) == 0; }
+
+    // uniform in [0, 1)
+    double uniform01() { return double(next() >> 11) * 0x1.0p-53; }
+};
+
+// a generator produces random values and proposes simpler variants of a value
+// - generate: a new random value, only depends on the rng state
+// - shrink: calls accept(candidate) with simpler candidates (simplest first) until accept returns true
+//           returns true if a candidate was accepted
+//           every candidate must be strictly simpler than value, otherwise shrinking may not terminate
+template <class G>
+concept generator = requires(G const& g, rng& r, typename G::value_type const& value) {
+    { g.generate(r) } -> std::convertible_to<typename G::value_type>;
+    { g.shrink(value, [](typename G::value_type const&) { return false; }) } -> std::same_as<bool>;
+};
+
+template <std::integral T>
+struct integer_generator
+{
+    using value_type = T;
+
+    T min;
+    T max;
+
+    T generate(rng& r) const
+    {
+        using U = std::make_unsigned_t<T>;
+
+        // boundaries and small values find most bugs, so they are generated more often than uniform would
+        auto const t = target();
+        if (r.one_in(8))
+        {
+            T const specials[] = {min, max, t};
+            return specials[r.below(std::size(specials))];
+        }
+        if (r.one_in(2))
+        {
+            auto const lo = U(U(t) - U(min)) > 100 ? T(t - 100) : min;
+            auto const hi = U(U(max) - U(t)) > 100 ? T(t + 100) : max;
+            return uniform(r, lo, hi);
+        }
+        return uniform(r, min, max);
+    }
+
+    // candidates approach value from the target: target, value - d/2, value - d/4, ..., value -+ 1
+    template <class Accept>
+    bool shrink(T const& value, Accept&& accept) const
+    {
+        using U = std::make_unsigned_t<T>;
+
+        auto const t = target();
+        if (value == t)
+            return false;
+
+        auto const is_above = value > t;
+        auto const diff = is_above ? U(U(value) - U(t)) : U(U(t) - U(value));
+        for (auto d = diff; d > 0; d /= 2)
+            if (accept(is_above ? T(U(value) - d) : T(U(value) + d)))
+                return true;
+        return false;
+    }
+
+private:
+    // closest value to zero
+    T target() const { return std::clamp<T>(T(0), min, max); }
+
+    static T uniform(rng& r, T lo, T hi)
+    {
+        using U = std::make_unsigned_t<T>;
+        auto const span = std::uint64_t(U(U(hi) - U(lo))) + 1; // 0 if the full 64 bit range
+        auto const offset = span == 0 ? r.next() : r.below(span);
+        return T(U(U(lo) + U(offset)));
+    }
+};
+
+template <std::floating_point T>
+struct floating_generator
+{
+    using value_type = T;
+
+    T min;
+    T max;
+
+    T generate(rng& r) const
+    {
+        if (r.one_in(8))
+        {
+            T const specials[] = {min, max, target(), std::clamp<T>(T(1), min, max), std::clamp<T>(T(-1), min, max)};
+            return specials[r.below(std::size(specials))];
+        }
+
+        // interpolation instead of min + u * (max - min), which can overflow
+        auto const u = T(r.uniform01());
+        return std::clamp<T>(min * (1 - u) + max * u, min, max);
+    }
+
+    // candidates: target, integral part, then value moved towards the target by d/2, d/4, ...
+    template <class Accept>
+    bool shrink(T const& value, Accept&& accept) const
+    {
+        constexpr int max_halvings = 16;
+
+        auto const t = target();
+        if (value == t || std::isnan(value))
+            return false;
+
+        if (accept(t))
+            return true;
+
+        auto const integral = std::trunc(value);
+        if (integral != value && integral >= min && integral <= max && accept(integral))
+            return true;
+
+        for (auto i = 1; i <= max_halvings; ++i)
+        {
+            auto const candidate = T(value - (value - t) / T(1 << i));
+            if (candidate != value && candidate != t && accept(candidate))
+                return true;
+        }
+        return false;
+    }
+
+private:
+    T target() const { return std::clamp<T>(T(0), min, max); }
+};
+
+struct boolean_generator
+{
+    using value_type = bool;
+
+    bool generate(rng& r) const { return r.one_in(2); }
+
+    template <class Accept>
+    bool shrink(bool const& value, Accept&& accept) const
+    {
+        return value && accept(false);
+    }
+};
+
+namespace detail
+{
+// shrinks a sequence by removing chunks (halves first, then smaller), then by shrinking single elements
+// large counterexamples thus lose most of their elements in a logarithmic number of steps
+template <class Container, class ShrinkElement, class Accept>
+bool shrink_sequence(Container const& value, size_t min_size, ShrinkElement&& shrink_element, Accept&& accept)
+{
+    auto const size = value.size();
+    if (size > min_size)
+    {
+        if (accept(Container(value.begin(), value.begin() + std::ptrdiff_t(min_size))))
+            return true;
+
+        for (auto chunk = (size - min_size) / 2; chunk > 0; chunk /= 2)
+            for (size_t start = 0; start + chunk <= size; start += chunk)
+            {
+                Container candidate;
+                candidate.reserve(size - chunk);
+                candidate.insert(candidate.end(), value.begin(), value.begin() + std::ptrdiff_t(start));
+                candidate.insert(candidate.end(), value.begin() + std::ptrdiff_t(start + chunk), value.end());
+                if (accept(candidate))
+                    return true;
+            }
+    }
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        auto const accepted = shrink_element(value[i],
+                                             [&](auto const& element)
+                                             {
+                                                 auto candidate = value;
+                                                 candidate[i] = element;
+                                                 return accept(candidate);
+                                             });
+        if (accepted)
+            return true;
+    }
+
+    return false;
+}
+} // namespace detail
+
+template <generator G>
+struct vector_generator
+{
+    using value_type = std::vector<typename G::value_type>;
+
+    G element;
+    size_t min_size;
+    size_t max_size;
+
+    value_type generate(rng& r) const
+    {
+        auto const size = min_size + size_t(r.below(max_size - min_size + 1));
+        value_type result;
+        result.reserve(size);
+        for (size_t i = 0; i < size; ++i)
+            result.push_back(element.generate(r));
+        return result;
+    }
+
+    template <class Accept>
+    bool shrink(value_type const& value, Accept&& accept) const
+    {
+        return detail::shrink_sequence(
+            value, min_size, [&](auto const& e, auto&& accept_element) { return element.shrink(e, accept_element); }, accept);
+    }
+};
+
+// printable ASCII, shrinks towards shorter strings of 'a'
+struct string_generator
+{
+    using value_type = std::string;
+
+    size_t min_size;
+    size_t max_size;
+
+    std::string generate(rng& r) const
+    {
+        auto const size = min_size + size_t(r.below(max_size - min_size + 1));
+        std::string result(size, ' ');
+        for (auto& c : result)
+            c = char(' ' + r.below('~' - ' ' + 1));
+        return result;
+    }
+
+    template <class Accept>
+    bool shrink(std::string const& value, Accept&& accept) const
+    {
+        return detail::shrink_sequence(
+            value, min_size, [](char c, auto&& accept_char) { return c != 'a' && accept_char('a'); }, accept);
+    }
+};
+
+template <generator... Gs>
+struct tuple_generator
+{
+    using value_type = std::tuple<typename Gs::value_type...>;
+
+    std::tuple<Gs...> generators;
+
+    value_type generate(rng& r) const
+    {
+        // braced init guarantees left-to-right evaluation, i.e. a deterministic rng sequence
+        return std::apply([&](auto const&... g) { return value_type{g.generate(r)...}; }, generators);
+    }
+
+    // shrinks one component at a time, the others stay fixed
+    template <class Accept>
+    bool shrink(value_type const& value, Accept&& accept) const
+    {
+        return shrink_component(value, accept, std::index_sequence_for<Gs...>{});
+    }
+
+private:
+    template <class Accept, size_t... I>
+    bool shrink_component(value_type const& value, Accept& accept, std::index_sequence<I...>) const
+    {
+        return (std::get<I>(generators).shrink(std::get<I>(value),
+                                               [&](auto const& component)
+                                               {
+                                                   auto candidate = value;
+                                                   std::get<I>(candidate) = component;
+                                                   return accept(candidate);
+                                               })
+                || ...);
+    }
+};
+
+// integers in [min, max], biased towards boundaries and small values, shrink towards 0
+template <std::integral T = int>
+integer_generator<T> integer(T min = std::numeric_limits<T>::lowest(), T max = std::numeric_limits<T>::max())
+{
+    return {.min = min, .max = max};
+}
+
+// finite floats in [min, max], shrink towards 0 and integral values
+template <std::floating_point T = double>
+floating_generator<T> floating(T min = T(-1e6), T max = T(1e6))
+{
+    return {.min = min, .max = max};
+}
+
+inline boolean_generator boolean() { return {}; }
+
+template <generator G>
+vector_generator<G> vector(G element, size_t min_size = 0, size_t max_size = 64)
+{
+    return {.element = std::move(element), .min_size = min_size, .max_size = max_size};
+}
+
+inline string_generator string(size_t min_size = 0, size_t max_size = 32)
+{
+    return {.min_size = min_size, .max_size = max_size};
+}
+} // namespace nx::gen
+
+namespace nx::impl
+{
+struct property_settings
+{
+    std::uint64_t seed = 0;
+    int cases = 100;
+    int jobs = 1;
+};
+
+// seed (from nx::config::seed or derived from the test and property name), case count, and parallelism
+property_settings current_property_settings(std::string_view property_name);
+
+// evaluates cases [0, count) and returns the index of the first failing one (-1 if none fails)
+// - with jobs > 1, cases are evaluated on multiple threads, is_failing must be thread-safe then
+// - the result does not depend on jobs
+int find_first_failing_case(int count, int jobs, std::function<bool(int)> const& is_failing);
+
+// reports a passing property (no replay) or the replayed counterexample as result of the current test
+void report_property_result(std::string_view name,
+                            std::source_location location,
+                            std::optional<captured_checks> counterexample,
+                            std::vector<std::string> const& extra_lines);
+
+template <class... Ts>
+std::string describe_counterexample(std::tuple<Ts...> const& args)
+{
+    std::string result;
+    std::apply([&](auto const&... arg)
+               { ((result += std::format("{}{}", result.empty() ? "" : ", ", cc::to_debug_string(arg))), ...); },
+               args);
+    return sizeof...(Ts) == 1 ? result : "(" + result + ")";
+}
+
+template <gen::generator... Gs>
+struct property_runner
+{
+    // upper bound on property evaluations while shrinking, keeps slow properties from shrinking forever
+    static constexpr int max_shrink_evaluations = 10'000;
+
+    std::string name;
+    std::source_location location;
+    gen::tuple_generator<Gs...> generator;
+
+    template <class Fn>
+    void operator=(Fn&& fn) // NOLINT(misc-unconventional-assign-operator,cppcoreguidelines-c-copy-assignment-signature)
+    {
+        using value_type = typename gen::tuple_generator<Gs...>::value_type;
+        static_assert(requires(value_type const& args) { std::apply(fn, args); },
+                      "PROPERTY body must take one parameter per generator");
+
+        auto const settings = impl::current_property_settings(name);
+        auto const _trace = trace_scope(std::format("PROPERTY(\"{}\")", name), "property");
+
+        // every case has its own rng so that cases can be generated independently (and in parallel)
+        auto const make_case = [&](int index)
+        {
+            auto r = gen::rng{.state = settings.seed ^ (std::uint64_t(index + 1) * 0xd1b54a32d192ed03ull)};
+            return generator.generate(r);
+        };
+        auto const run = [&](value_type const& args)
+        {
+            auto _ = impl::scoped_crash_context(
+                [&] { return std::format("PROPERTY(\"{}\") with {}", name, describe_counterexample(args)); });
+            return impl::run_captured([&] { std::apply(fn, args); }, location);
+        };
+
+        auto const first_failing = impl::find_first_failing_case(settings.cases, settings.jobs,
+                                                                 [&](int i) { return run(make_case(i)).is_failing(); });
+        if (first_failing < 0)
+        {
+            impl::report_property_result(name, location, std::nullopt, {});
+            return;
+        }
+
+        // greedy shrinking: take the first simpler candidate that still fails, until no candidate fails
+        auto const _trace_shrink = trace_scope("shrink", "property");
+        auto counterexample = make_case(first_failing);
+        auto steps = 0;
+        auto evaluations = 0;
+        while (evaluations < max_shrink_evaluations)
+        {
+            std::optional<value_type> simpler;
+            generator.shrink(counterexample,
+                             [&](value_type const& candidate)
+                             {
+                                 if (++evaluations > max_shrink_evaluations)
+                                     return true; // budget exhausted, stops this round without a result
+                                 if (!run(candidate).is_failing())
+                                     return false;
+                                 simpler = candidate;
+                                 return true;
+                             });
+            if (!simpler)
+                break;
+
+            counterexample = std::move(*simpler);
+            ++steps;
+        }
+
+        impl::report_property_result(name, location, run(counterexample),
+                                     {
+                                         std::format("counterexample: {}", describe_counterexample(counterexample)),
+                                         std::format("shrunk from case {} of {} in {} steps (seed {})", first_failing,
+                                                     settings.cases, steps, settings.seed),
+                                     });
+    }
+};
+
+template <gen::generator... Gs>
+property_runner<Gs...> make_property_runner(std::string name, std::source_location location, Gs... generators)
+{
+    return {.name = std::move(name), .location = location, .generator = {.generators = {std::move(generators)...}}};
+}
+} // namespace nx::impl
+
+// PROPERTY macro: checks a property for many generated inputs inside a TEST
+// - one body parameter per generator (see nx::gen), inputs are deterministic per test (see nx::config::seed)
+// - the first failing input is shrunk to a minimal counterexample, which is reported with the failing checks
+// - counts as a single passing check if all cases pass
+// - with --property-jobs, cases run on multiple threads, so the body must be thread-safe then
+//
+// usage:
+//   PROPERTY("reverse is an involution", nx::gen::vector(nx::gen::integer<int>()))(std::vector<int> v)
+//   {
+//       auto r = v;
+//       std::ranges::reverse(r);
+//       std::ranges::reverse(r);
+//       CHECK(r == v);
+//   };
+#define PROPERTY(name, ...) ::nx::impl::make_property_runner(name, std::source_location::current(), __VA_ARGS__) = [&]
@@ -0,0 +1,377 @@
+#pragma once
+
+#include <nexus/tests/check.hh>
+
+#include <clean-core/to_debug_string.hh>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <limits>
+#include <ranges>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace nx
+{
+// element-wise tolerance of CHECK_RANGE_APPROX, an element passes if it is within any of them
+// - exactly equal elements always pass, NaN never does
+// - rel is relative to the larger magnitude of the two elements
+// - ulps is the distance in representable values (units in the last place)
+struct approx_tolerance
+{
+    double abs = 0.0;
+    double rel = 0.0;
+    std::int64_t ulps = 0;
+};
+} // namespace nx
+
+namespace nx::impl
+{
+// at most this many offending indices are listed in a failed range check
+constexpr size_t max_reported_range_mismatches = 8;
+
+// a range check compares blocks of this many elements branch-free (vectorizable)
+// and only rescans blocks that contain a mismatch element by element
+constexpr size_t range_check_block_size = 1024;
+
+struct range_mismatches
+{
+    size_t count = 0;
+    std::vector<size_t> first_indices; // at most max_reported_range_mismatches
+};
+
+// is_mismatch(i) must be cheap and side-effect free, it is evaluated twice for blocks with mismatches
+template <class F>
+range_mismatches find_range_mismatches(size_t size, F&& is_mismatch)
+{
+    range_mismatches result;
+    for (size_t start = 0; start < size; start += range_check_block_size)
+    {
+        auto const end = std::min(size, start + range_check_block_size);
+
+        // no early exit and no branches, so the compiler can vectorize the common (passing) case
+        // full blocks have a constant trip count, which GCC's -O2 cost model requires
+        unsigned char any_mismatch = 0;
+        if (end - start == range_check_block_size)
+            for (size_t j = 0; j < range_check_block_size; ++j)
+                any_mismatch |= static_cast<unsigned char>(is_mismatch(start + j));
+        else
+            for (auto i = start; i < end; ++i)
+                any_mismatch |= static_cast<unsigned char>(is_mismatch(i));
+        if (!any_mismatch)
+            continue;
+
+        for (auto i = start; i < end; ++i)
+            if (is_mismatch(i))
+            {
+                ++result.count;
+                if (result.first_indices.size() < max_reported_range_mismatches)
+                    result.first_indices.push_back(i);
+            }
+    }
+    return result;
+}
+
+// builds the failure report and hands it to the usual CHECK/REQUIRE reporting
+// describe(i) formats the offending element i
+template <class F>
+check_handle report_range_check(check_kind kind,
+                                char const* expr_text,
+                                std::source_location location,
+                                std::string summary,
+                                range_mismatches const& mismatches,
+                                F&& describe)
+{
+    auto const passed = summary.empty() && mismatches.count == 0;
+    std::vector<std::string> lines;
+    if (!passed)
+    {
+        if (!summary.empty())
+            lines.push_back(std::move(summary));
+        for (auto i : mismatches.first_indices)
+            lines.push_back(describe(i));
+        if (mismatches.count > mismatches.first_indices.size())
+            lines.push_back(std::format("... and {} more", mismatches.count - mismatches.first_indices.size()));
+    }
+    return check_handle::make(kind, cmp_op::none, expr_text, passed, location, std::move(lines));
+}
+
+template <std::ranges::contiguous_range A, std::ranges::contiguous_range B>
+    requires std::ranges::sized_range<A> && std::ranges::sized_range<B>
+check_handle check_range_eq(check_kind kind, char const* expr_text, A const& a, B const& b, std::source_location location)
+{
+    auto const* pa = std::ranges::data(a);
+    auto const* pb = std::ranges::data(b);
+    auto const size_a = size_t(std::ranges::size(a));
+    auto const size_b = size_t(std::ranges::size(b));
+
+    // elements beyond the shorter range are covered by the size mismatch
+    auto const mismatches = find_range_mismatches(std::min(size_a, size_b), [&](size_t i) { return !(pa[i] == pb[i]); });
+
+    std::string summary;
+    if (size_a != size_b)
+        summary = std::format("sizes differ: {} != {}", size_a, size_b);
+    else if (mismatches.count > 0)
+        summary = std::format("{} of {} elements differ", mismatches.count, size_a);
+    if (size_a != size_b && mismatches.count > 0)
+        summary += std::format(", {} of the first {} elements differ", mismatches.count, std::min(size_a, size_b));
+
+    return report_range_check(kind, expr_text, location, std::move(summary), mismatches, [&](size_t i)
+                              { return std::format("[{}]: {} != {}", i, debug_string(pa[i]), debug_string(pb[i])); });
+}
+
+template <std::ranges::contiguous_range R, class T>
+    requires std::ranges::sized_range<R>
+check_handle check_range_all_eq(check_kind kind, char const* expr_text, R const& range, T const& value, std::source_location location)
+{
+    auto const* p = std::ranges::data(range);
+    auto const size = size_t(std::ranges::size(range));
+    auto const mismatches = find_range_mismatches(size, [&](size_t i) { return !(p[i] == value); });
+
+    auto summary = mismatches.count == 0 ? std::string()
+                                         : std::format("{} of {} elements are not {}", mismatches.count, size,
+                                                       debug_string(value));
+    return report_range_check(kind, expr_text, location, std::move(summary), mismatches,
+                              [&](size_t i) { return std::format("[{}]: {}", i, debug_string(p[i])); });
+}
+
+// inclusive bounds: lo <= element <= hi
+// lo and hi may have different types, e.g. CHECK_RANGE_WITHIN(weights, 0, 1.0f)
+template <std::ranges::contiguous_range R, class Lo, class Hi>
+    requires std::ranges::sized_range<R>
+check_handle check_range_within(check_kind kind,
+                                char const* expr_text,
+                                R const& range,
+                                Lo const& lo,
+                                Hi const& hi,
+                                std::source_location location)
+{
+    auto const* p = std::ranges::data(range);
+    auto const size = size_t(std::ranges::size(range));
+
+    // NaN is outside of every range
+    auto const mismatches = find_range_mismatches(size, [&](size_t i) { return !(lo <= p[i]) | !(p[i] <= hi); });
+
+    auto summary = mismatches.count == 0 ? std::string()
+                                         : std::format("{} of {} elements are outside [{}, {}]", mismatches.count, size,
+                                                       debug_string(lo), debug_string(hi));
+    return report_range_check(kind, expr_text, location, std::move(summary), mismatches,
+                              [&](size_t i) { return std::format("[{}]: {}", i, debug_string(p[i])); });
+}
+
+// non-descending order (by operator<), equal neighbors are fine
+template <std::ranges::contiguous_range R>
+    requires std::ranges::sized_range<R>
+check_handle check_range_sorted(check_kind kind, char const* expr_text, R const& range, std::source_location location)
+{
+    auto const* p = std::ranges::data(range);
+    auto const size = size_t(std::ranges::size(range));
+    auto const pairs = size > 0 ? size - 1 : 0;
+    auto const mismatches = find_range_mismatches(pairs, [&](size_t i) { return p[i + 1] < p[i]; });
+
+    auto summary = mismatches.count == 0 ? std::string()
+                                         : std::format("{} of {} adjacent pairs are out of order", mismatches.count, pairs);
+    return report_range_check(kind, expr_text, location, std::move(summary), mismatches, [&](size_t i)
+                              { return std::format("[{}] > [{}]: {} > {}", i, i + 1, debug_string(p[i]), debug_string(p[i + 1])); });
+}
+
+// floats in an integer order, so that the distance of two values is the number of representable values between them
+// -0.0 and +0.0 both map to 0
+template <std::floating_point T>
+auto ulp_ordered(T x)
+{
+    using I = std::conditional_t<sizeof(T) == 4, std::int32_t, std::int64_t>;
+    static_assert(sizeof(I) == sizeof(T), "unsupported floating point type");
+    auto const i = std::bit_cast<I>(x);
+    return i < 0 ? I(std::numeric_limits<I>::min() - i) : i;
+}
+
+// unsigned of the same width as T, so that the comparison in the vectorized scan does not widen
+template <std::floating_point T>
+auto ulp_distance(T a, T b)
+{
+    using U = std::make_unsigned_t<decltype(ulp_ordered(a))>;
+    auto const ia = ulp_ordered(a);
+    auto const ib = ulp_ordered(b);
+    return ia > ib ? U(U(ia) - U(ib)) : U(U(ib) - U(ia));
+}
+
+// statistics over all elements, only computed for the report of a failed check
+template <std::floating_point T>
+std::vector<std::string> approx_error_statistics(T const* a, T const* b, size_t size)
+{
+    // bucket i holds distances up to ulp_bucket_limits[i]
+    constexpr std::array<std::uint64_t, 6> ulp_bucket_limits = {0, 1, 4, 16, 256, 65536};
+    constexpr std::array<char const*, 8> ulp_bucket_names = {"0", "1", "2-4", "5-16", "17-256", "257-65536", ">65536", "NaN"};
+    std::array<size_t, 8> ulp_histogram = {};
+
+    double max_abs = 0.0;
+    double max_rel = 0.0;
+    size_t max_abs_index = 0;
+    size_t max_rel_index = 0;
+    size_t compared = 0;
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (std::isnan(a[i]) || std::isnan(b[i]))
+        {
+            ++ulp_histogram.back();
+            continue;
+        }
+        ++compared;
+
+        auto const ulps = std::uint64_t(ulp_distance(a[i], b[i]));
+        auto bucket = ulp_bucket_limits.size();
+        for (size_t k = 0; k < ulp_bucket_limits.size(); ++k)
+            if (ulps <= ulp_bucket_limits[k])
+            {
+                bucket = k;
+                break;
+            }
+        ++ulp_histogram[bucket];
+
+        auto const abs_error = std::abs(double(a[i]) - double(b[i]));
+        auto const magnitude = std::max(std::abs(double(a[i])), std::abs(double(b[i])));
+        auto const rel_error = magnitude > 0.0 ? abs_error / magnitude : 0.0;
+        if (abs_error > max_abs)
+        {
+            max_abs = abs_error;
+            max_abs_index = i;
+        }
+        if (rel_error > max_rel)
+        {
+            max_rel = rel_error;
+            max_rel_index = i;
+        }
+    }
+
+    // nothing to report for an empty overlap (e.g. one side empty), the indices would be out of bounds
+    std::vector<std::string> lines;
+    if (compared > 0)
+    {
+        lines.push_back(std::format("max abs error {} at [{}]: {} vs {}", max_abs, max_abs_index, a[max_abs_index], b[max_abs_index]));
+        lines.push_back(std::format("max rel error {} at [{}]: {} vs {}", max_rel, max_rel_index, a[max_rel_index], b[max_rel_index]));
+    }
+    if (size == 0)
+        return lines;
+
+    std::string histogram = "ulp distances:";
+    for (size_t k = 0; k < ulp_histogram.size(); ++k)
+        if (ulp_histogram[k] > 0)
+            histogram += std::format(" {}: {},", ulp_bucket_names[k], ulp_histogram[k]);
+    histogram.pop_back();
+    lines.push_back(std::move(histogram));
+    return lines;
+}
+
+template <std::ranges::contiguous_range A, std::ranges::contiguous_range B>
+    requires std::ranges::sized_range<A> && std::ranges::sized_range<B>
+          && std::floating_point<std::ranges::range_value_t<A>>
+          && std::same_as<std::ranges::range_value_t<A>, std::ranges::range_value_t<B>>
+check_handle check_range_approx(check_kind kind,
+                                char const* expr_text,
+                                A const& a,
+                                B const& b,
+                                approx_tolerance const& tolerance,
+                                std::source_location location)
+{
+    using T = std::ranges::range_value_t<A>;
+    auto const* pa = std::ranges::data(a);
+    auto const* pb = std::ranges::data(b);
+    auto const size_a = size_t(std::ranges::size(a));
+    auto const size_b = size_t(std::ranges::size(b));
+    auto const size = std::min(size_a, size_b);
+
+    // in the element type and without branches, so that the scan vectorizes (double needs 64 bit compares, e.g. SSE4.2)
+    // only the ulp distance is skipped for elements that are already within abs or rel
+    auto const abs_tolerance = T(tolerance.abs);
+    auto const rel_tolerance = T(tolerance.rel);
+    using U = decltype(ulp_distance(T(), T()));
+    auto const ulp_tolerance = U(std::min<std::uint64_t>(std::max<std::int64_t>(tolerance.ulps, 0), std::numeric_limits<U>::max()));
+    auto const is_outside = [&](size_t i)
+    {
+        auto const x = pa[i];
+        auto const y = pb[i];
+        auto const diff = std::abs(x - y);
+        auto const within = (diff <= abs_tolerance) | (diff <= rel_tolerance * std::max(std::abs(x), std::abs(y)))
+                          || (ulp_distance(x, y) <= ulp_tolerance);
+        auto const is_nan = (x != x) | (y != y);
+        return (!within) | is_nan;
+    };
+    auto const mismatches = find_range_mismatches(size, is_outside);
+
+    if (size_a == size_b && mismatches.count == 0)
+        return check_handle::make(kind, cmp_op::none, expr_text, true, location);
+
+    std::vector<std::string> lines;
+    if (size_a != size_b)
+        lines.push_back(std::format("sizes differ: {} != {}", size_a, size_b));
+    lines.push_back(std::format("{} of {} elements outside of tolerance (abs {}, rel {}, ulps {})", mismatches.count,
+                                size, tolerance.abs, tolerance.rel, tolerance.ulps));
+    for (auto& line : approx_error_statistics(pa, pb, size))
+        lines.push_back(std::move(line));
+    for (auto i : mismatches.first_indices)
+        lines.push_back(std::format("[{}]: {} vs {} ({} ulps)", i, pa[i], pb[i], ulp_distance(pa[i], pb[i])));
+    if (mismatches.count > mismatches.first_indices.size())
+        lines.push_back(std::format("... and {} more", mismatches.count - mismatches.first_indices.size()));
+    return check_handle::make(kind, cmp_op::none, expr_text, false, location, std::move(lines));
+}
+} // namespace nx::impl
+
+// range checks over spans and contiguous containers (std::vector, std::array, std::span, C arrays, ...)
+// - a single check for the whole range, so a broken buffer produces one failure and not one per element
+// - the passing case runs as a branch-free blocked loop that compilers vectorize
+// - failures list the first few offending indices with their values and the total count
+// - like CHECK / REQUIRE, they return a check_handle for .context(), .note(), ...
+//
+// Examples:
+//   CHECK_RANGE_EQ(result, expected);           // same size and element-wise ==
+//   CHECK_RANGE_ALL_EQ(buffer, 0);              // every element == 0
+//   CHECK_RANGE_WITHIN(weights, 0.0f, 1.0f);    // lo <= element <= hi, fails for NaN
+//   REQUIRE_RANGE_SORTED(keys);                 // non-descending by operator<
+//   CHECK_RANGE_APPROX(out, ref, {.rel = 1e-6, .ulps = 4}); // float / double, see nx::approx_tolerance
+#define CHECK_RANGE_EQ(A, B)                                                                                  \
+    ::nx::impl::check_range_eq(::nx::impl::check_kind::check, "CHECK_RANGE_EQ(" #A ", " #B ")", A, B, \
+                               std::source_location::current())
+#define REQUIRE_RANGE_EQ(A, B)                                                                                    \
+    ::nx::impl::check_range_eq(::nx::impl::check_kind::require, "REQUIRE_RANGE_EQ(" #A ", " #B ")", A, B, \
+                               std::source_location::current())
+
+#define CHECK_RANGE_ALL_EQ(Range, Value)                                                                                   \
+    ::nx::impl::check_range_all_eq(::nx::impl::check_kind::check, "CHECK_RANGE_ALL_EQ(" #Range ", " #Value ")", Range, \
+                                   Value, std::source_location::current())
+#define REQUIRE_RANGE_ALL_EQ(Range, Value)                                                                     \
+    ::nx::impl::check_range_all_eq(::nx::impl::check_kind::require, "REQUIRE_RANGE_ALL_EQ(" #Range ", " #Value ")", \
+                                   Range, Value, std::source_location::current())
+
+#define CHECK_RANGE_WITHIN(Range, Lo, Hi)                                                                            \
+    ::nx::impl::check_range_within(::nx::impl::check_kind::check, "CHECK_RANGE_WITHIN(" #Range ", " #Lo ", " #Hi ")", \
+                                   Range, Lo, Hi, std::source_location::current())
+#define REQUIRE_RANGE_WITHIN(Range, Lo, Hi)                                                                    \
+    ::nx::impl::check_range_within(::nx::impl::check_kind::require,                                            \
+                                   "REQUIRE_RANGE_WITHIN(" #Range ", " #Lo ", " #Hi ")", Range, Lo, Hi, \
+                                   std::source_location::current())
+
+#define CHECK_RANGE_SORTED(Range)                                                                 \
+    ::nx::impl::check_range_sorted(::nx::impl::check_kind::check, "CHECK_RANGE_SORTED(" #Range ")", Range, \
+                                   std::source_location::current())
+#define REQUIRE_RANGE_SORTED(Range)                                                                     \
+    ::nx::impl::check_range_sorted(::nx::impl::check_kind::require, "REQUIRE_RANGE_SORTED(" #Range ")", Range, \
+                                   std::source_location::current())
+
+// on failure, reports error statistics (max abs / rel error, ULP histogram) instead of the whole arrays
+#define CHECK_RANGE_APPROX(A, B, ...)                                                                          \
+    ::nx::impl::check_range_approx(::nx::impl::check_kind::check, "CHECK_RANGE_APPROX(" #A ", " #B ", " #__VA_ARGS__ ")", \
+                                   A, B, ::nx::approx_tolerance(__VA_ARGS__), std::source_location::current())
+#define REQUIRE_RANGE_APPROX(A, B, ...)                                                                   \
+    ::nx::impl::check_range_approx(::nx::impl::check_kind::require,                                     \
+                                   "REQUIRE_RANGE_APPROX(" #A ", " #B ", " #__VA_ARGS__ ")", A, B,       \
+                                   ::nx::approx_tolerance(__VA_ARGS__), std::source_location::current())
@@ -0,0 +1,79 @@
+#include "resources.hh"
+
+#include <algorithm>
+#include <format>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#define NX_IMPL_HAS_GETRUSAGE 1
+#else
+#define NX_IMPL_HAS_GETRUSAGE 0
+#endif
+
+namespace
+{
+std::string format_bytes(std::int64_t bytes)
+{
+    if (bytes < 1024)
+        return std::format("{} B", bytes);
+    if (bytes < 1024 * 1024)
+        return std::format("{:.2f} KiB", double(bytes) / 1024.0);
+    if (bytes < 1024 * 1024 * 1024)
+        return std::format("{:.2f} MiB", double(bytes) / (1024.0 * 1024.0));
+    return std::format("{:.2f} GiB", double(bytes) / (1024.0 * 1024.0 * 1024.0));
+}
+
+#if NX_IMPL_HAS_GETRUSAGE
+double to_seconds(timeval const& t) { return double(t.tv_sec) + double(t.tv_usec) * 1e-6; }
+#endif
+} // namespace
+
+nx::resource_usage nx::resource_usage::since(resource_usage const& start) const
+{
+    return {
+        .user_cpu_seconds = user_cpu_seconds - start.user_cpu_seconds,
+        .system_cpu_seconds = system_cpu_seconds - start.system_cpu_seconds,
+        .peak_rss_bytes = std::max<std::int64_t>(peak_rss_bytes - start.peak_rss_bytes, 0),
+        .minor_page_faults = minor_page_faults - start.minor_page_faults,
+        .major_page_faults = major_page_faults - start.major_page_faults,
+        .voluntary_context_switches = voluntary_context_switches - start.voluntary_context_switches,
+        .involuntary_context_switches = involuntary_context_switches - start.involuntary_context_switches,
+    };
+}
+
+std::string nx::to_string(resource_usage const& usage)
+{
+    return std::format("cpu {:.2f} ms user + {:.2f} ms sys, peak rss +{}, {} minor / {} major page faults, "
+                       "{} voluntary / {} involuntary context switches",
+                       usage.user_cpu_seconds * 1e3, usage.system_cpu_seconds * 1e3, format_bytes(usage.peak_rss_bytes),
+                       usage.minor_page_faults, usage.major_page_faults, usage.voluntary_context_switches,
+                       usage.involuntary_context_switches);
+}
+
+nx::resource_usage nx::impl::read_resource_usage()
+{
+    resource_usage result;
+#if NX_IMPL_HAS_GETRUSAGE
+    rusage usage = {};
+#ifdef RUSAGE_THREAD
+    if (getrusage(RUSAGE_THREAD, &usage) != 0)
+        return result;
+#else
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return result;
+#endif
+
+    result.user_cpu_seconds = to_seconds(usage.ru_utime);
+    result.system_cpu_seconds = to_seconds(usage.ru_stime);
+#ifdef __APPLE__
+    result.peak_rss_bytes = std::int64_t(usage.ru_maxrss); // bytes on macOS
+#else
+    result.peak_rss_bytes = std::int64_t(usage.ru_maxrss) * 1024; // KiB on Linux and BSDs
+#endif
+    result.minor_page_faults = usage.ru_minflt;
+    result.major_page_faults = usage.ru_majflt;
+    result.voluntary_context_switches = usage.ru_nvcsw;
+    result.involuntary_context_switches = usage.ru_nivcsw;
+#endif
+    return result;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace nx
+{
+// operating system resources consumed by a thread, from getrusage(RUSAGE_THREAD)
+// - where RUSAGE_THREAD is missing (e.g. macOS), the values are process-wide
+// - all zero where getrusage is missing (e.g. Windows)
+// - snapshots hold totals since thread start, results of since() hold the consumption in between
+struct resource_usage
+{
+    double user_cpu_seconds = 0.0;
+    double system_cpu_seconds = 0.0;
+
+    // the peak resident set size is tracked per process by the kernel
+    // in a difference, this is how much the peak grew, i.e. 0 if memory stayed below an earlier peak
+    std::int64_t peak_rss_bytes = 0;
+
+    std::int64_t minor_page_faults = 0; // served without I/O (e.g. first touch of fresh memory)
+    std::int64_t major_page_faults = 0; // required I/O (e.g. swapped out or not yet mapped file pages)
+
+    std::int64_t voluntary_context_switches = 0;   // blocked, e.g. on a lock, I/O, or sleep
+    std::int64_t involuntary_context_switches = 0; // preempted, e.g. time slice expired or more runnable threads than cores
+
+    // consumption between an earlier snapshot and this one
+    [[nodiscard]] resource_usage since(resource_usage const& start) const;
+};
+
+// e.g. "cpu 12.30 ms user + 1.20 ms sys, peak rss +4.00 MiB, 120 minor / 0 major page faults, 3 voluntary / 1 involuntary context switches"
+[[nodiscard]] std::string to_string(resource_usage const& usage);
+} // namespace nx
+
+namespace nx::impl
+{
+// snapshot for the calling thread
+[[nodiscard]] resource_usage read_resource_usage();
+} // namespace nx::impl
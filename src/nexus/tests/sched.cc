@@ -0,0 +1,489 @@
+#include "sched.hh"
+
+#include <nexus/tests/check.hh>
+#include <nexus/tests/crash.hh>
+#include <nexus/tests/hash.hh>
+#include <nexus/tests/registry.hh>
+#include <nexus/tests/schedule.hh>
+#include <nexus/tests/trace.hh>
+
+#include <clean-core/assert.hh>
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <format>
+#include <memory>
+#include <optional>
+
+namespace
+{
+// thread switches listed in the failure report, the rest is only counted
+constexpr int max_traced_switches = 64;
+} // namespace
+
+struct nx::impl::scheduler
+{
+    struct thread_state
+    {
+        bool is_finished = false;
+        void const* blocked_on = nullptr;
+        std::string blocked_what;
+        std::int64_t priority = 0; // pct only, higher runs first
+        std::condition_variable wakeup;
+    };
+
+    sched::options options;
+    std::source_location location; // of INTERLEAVINGS, deadlocks and livelocks are reported there
+    std::uint64_t rng = 0;
+
+    std::mutex mutex;
+    std::vector<std::unique_ptr<thread_state>> threads;
+    int running = 0;
+    int steps = 0;
+
+    // pct: steps at which the running thread drops to the lowest priority (ascending), and that priority
+    std::vector<int> change_points;
+    size_t next_change_point = 0;
+    std::int64_t next_low_priority = 0;
+
+    // "0 1 0 2 ..."
+    std::string schedule;
+    int switches = 0;
+
+    // deadlock or livelock, all threads unwind once this is set
+    bool is_aborted = false;
+    std::optional<test_error> abort_error;
+
+    // run_captured results of all threads but 0
+    std::vector<captured_checks> thread_checks;
+
+    std::int64_t random_priority()
+    {
+        // above all priorities given at change points
+        return std::int64_t(splitmix64_next(rng) >> 2) + options.pct_depth;
+    }
+
+    bool is_runnable(int id) const { return !threads[id]->is_finished && threads[id]->blocked_on == nullptr; }
+
+    // -1 if all threads are blocked or finished
+    int pick_next()
+    {
+        auto const count = int(threads.size());
+        if (options.strategy == sched::strategy::random)
+        {
+            auto runnable = 0;
+            for (auto i = 0; i < count; ++i)
+                runnable += is_runnable(i);
+            if (runnable == 0)
+                return -1;
+
+            auto chosen = int(splitmix64_next(rng) % std::uint64_t(runnable));
+            for (auto i = 0; i < count; ++i)
+                if (is_runnable(i) && chosen-- == 0)
+                    return i;
+        }
+
+        auto best = -1;
+        for (auto i = 0; i < count; ++i)
+            if (is_runnable(i) && (best < 0 || threads[i]->priority > threads[best]->priority))
+                best = i;
+        return best;
+    }
+
+    void abort(std::string expr, std::vector<std::string> extra_lines)
+    {
+        if (is_aborted)
+            return;
+
+        is_aborted = true;
+        auto expanded = expr;
+        abort_error = test_error{
+            .expr = std::move(expr),
+            .location = location,
+            .extra_lines = std::move(extra_lines),
+            .expanded = std::move(expanded),
+        };
+        for (auto const& t : threads)
+            t->wakeup.notify_all();
+    }
+
+    void abort_deadlock()
+    {
+        std::vector<std::string> lines;
+        for (auto i = 0; i < int(threads.size()); ++i)
+            if (!threads[i]->is_finished)
+                lines.push_back(std::format("thread {} waits for {}", i, threads[i]->blocked_what));
+        abort("deadlock: every unfinished thread is blocked", std::move(lines));
+    }
+
+    // counts a scheduling point of the current thread, false if the interleaving was aborted
+    bool step(int self)
+    {
+        if (is_aborted)
+            return false;
+
+        if (++steps > options.max_steps)
+        {
+            abort(std::format("livelock: more than {} scheduling points", options.max_steps),
+                  {"threads that busy-wait should call nx::sched::yield()"});
+            return false;
+        }
+
+        while (options.strategy == sched::strategy::pct && next_change_point < change_points.size()
+               && change_points[next_change_point] <= steps)
+        {
+            threads[self]->priority = next_low_priority--;
+            ++next_change_point;
+        }
+        return true;
+    }
+
+    // hands over to next and returns once the current thread is picked again, throws if the interleaving was aborted
+    void switch_to(std::unique_lock<std::mutex>& lock, int self, int next)
+    {
+        CC_ASSERT(next >= 0, "no runnable thread");
+        if (next != self)
+        {
+            if (++switches <= max_traced_switches)
+                schedule += std::format(" {}", next);
+
+            running = next;
+            threads[next]->wakeup.notify_one();
+            threads[self]->wakeup.wait(lock, [&] { return running == self || is_aborted; });
+        }
+
+        if (is_aborted)
+        {
+            lock.unlock();
+            impl::abort_silently();
+        }
+    }
+
+    // blocks the current thread until its blocked_on is cleared and it is picked again
+    void wait(std::unique_lock<std::mutex>& lock, int self, void const* object, std::string what)
+    {
+        threads[self]->blocked_on = object;
+        threads[self]->blocked_what = std::move(what);
+        auto const next = pick_next();
+        if (next < 0)
+        {
+            abort_deadlock();
+            lock.unlock();
+            impl::abort_silently();
+        }
+        switch_to(lock, self, next);
+    }
+};
+
+namespace
+{
+thread_local nx::impl::scheduler* g_scheduler = nullptr;
+thread_local int g_sched_thread = -1;
+
+[[noreturn]] void abort_locked(std::unique_lock<std::mutex>& lock)
+{
+    lock.unlock();
+    nx::impl::abort_silently();
+}
+} // namespace
+
+nx::impl::scheduler* nx::impl::current_scheduler() { return g_scheduler; }
+
+void nx::impl::sched_point(scheduler& s)
+{
+    auto lock = std::unique_lock(s.mutex);
+    if (!s.step(g_sched_thread))
+        abort_locked(lock);
+    s.switch_to(lock, g_sched_thread, s.pick_next());
+}
+
+void nx::impl::sched_yield(scheduler& s)
+{
+    auto lock = std::unique_lock(s.mutex);
+    if (!s.step(g_sched_thread))
+        abort_locked(lock);
+    if (s.options.strategy == sched::strategy::pct)
+        s.threads[g_sched_thread]->priority = s.next_low_priority--;
+    s.switch_to(lock, g_sched_thread, s.pick_next());
+}
+
+void nx::impl::sched_wait(scheduler& s, void const* object, char const* what)
+{
+    auto lock = std::unique_lock(s.mutex);
+    if (s.is_aborted)
+        abort_locked(lock);
+    s.wait(lock, g_sched_thread, object, what);
+}
+
+void nx::impl::sched_notify(scheduler& s, void const* object) noexcept
+{
+    auto lock = std::unique_lock(s.mutex);
+    for (auto const& t : s.threads)
+        if (t->blocked_on == object)
+            t->blocked_on = nullptr;
+}
+
+bool nx::impl::sched_is_aborted(scheduler& s)
+{
+    auto lock = std::unique_lock(s.mutex);
+    return s.is_aborted;
+}
+
+int nx::impl::sched_spawn(scheduler& s)
+{
+    auto lock = std::unique_lock(s.mutex);
+    auto& t = s.threads.emplace_back(std::make_unique<scheduler::thread_state>());
+    t->priority = s.random_priority();
+    return int(s.threads.size()) - 1;
+}
+
+void nx::impl::sched_run_thread(scheduler& s, int id, std::function<void()> const& fn, std::source_location location)
+{
+    g_scheduler = &s;
+    g_sched_thread = id;
+
+    auto is_aborted = false;
+    {
+        auto lock = std::unique_lock(s.mutex);
+        s.threads[id]->wakeup.wait(lock, [&] { return s.running == id || s.is_aborted; });
+        is_aborted = s.is_aborted;
+    }
+
+    // REQUIRE failures and exceptions only end this thread
+    auto captured = is_aborted ? captured_checks{} : impl::run_captured([&] { fn(); }, location);
+
+    {
+        auto lock = std::unique_lock(s.mutex);
+        s.thread_checks.push_back(std::move(captured));
+        s.threads[id]->is_finished = true;
+        for (auto const& t : s.threads)
+            if (t->blocked_on == s.threads[id].get())
+                t->blocked_on = nullptr;
+
+        if (!s.is_aborted)
+        {
+            auto const next = s.pick_next();
+            if (next >= 0)
+            {
+                if (++s.switches <= max_traced_switches)
+                    s.schedule += std::format(" {}", next);
+                s.running = next;
+                s.threads[next]->wakeup.notify_one();
+            }
+            else if (std::ranges::any_of(s.threads, [](auto const& t) { return !t->is_finished; }))
+                s.abort_deadlock();
+        }
+    }
+
+    g_scheduler = nullptr;
+    g_sched_thread = -1;
+}
+
+void nx::impl::sched_join(scheduler& s, int id)
+{
+    auto lock = std::unique_lock(s.mutex);
+    if (s.is_aborted)
+        abort_locked(lock);
+    while (!s.threads[id]->is_finished)
+        s.wait(lock, g_sched_thread, s.threads[id].get(), std::format("thread {} to finish", id));
+}
+
+void nx::sched::mutex::lock()
+{
+    auto const s = impl::current_scheduler();
+    if (s == nullptr)
+    {
+        _mutex.lock();
+        return;
+    }
+
+    impl::sched_point(*s);
+    while (_locked.exchange(true))
+        impl::sched_wait(*s, this, "a mutex");
+}
+
+bool nx::sched::mutex::try_lock()
+{
+    auto const s = impl::current_scheduler();
+    if (s == nullptr)
+        return _mutex.try_lock();
+
+    impl::sched_point(*s);
+    return !_locked.exchange(true);
+}
+
+void nx::sched::mutex::unlock()
+{
+    auto const s = impl::current_scheduler();
+    if (s == nullptr)
+    {
+        _mutex.unlock();
+        return;
+    }
+
+    // no scheduling point while unwinding (e.g. a std::lock_guard after a failed REQUIRE or an aborted interleaving)
+    if (std::uncaught_exceptions() == 0 && !impl::sched_is_aborted(*s))
+        impl::sched_point(*s);
+    _locked.store(false);
+    impl::sched_notify(*s, this);
+}
+
+void nx::sched::thread::join()
+{
+    CC_ASSERT(joinable(), "thread is not joinable");
+    if (_scheduler != nullptr)
+        impl::sched_join(*_scheduler, _id);
+    _thread.join();
+}
+
+void nx::sched::yield()
+{
+    if (auto const s = impl::current_scheduler())
+        impl::sched_yield(*s);
+    else
+        std::this_thread::yield();
+}
+
+nx::impl::interleaving_settings nx::impl::current_interleaving_settings(std::string_view name, sched::options const& options)
+{
+    interleaving_settings settings;
+    settings.interleavings
+        = std::max(options.interleavings > 0 ? options.interleavings : impl::current_schedule_config().interleavings, 1);
+
+    // like PROPERTY: an explicit seed applies to all runners of the test, the name still distinguishes them
+    auto const declaration = impl::current_test_declaration();
+    if (declaration != nullptr && declaration->test_config.seed != 0)
+        settings.seed = fnv1a(name, std::uint64_t(declaration->test_config.seed));
+    else
+        settings.seed = fnv1a(name, fnv1a(declaration != nullptr ? declaration->name : ""));
+
+    return settings;
+}
+
+nx::impl::interleaving_result nx::impl::run_interleaving(std::uint64_t seed,
+                                                         sched::options const& options,
+                                                         int pct_steps,
+                                                         std::source_location location,
+                                                         std::function<void()> const& fn)
+{
+    scheduler s;
+    s.options = options;
+    s.location = location;
+    s.options.pct_depth = std::max(options.pct_depth, 1);
+    s.rng = seed;
+    s.next_low_priority = s.options.pct_depth - 1;
+    // distinct, a duplicate would cost one of the pct_depth - 1 priority changes
+    auto const step_count = std::max(pct_steps, 1);
+    while (int(s.change_points.size()) < std::min(s.options.pct_depth - 1, step_count))
+    {
+        auto const point = 1 + int(splitmix64_next(s.rng) % std::uint64_t(step_count));
+        if (std::ranges::find(s.change_points, point) == s.change_points.end())
+            s.change_points.push_back(point);
+    }
+    std::ranges::sort(s.change_points);
+
+    s.threads.push_back(std::make_unique<scheduler::thread_state>());
+    s.threads[0]->priority = s.random_priority();
+    s.schedule = "0";
+
+    CC_ASSERT(g_scheduler == nullptr, "INTERLEAVINGS cannot be nested");
+    g_scheduler = &s;
+    g_sched_thread = 0;
+
+    interleaving_result result;
+    result.checks = impl::run_captured([&] { fn(); }, location);
+
+    {
+        auto lock = std::unique_lock(s.mutex);
+        s.threads[0]->is_finished = true;
+        CC_ASSERT(s.is_aborted || std::ranges::all_of(s.threads, [](auto const& t) { return t->is_finished; }),
+                  "all nx::sched::thread objects must be joined or destroyed in the body");
+    }
+    g_scheduler = nullptr;
+    g_sched_thread = -1;
+
+    for (auto& checks : s.thread_checks)
+        result.checks.merge(std::move(checks));
+    if (s.abort_error.has_value())
+    {
+        result.checks.executed_checks += 1;
+        result.checks.failed_checks += 1;
+        result.checks.errors.push_back(std::move(*s.abort_error));
+    }
+
+    result.steps = s.steps;
+    result.schedule = std::move(s.schedule);
+    if (s.switches > max_traced_switches)
+        result.schedule += std::format(" ... ({} more switches)", s.switches - max_traced_switches);
+    return result;
+}
+
+void nx::impl::explore_interleavings(std::string_view name,
+                                     std::source_location location,
+                                     sched::options const& options,
+                                     std::function<void()> const& fn)
+{
+    auto const settings = impl::current_interleaving_settings(name, options);
+    auto const _trace = trace_scope(std::format("INTERLEAVINGS(\"{}\")", name), "interleavings");
+    auto const expr = std::format("INTERLEAVINGS(\"{}\")", name);
+
+    auto const run = [&](int index, std::uint64_t seed, sched::options const& run_options, int pct_steps)
+    {
+        auto _ = impl::scoped_crash_context(
+            [&] { return std::format("INTERLEAVINGS(\"{}\") interleaving {} (seed {})", name, index, seed); });
+        return run_interleaving(seed, run_options, pct_steps, location, fn);
+    };
+    auto const report_failure = [&](interleaving_result result, std::vector<std::string> lines)
+    {
+        lines.push_back(std::format("schedule ({} scheduling points): {}", result.steps, result.schedule));
+        impl::report_captured_checks(std::move(result.checks), lines);
+    };
+
+    // the first interleaving runs the threads by priority without preemption (seed 0)
+    // it measures the scheduling points per interleaving, so that pct can spread its change points over them
+    auto sequential_options = options;
+    sequential_options.strategy = sched::strategy::pct;
+    sequential_options.pct_depth = 1;
+    auto sequential = run(0, 0, sequential_options, 1);
+    auto const pct_steps = sequential.steps;
+
+    if (options.replay_seed != 0)
+    {
+        auto replayed = run(0, options.replay_seed, options, pct_steps);
+        if (!replayed.checks.is_failing())
+        {
+            impl::report_check_result(check_kind::check, cmp_op::none, expr, true, {}, location);
+            return;
+        }
+        report_failure(std::move(replayed), {std::format("replayed interleaving (seed {})", options.replay_seed)});
+        return;
+    }
+
+    if (sequential.checks.is_failing())
+    {
+        report_failure(std::move(sequential), {"failed without preemption, i.e. with threads run one after another"});
+        return;
+    }
+
+    for (auto i = 1; i < settings.interleavings; ++i)
+    {
+        auto const seed = fnv1a(std::format("{}", i), settings.seed) | 1; // 0 is the sequential interleaving
+        auto result = run(i, seed, options, pct_steps);
+        if (!result.checks.is_failing())
+            continue;
+
+        std::vector<std::string> lines;
+        lines.push_back(std::format("interleaving {} of {} failed (seed {})", i, settings.interleavings, seed));
+        lines.push_back(std::format("replay with INTERLEAVINGS(\"{}\", .replay_seed = {})", name, seed));
+
+        // the same seed must give the same interleaving, unless threads synchronize outside of nx::sched
+        if (!run(i, seed, options, pct_steps).checks.is_failing())
+            lines.push_back("passed when replayed, threads probably synchronize outside of nx::sched");
+
+        report_failure(std::move(result), std::move(lines));
+        return;
+    }
+
+    impl::report_check_result(check_kind::check, cmp_op::none, expr, true, {}, location);
+}
@@ -0,0 +1,309 @@
+#pragma once
+
+#include <nexus/tests/execute.hh>
+
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace nx::sched
+{
+// how the controlled scheduler picks the next thread at each scheduling point
+// - random: uniformly among the runnable threads
+// - pct: probabilistic concurrency testing, i.e. strict random thread priorities with depth - 1 random points
+//        where the running thread drops to the lowest priority
+//        finds any bug that needs at most depth ordering constraints with probability >= 1 / (threads * steps^(depth-1))
+enum class strategy
+{
+    random,
+    pct,
+};
+
+struct options
+{
+    nx::sched::strategy strategy = nx::sched::strategy::pct;
+    int pct_depth = 3;
+
+    // number of interleavings explored (0: --interleavings, default 1000)
+    int interleavings = 0;
+
+    // scheduling points per interleaving before it is reported as a livelock
+    int max_steps = 100'000;
+
+    // runs only the interleaving with this seed (as printed for a failure)
+    std::uint64_t replay_seed = 0;
+};
+} // namespace nx::sched
+
+namespace nx::impl
+{
+// the controlled scheduler runs exactly one of its threads at a time and switches only at scheduling points,
+// i.e. in the operations of nx::sched::atomic, mutex, and thread
+// all synchronization between controlled threads must go through these, anything else (e.g. std::mutex) may hang
+struct scheduler;
+
+// nullptr if this thread is not run by a controlled scheduler
+[[nodiscard]] scheduler* current_scheduler();
+
+// lets the scheduler switch to another thread
+void sched_point(scheduler& s);
+
+// deprioritizes the current thread (under pct), then a scheduling point
+void sched_yield(scheduler& s);
+
+// blocks the current thread until sched_notify(object), what is reported if this deadlocks ("a mutex")
+void sched_wait(scheduler& s, void const* object, char const* what);
+
+// unblocks all threads waiting for object (not a scheduling point)
+// never throws, so it can be used when releasing resources during unwinding
+void sched_notify(scheduler& s, void const* object) noexcept;
+
+// true if the current interleaving was aborted (deadlock, livelock), threads are unwinding then
+[[nodiscard]] bool sched_is_aborted(scheduler& s);
+
+// a new controlled thread, it first runs when the scheduler picks it
+[[nodiscard]] int sched_spawn(scheduler& s);
+void sched_run_thread(scheduler& s, int id, std::function<void()> const& fn, std::source_location location);
+void sched_join(scheduler& s, int id);
+} // namespace nx::impl
+
+namespace nx::sched
+{
+// drop-in for std::atomic<T> with a scheduling point before every operation
+// memory orders are accepted, but controlled threads are serialized, so only sequentially consistent executions are explored
+template <class T>
+struct atomic
+{
+    atomic() = default;
+    constexpr atomic(T value) : _value(value) {}
+    atomic(atomic const&) = delete;
+    atomic& operator=(atomic const&) = delete;
+
+    T load(std::memory_order order = std::memory_order_seq_cst) const
+    {
+        point();
+        return _value.load(order);
+    }
+    void store(T value, std::memory_order order = std::memory_order_seq_cst)
+    {
+        point();
+        _value.store(value, order);
+    }
+    T exchange(T value, std::memory_order order = std::memory_order_seq_cst)
+    {
+        point();
+        return _value.exchange(value, order);
+    }
+    bool compare_exchange_weak(T& expected, T desired, std::memory_order order = std::memory_order_seq_cst)
+    {
+        point();
+        return _value.compare_exchange_weak(expected, desired, order);
+    }
+    bool compare_exchange_strong(T& expected, T desired, std::memory_order order = std::memory_order_seq_cst)
+    {
+        point();
+        return _value.compare_exchange_strong(expected, desired, order);
+    }
+
+    T fetch_add(T arg, std::memory_order order = std::memory_order_seq_cst)
+        requires std::integral<T>
+    {
+        point();
+        return _value.fetch_add(arg, order);
+    }
+    T fetch_sub(T arg, std::memory_order order = std::memory_order_seq_cst)
+        requires std::integral<T>
+    {
+        point();
+        return _value.fetch_sub(arg, order);
+    }
+
+    operator T() const { return load(); }
+    T operator=(T value)
+    {
+        store(value);
+        return value;
+    }
+    T operator++()
+        requires std::integral<T>
+    {
+        return fetch_add(1) + 1;
+    }
+    T operator--()
+        requires std::integral<T>
+    {
+        return fetch_sub(1) - 1;
+    }
+    T operator++(int)
+        requires std::integral<T>
+    {
+        return fetch_add(1);
+    }
+    T operator--(int)
+        requires std::integral<T>
+    {
+        return fetch_sub(1);
+    }
+
+private:
+    static void point()
+    {
+        if (auto const s = impl::current_scheduler())
+            impl::sched_point(*s);
+    }
+
+    std::atomic<T> _value;
+};
+
+// drop-in for std::mutex (Lockable, so std::lock_guard and std::unique_lock work)
+// an object must either be used by controlled threads only or by uncontrolled ones only
+struct mutex
+{
+    mutex() = default;
+    mutex(mutex const&) = delete;
+    mutex& operator=(mutex const&) = delete;
+
+    void lock();
+    bool try_lock();
+    void unlock();
+
+private:
+    std::mutex _mutex;              // uncontrolled threads
+    std::atomic<bool> _locked = false; // controlled threads
+};
+
+// drop-in for std::jthread (without stop tokens) whose thread is controlled if it is started by a controlled thread
+// the destructor joins, so threads must not outlive the interleaving they are started in
+struct thread
+{
+    thread() = default;
+
+    template <class F>
+        requires std::invocable<std::decay_t<F>&>
+    explicit thread(F&& fn, std::source_location location = std::source_location::current())
+    {
+        _scheduler = impl::current_scheduler();
+        if (_scheduler == nullptr)
+        {
+            _thread = std::jthread(std::forward<F>(fn));
+            return;
+        }
+
+        _id = impl::sched_spawn(*_scheduler);
+        _thread = std::jthread([s = _scheduler, id = _id, location, f = std::function<void()>(std::forward<F>(fn))]
+                               { impl::sched_run_thread(*s, id, f, location); });
+
+        // starting a thread is a scheduling point, so that the new thread can run before its parent continues
+        impl::sched_point(*_scheduler);
+    }
+
+    thread(thread&& rhs) noexcept = default;
+    thread& operator=(thread&& rhs) = delete; // would have to join the current thread
+    thread(thread const&) = delete;
+    thread& operator=(thread const&) = delete;
+
+    ~thread()
+    {
+        if (!joinable() || _scheduler == nullptr)
+            return;
+
+        try
+        {
+            impl::sched_join(*_scheduler, _id);
+        }
+        catch (...) // NOLINT(bugprone-empty-catch)
+        {
+            // the interleaving was aborted, _thread is unwinding and joined below
+        }
+    }
+
+    [[nodiscard]] bool joinable() const { return _thread.joinable(); }
+
+    void join();
+
+private:
+    impl::scheduler* _scheduler = nullptr;
+    int _id = -1;
+    std::jthread _thread;
+};
+
+// scheduling point that tells the scheduler that this thread waits for another one (e.g. in a spin loop)
+// under pct, busy waiting without yield would run the highest-priority thread until max_steps
+void yield();
+} // namespace nx::sched
+
+namespace nx::impl
+{
+struct interleaving_settings
+{
+    std::uint64_t seed = 0; // base seed, each interleaving derives its own
+    int interleavings = 1000;
+};
+
+// seed (from nx::config::seed or derived from the test and runner name) and interleaving count
+interleaving_settings current_interleaving_settings(std::string_view name, sched::options const& options);
+
+struct interleaving_result
+{
+    captured_checks checks;
+    int steps = 0;
+    std::string schedule; // thread switches, e.g. "0 1 1 0 2 ..."
+};
+
+// runs fn as thread 0 of a controlled scheduler, fn can start more threads with nx::sched::thread
+// - pct_steps: expected scheduling points per interleaving, used to place the pct priority change points
+// - deadlocks and livelocks (max_steps) abort the interleaving and are reported as failures
+interleaving_result run_interleaving(std::uint64_t seed,
+                                     sched::options const& options,
+                                     int pct_steps,
+                                     std::source_location location,
+                                     std::function<void()> const& fn);
+
+// explores the interleavings of fn and reports them as a single check (or the first failing one) of the current test
+void explore_interleavings(std::string_view name,
+                           std::source_location location,
+                           sched::options const& options,
+                           std::function<void()> const& fn);
+
+struct interleaving_runner
+{
+    std::string name;
+    std::source_location location;
+    sched::options options;
+
+    template <class Fn>
+    void operator=(Fn&& fn) // NOLINT(misc-unconventional-assign-operator,cppcoreguidelines-c-copy-assignment-signature)
+    {
+        explore_interleavings(name, location, options, std::function<void()>(std::forward<Fn>(fn)));
+    }
+};
+} // namespace nx::impl
+
+// INTERLEAVINGS macro: runs the body many times under a controlled scheduler inside a TEST
+// - threads started with nx::sched::thread are serialized and only switch at nx::sched operations,
+//   so every interleaving is deterministic and replayable from its seed
+// - explores --interleavings schedules (random or pct, see nx::sched::options), stops at the first failing one
+// - deadlocks and livelocks are failures, the failure reports the seed of the interleaving
+// - counts as a single passing check if all interleavings pass
+//
+// usage:
+//   INTERLEAVINGS("increments are not lost") // or INTERLEAVINGS("...", .strategy = nx::sched::strategy::random)
+//   {
+//       nx::sched::atomic<int> counter = 0;
+//       {
+//           nx::sched::thread a([&] { counter.store(counter.load() + 1); });
+//           nx::sched::thread b([&] { counter.store(counter.load() + 1); });
+//       }
+//       CHECK(counter.load() == 2); // fails, replay with INTERLEAVINGS("...", .replay_seed = <seed>)
+//   };
+#define INTERLEAVINGS(name, ...)                                                                                   \
+    ::nx::impl::interleaving_runner{name, std::source_location::current(), ::nx::sched::options{__VA_ARGS__}} = [&]
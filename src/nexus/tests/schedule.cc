@@ -2,6 +2,7 @@
 
 #include <clean-core/assert.hh>
 
+#include <cstdlib>
 #include <iostream>
 
 nx::test_schedule_config nx::test_schedule_config::create_from_args(int argc, char** argv)
@@ -12,7 +13,6 @@ nx::test_schedule_config nx::test_schedule_config::create_from_args(int argc, ch
     bool has_verbosity = false;
     bool has_list_tests = false;
     bool has_xml_reporter = false;
-    bool has_durations = false;
 
     // Parse command line arguments
     for (int i = 1; i < argc; ++i)
@@ -47,12 +47,124 @@ nx::test_schedule_config nx::test_schedule_config::create_from_args(int argc, ch
                 ++i;
             continue;
         }
+        else if (arg.starts_with("--benchmark-out="))
+        {
+            config.benchmark_out_file = arg.substr(std::string_view("--benchmark-out=").size());
+            continue;
+        }
+        else if (arg.starts_with("--trace-out="))
+        {
+            config.trace_out_file = arg.substr(std::string_view("--trace-out=").size());
+            continue;
+        }
+        else if (arg == "--profile")
+        {
+            config.profile_dir = "nexus-profile";
+            continue;
+        }
+        else if (arg.starts_with("--profile="))
+        {
+            config.profile_dir = arg.substr(std::string_view("--profile=").size());
+            continue;
+        }
+        else if (arg.starts_with("--profile-frequency="))
+        {
+            config.profile_frequency = std::atoi(arg.c_str() + std::string_view("--profile-frequency=").size());
+            continue;
+        }
+        else if (arg == "--fuzz")
+        {
+            config.fuzz = true;
+            continue;
+        }
+        else if (arg.starts_with("--fuzz-time="))
+        {
+            config.fuzz_seconds = std::atof(arg.c_str() + std::string_view("--fuzz-time=").size());
+            continue;
+        }
+        else if (arg.starts_with("--fuzz-jobs="))
+        {
+            config.fuzz_jobs = std::atoi(arg.c_str() + std::string_view("--fuzz-jobs=").size());
+            continue;
+        }
+        else if (arg == "--fuzz-minimize-corpus")
+        {
+            config.fuzz_minimize_corpus = true;
+            continue;
+        }
+        else if (arg.starts_with("--fuzz-cost="))
+        {
+            auto const metric = std::string_view(arg).substr(std::string_view("--fuzz-cost=").size());
+            if (metric == "edges")
+                config.fuzz_cost = fuzz_cost_metric::edge_hits;
+            else if (metric == "time")
+                config.fuzz_cost = fuzz_cost_metric::wall_time;
+            else
+                std::cerr << "unknown --fuzz-cost metric '" << metric << "' (expected 'edges' or 'time'), ignored\n";
+            continue;
+        }
+        else if (arg.starts_with("--fuzz-corpus="))
+        {
+            config.fuzz_corpus_dir = arg.substr(std::string_view("--fuzz-corpus=").size());
+            continue;
+        }
+        else if (arg.starts_with("--jobs="))
+        {
+            config.jobs = std::atoi(arg.c_str() + std::string_view("--jobs=").size());
+            continue;
+        }
+        else if (arg.starts_with("-j"))
+        {
+            // "-j8" or "-j 8"
+            if (arg.size() > 2)
+                config.jobs = std::atoi(arg.c_str() + 2);
+            else if (i + 1 < argc)
+                config.jobs = std::atoi(argv[++i]);
+            continue;
+        }
+        else if (arg.starts_with("--property-cases="))
+        {
+            config.property_cases = std::atoi(arg.c_str() + std::string_view("--property-cases=").size());
+            continue;
+        }
+        else if (arg.starts_with("--property-jobs="))
+        {
+            config.property_jobs = std::atoi(arg.c_str() + std::string_view("--property-jobs=").size());
+            continue;
+        }
+        else if (arg.starts_with("--interleavings="))
+        {
+            config.interleavings = std::atoi(arg.c_str() + std::string_view("--interleavings=").size());
+            continue;
+        }
+        else if (arg.starts_with("--max-failures="))
+        {
+            config.max_failures_per_test = std::atoi(arg.c_str() + std::string_view("--max-failures=").size());
+            continue;
+        }
+        else if (arg.starts_with("--max-failures-per-location="))
+        {
+            config.max_failures_per_location
+                = std::atoi(arg.c_str() + std::string_view("--max-failures-per-location=").size());
+            continue;
+        }
         else if (arg == "--durations")
         {
-            has_durations = true;
-            // Skip the next argument (durations value)
-            if (i + 1 < argc)
-                ++i;
+            // Catch2 passes "yes" / "no", our own usage may omit it
+            config.report_durations = true;
+            if (i + 1 < argc && (std::string_view(argv[i + 1]) == "yes" || std::string_view(argv[i + 1]) == "no"))
+                config.report_durations = std::string_view(argv[++i]) == "yes";
+            continue;
+        }
+        else if (arg.starts_with("--durations="))
+        {
+            config.report_durations = true;
+            config.durations_top = std::atoi(arg.c_str() + std::string_view("--durations=").size());
+            continue;
+        }
+        else if (arg.starts_with("--durations-history="))
+        {
+            config.durations_history_file = arg.substr(std::string_view("--durations-history=").size());
             continue;
         }
 
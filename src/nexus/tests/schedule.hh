@@ -12,6 +12,16 @@ struct test_instance
     test_declaration const* declaration = nullptr;
 };
 
+// execution cost that performance fuzzing maximizes (see --fuzz-cost)
+// - edge_hits: executed instrumented edges, exact and noise-free (requires coverage instrumentation)
+// - wall_time: measured time per execution
+enum class fuzz_cost_metric
+{
+    none,
+    edge_hits,
+    wall_time,
+};
+
 struct test_schedule_config
 {
     std::vector<std::string> filters;
@@ -20,6 +30,59 @@ struct test_schedule_config
     bool report_catch2_xml_results = false;
     bool verbose = false;
 
+    // if non-empty, benchmark results are written there in Google Benchmark's JSON format
+    std::string benchmark_out_file;
+
+    // if non-empty, a timeline of the run is written there in Chrome's trace event format (see nx::trace_scope)
+    std::string trace_out_file;
+
+    // if non-empty, every test is sampled (SIGPROF) and its profile written to <dir>/<test name>.folded
+    // as folded stacks (flamegraph.pl, inferno, speedscope), prefixed with the test, section, and benchmark names
+    std::string profile_dir;
+    int profile_frequency = 1000; // samples per second of CPU time
+
+    // failed checks recorded per test and per check location (0 = unlimited)
+    // further failures are only counted and reported as "CHECK at foo.cc:42 failed N more times"
+    int max_failures_per_test = 1000;
+    int max_failures_per_location = 100;
+
+    // --durations: after the run, report the slowest tests and tests that got slower than their own history
+    // - durations_top: number of slowest tests shown
+    // - durations_history_file: if non-empty, durations of passing tests and their sections are compared against
+    //   the earlier builds recorded there and then appended (only set by --durations-history, never implicitly)
+    bool report_durations = false;
+    int durations_top = 10;
+    std::string durations_history_file;
+
+    // FUZZ_TEST behavior
+    // - default: quick regression over the corpus and a few deterministic mutations
+    // - fuzz: coverage-guided exploration for fuzz_seconds per fuzz test
+    // - fuzz_corpus_dir: corpora are read from (and new inputs written to) <dir>/<test name>/
+    // - fuzz_jobs: number of forked exploration workers (0 = one per hardware thread)
+    //   a single job explores in-process: a crash ends the run and its input is saved as reproducer without minimizing
+    // - fuzz_minimize_corpus: instead of fuzzing, shrink each corpus to a subset with the same coverage
+    // - fuzz_cost: exploration also searches for slow inputs and reports the most expensive ones
+    bool fuzz = false;
+    double fuzz_seconds = 60.0;
+    int fuzz_jobs = 1;
+    bool fuzz_minimize_corpus = false;
+    fuzz_cost_metric fuzz_cost = fuzz_cost_metric::none;
+    std::string fuzz_corpus_dir;
+
+    // threads working on parallel tasks of tests (nx::parallel_for, nx::task_group, PROPERTY cases)
+    // they share one worker pool (0 = one thread per hardware thread)
+    int jobs = 0;
+
+    // PROPERTY behavior
+    // - property_cases: generated inputs per property
+    // - property_jobs: cases evaluated in parallel on the worker pool (0 = all workers)
+    int property_cases = 100;
+    int property_jobs = 1;
+
+    // INTERLEAVINGS behavior
+    // - interleavings: schedules explored per runner (unless set in its nx::sched::options)
+    int interleavings = 1000;
+
     static test_schedule_config create_from_args(int argc, char** argv);
 };
 
@@ -7,7 +7,8 @@ namespace nx::impl
 {
 struct raii_section_opener
 {
-    explicit raii_section_opener(bool is_opened);
+    // is_traced: a trace span was begun for the section and is ended with it
+    explicit raii_section_opener(bool is_opened, bool is_traced = false);
     raii_section_opener(raii_section_opener&&) = delete;
     raii_section_opener(raii_section_opener const&) = delete;
     raii_section_opener& operator=(raii_section_opener&&) = delete;
@@ -18,6 +19,7 @@ struct raii_section_opener
 
 private:
     bool _is_opened = false;
+    bool _is_traced = false;
 };
 
 // true if this section should be explored
@@ -0,0 +1,185 @@
+#include "timer.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <time.h>
+#define NX_IMPL_HAS_CLOCK_GETTIME 1
+#else
+#define NX_IMPL_HAS_CLOCK_GETTIME 0
+#endif
+
+#if NX_IMPL_HAS_TSC && (defined(__GNUC__) || defined(__clang__))
+#include <cpuid.h>
+#endif
+
+namespace
+{
+thread_local nx::stopwatch* g_active_stopwatch = nullptr;
+
+struct tick_calibration
+{
+    double seconds_per_tick = 1e-9;
+    nx::tick_clock::ticks overhead = 0;
+};
+
+tick_calibration calibrate()
+{
+    tick_calibration result;
+
+    if (nx::tick_clock::is_tsc())
+    {
+        // measure TSC against the monotonic clock for a short busy interval
+        // 20ms keeps the relative error well below 0.1% while being unnoticeable at startup
+        auto const ns_start = nx::impl::read_monotonic_ns();
+        auto const tsc_start = nx::tick_clock::now();
+        auto ns_end = ns_start;
+        while (ns_end - ns_start < 20'000'000)
+            ns_end = nx::impl::read_monotonic_ns();
+        auto const tsc_end = nx::tick_clock::now_ordered();
+
+        result.seconds_per_tick = double(ns_end - ns_start) * 1e-9 / double(tsc_end - tsc_start);
+    }
+
+    // the minimum is the most stable estimate (no interrupts, no migrations)
+    auto overhead = ~nx::tick_clock::ticks(0);
+    for (auto i = 0; i < 1000; ++i)
+    {
+        auto const t0 = nx::tick_clock::now();
+        auto const t1 = nx::tick_clock::now_ordered();
+        overhead = std::min(overhead, t1 - t0);
+    }
+    result.overhead = overhead;
+
+    return result;
+}
+
+tick_calibration const& get_calibration()
+{
+    static tick_calibration const calibration = calibrate();
+    return calibration;
+}
+} // namespace
+
+bool nx::impl::detect_invariant_tsc()
+{
+#if NX_IMPL_HAS_TSC && (defined(__GNUC__) || defined(__clang__))
+    // CPUID.80000007H:EDX[8] - TSC runs at a constant rate in all ACPI P-, C- and T-states
+    unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) == 0 || eax < 0x80000007)
+        return false;
+    if (__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) == 0)
+        return false;
+    if ((edx & (1u << 8)) == 0)
+        return false;
+
+    // rdtscp is required for ordered interval ends: CPUID.80000001H:EDX[27]
+    if (__get_cpuid(0x80000001, &eax, &ebx, &ecx, &edx) == 0)
+        return false;
+    return (edx & (1u << 27)) != 0;
+#elif NX_IMPL_HAS_TSC
+    int regs[4] = {};
+    __cpuid(regs, int(0x80000000));
+    if (unsigned(regs[0]) < 0x80000007)
+        return false;
+    __cpuid(regs, int(0x80000007));
+    if ((unsigned(regs[3]) & (1u << 8)) == 0)
+        return false;
+    __cpuid(regs, int(0x80000001));
+    return (unsigned(regs[3]) & (1u << 27)) != 0;
+#else
+    return false;
+#endif
+}
+
+std::uint64_t nx::impl::read_monotonic_ns()
+{
+#if NX_IMPL_HAS_CLOCK_GETTIME
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return std::uint64_t(ts.tv_sec) * 1'000'000'000u + std::uint64_t(ts.tv_nsec);
+#else
+    return std::uint64_t(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+std::uint64_t nx::impl::read_thread_cpu_ns()
+{
+#if NX_IMPL_HAS_CLOCK_GETTIME
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return std::uint64_t(ts.tv_sec) * 1'000'000'000u + std::uint64_t(ts.tv_nsec);
+#else
+    // no portable per-thread CPU clock, wall time is the closest approximation
+    return read_monotonic_ns();
+#endif
+}
+
+double nx::tick_clock::seconds_per_tick() { return get_calibration().seconds_per_tick; }
+
+nx::tick_clock::ticks nx::tick_clock::overhead() { return get_calibration().overhead; }
+
+void nx::stopwatch::start()
+{
+    // calibrate before the first segment starts so it is not measured
+    (void)tick_clock::overhead();
+
+    _accumulated = 0;
+    _accumulated_cpu_ns = 0;
+    _is_running = true;
+    if (_tracks_cpu_time)
+        _segment_start_cpu_ns = impl::read_thread_cpu_ns();
+    _segment_start = tick_clock::now();
+}
+
+void nx::stopwatch::pause()
+{
+    if (!_is_running)
+        return;
+
+    auto const end = tick_clock::now_ordered();
+    auto const segment = end - _segment_start;
+    auto const overhead = tick_clock::overhead();
+    _accumulated += segment > overhead ? segment - overhead : 0;
+    if (_tracks_cpu_time)
+        _accumulated_cpu_ns += impl::read_thread_cpu_ns() - _segment_start_cpu_ns;
+    _is_running = false;
+}
+
+void nx::stopwatch::resume()
+{
+    if (_is_running)
+        return;
+
+    _is_running = true;
+    if (_tracks_cpu_time)
+        _segment_start_cpu_ns = impl::read_thread_cpu_ns();
+    _segment_start = tick_clock::now();
+}
+
+nx::tick_clock::ticks nx::stopwatch::elapsed_ticks() const
+{
+    if (!_is_running)
+        return _accumulated;
+
+    auto const segment = tick_clock::now_ordered() - _segment_start;
+    auto const overhead = tick_clock::overhead();
+    return _accumulated + (segment > overhead ? segment - overhead : 0);
+}
+
+void nx::pause_timer()
+{
+    if (g_active_stopwatch != nullptr)
+        g_active_stopwatch->pause();
+}
+
+void nx::resume_timer()
+{
+    if (g_active_stopwatch != nullptr)
+        g_active_stopwatch->resume();
+}
+
+nx::stopwatch* nx::impl::set_active_stopwatch(stopwatch* sw) { return std::exchange(g_active_stopwatch, sw); }
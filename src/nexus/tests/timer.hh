@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define NX_IMPL_HAS_TSC 1
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define NX_IMPL_HAS_TSC 1
+#else
+#define NX_IMPL_HAS_TSC 0
+#endif
+
+namespace nx::impl
+{
+// true if the invariant TSC can be used as tick source (detected once)
+bool detect_invariant_tsc();
+
+// fallback tick source: monotonic nanoseconds
+std::uint64_t read_monotonic_ns();
+
+// CPU time consumed by the calling thread in nanoseconds
+std::uint64_t read_thread_cpu_ns();
+} // namespace nx::impl
+
+namespace nx
+{
+// low-overhead monotonic tick source for timing tests and benchmarks
+// - uses rdtsc/rdtscp when the CPU reports an invariant TSC
+// - falls back to clock_gettime(CLOCK_MONOTONIC) otherwise (ticks are then nanoseconds)
+// - tick frequency and the cost of reading the clock are calibrated once on first use
+struct tick_clock
+{
+    using ticks = std::uint64_t;
+
+    [[nodiscard]] static bool is_tsc()
+    {
+        static bool const uses_tsc = impl::detect_invariant_tsc();
+        return uses_tsc;
+    }
+
+    // start of a measured interval
+    [[nodiscard]] static ticks now()
+    {
+#if NX_IMPL_HAS_TSC
+        if (is_tsc())
+            return __rdtsc();
+#endif
+        return impl::read_monotonic_ns();
+    }
+
+    // end of a measured interval
+    // rdtscp waits until all previous instructions have executed
+    [[nodiscard]] static ticks now_ordered()
+    {
+#if NX_IMPL_HAS_TSC
+        if (is_tsc())
+        {
+            unsigned aux;
+            return __rdtscp(&aux);
+        }
+#endif
+        return impl::read_monotonic_ns();
+    }
+
+    [[nodiscard]] static double seconds_per_tick();
+
+    // ticks measured for an empty now() .. now_ordered() interval
+    // this is subtracted once per measured interval
+    [[nodiscard]] static ticks overhead();
+
+    [[nodiscard]] static double to_seconds(ticks t) { return double(t) * seconds_per_tick(); }
+};
+
+// pausable interval timer
+// each start/resume .. pause segment has the calibrated clock overhead subtracted
+// optionally also accumulates thread CPU time over the same segments (costs a clock_gettime per segment)
+struct stopwatch
+{
+    stopwatch() = default;
+    explicit stopwatch(bool tracks_cpu_time) : _tracks_cpu_time(tracks_cpu_time) {}
+
+    void start();
+    void pause();
+    void resume();
+
+    [[nodiscard]] bool is_running() const { return _is_running; }
+
+    // includes the currently running segment
+    [[nodiscard]] tick_clock::ticks elapsed_ticks() const;
+    [[nodiscard]] double elapsed_seconds() const { return tick_clock::to_seconds(elapsed_ticks()); }
+
+    // only valid if constructed with tracks_cpu_time, excludes the currently running segment
+    [[nodiscard]] double elapsed_cpu_seconds() const { return double(_accumulated_cpu_ns) * 1e-9; }
+
+private:
+    tick_clock::ticks _accumulated = 0;
+    tick_clock::ticks _segment_start = 0;
+    std::uint64_t _accumulated_cpu_ns = 0;
+    std::uint64_t _segment_start_cpu_ns = 0;
+    bool _is_running = false;
+    bool _tracks_cpu_time = false;
+};
+
+// excludes code from the timing of the current benchmark or test section
+// - affects the innermost active timer of this thread (benchmark > section)
+// - no-op outside of test execution
+void pause_timer();
+void resume_timer();
+
+// usage:
+//   {
+//       auto _ = nx::scoped_timer_pause();
+//       data = make_input(); // not timed
+//   }
+struct scoped_timer_pause
+{
+    scoped_timer_pause() { pause_timer(); }
+    scoped_timer_pause(scoped_timer_pause&&) = delete;
+    scoped_timer_pause(scoped_timer_pause const&) = delete;
+    scoped_timer_pause& operator=(scoped_timer_pause&&) = delete;
+    scoped_timer_pause& operator=(scoped_timer_pause const&) = delete;
+    ~scoped_timer_pause() { resume_timer(); }
+};
+
+} // namespace nx
+
+namespace nx::impl
+{
+// innermost timer that pause_timer() / resume_timer() act on
+// returns the previously active one so nested scopes can restore it
+stopwatch* set_active_stopwatch(stopwatch* sw);
+
+struct scoped_active_stopwatch
+{
+    explicit scoped_active_stopwatch(stopwatch& sw) : _prev(set_active_stopwatch(&sw)) {}
+    scoped_active_stopwatch(scoped_active_stopwatch&&) = delete;
+    scoped_active_stopwatch(scoped_active_stopwatch const&) = delete;
+    scoped_active_stopwatch& operator=(scoped_active_stopwatch&&) = delete;
+    scoped_active_stopwatch& operator=(scoped_active_stopwatch const&) = delete;
+    ~scoped_active_stopwatch() { set_active_stopwatch(_prev); }
+
+private:
+    stopwatch* _prev = nullptr;
+};
+} // namespace nx::impl
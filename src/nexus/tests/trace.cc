@@ -0,0 +1,204 @@
+#include "trace.hh"
+
+#include <nexus/tests/json.hh>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <format>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#define NX_IMPL_HAS_GETPID 1
+#else
+#define NX_IMPL_HAS_GETPID 0
+#endif
+
+namespace
+{
+struct trace_event
+{
+    std::string name;
+    std::string category;
+    std::int64_t start_ns = 0;
+    std::int64_t end_ns = 0;
+};
+
+struct open_span
+{
+    std::string name;
+    std::string category;
+    std::int64_t start_ns = 0;
+};
+
+// only written by its own thread, read once all threads are done
+struct thread_buffer
+{
+    int tid = 0;
+    std::string name;
+    std::vector<trace_event> events;
+    std::vector<open_span> open_spans;
+};
+
+std::atomic<bool> g_is_tracing = false;
+
+std::mutex g_mutex;
+std::vector<std::shared_ptr<thread_buffer>> g_buffers; // kept alive beyond the end of their threads
+std::vector<std::string> g_imported_events;            // of forked processes, already as JSON
+std::string g_process_name = "nexus";
+int g_next_tid = 1;
+
+int process_id()
+{
+#if NX_IMPL_HAS_GETPID
+    return int(getpid());
+#else
+    return 0;
+#endif
+}
+
+std::int64_t now_ns()
+{
+    auto const t = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t).count();
+}
+
+thread_buffer& current_buffer()
+{
+    thread_local std::shared_ptr<thread_buffer> buffer;
+    if (buffer == nullptr)
+    {
+        buffer = std::make_shared<thread_buffer>();
+        auto _ = std::lock_guard(g_mutex);
+        buffer->tid = g_next_tid++;
+        g_buffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+// comma separated JSON objects of this process (without the imported ones)
+std::string format_events()
+{
+    auto const pid = process_id();
+    auto result = std::format(R"({{"name": "process_name", "ph": "M", "pid": {}, "tid": 0, "args": {{"name": "{}"}}}})",
+                              pid, nx::impl::json_escape(g_process_name));
+
+    auto _ = std::lock_guard(g_mutex);
+    for (auto const& buffer : g_buffers)
+    {
+        if (buffer->events.empty())
+            continue;
+
+        if (!buffer->name.empty())
+            result += std::format(R"(,
+{{"name": "thread_name", "ph": "M", "pid": {}, "tid": {}, "args": {{"name": "{}"}}}})",
+                                  pid, buffer->tid, nx::impl::json_escape(buffer->name));
+
+        for (auto const& e : buffer->events)
+            result += std::format(R"(,
+{{"name": "{}", "cat": "{}", "ph": "X", "ts": {:.3f}, "dur": {:.3f}, "pid": {}, "tid": {}}})",
+                                  nx::impl::json_escape(e.name), nx::impl::json_escape(e.category),
+                                  double(e.start_ns) / 1e3, double(e.end_ns - e.start_ns) / 1e3, pid, buffer->tid);
+    }
+    return result;
+}
+} // namespace
+
+nx::trace_scope::trace_scope(std::string_view name, std::string_view category)
+{
+    if (!impl::is_tracing())
+        return;
+
+    impl::trace_begin(name, category);
+    _is_active = true;
+}
+
+nx::trace_scope::~trace_scope()
+{
+    if (_is_active)
+        impl::trace_end();
+}
+
+void nx::impl::start_tracing() { g_is_tracing = true; }
+
+void nx::impl::stop_tracing() { g_is_tracing = false; }
+
+bool nx::impl::is_tracing() { return g_is_tracing.load(std::memory_order_relaxed); }
+
+void nx::impl::trace_begin(std::string_view name, std::string_view category)
+{
+    if (!is_tracing())
+        return;
+
+    current_buffer().open_spans.push_back({
+        .name = std::string(name),
+        .category = std::string(category),
+        .start_ns = now_ns(),
+    });
+}
+
+void nx::impl::trace_end()
+{
+    if (!is_tracing())
+        return;
+
+    auto& buffer = current_buffer();
+    if (buffer.open_spans.empty())
+        return; // opened before tracing started or before a fork
+
+    auto& span = buffer.open_spans.back();
+    buffer.events.push_back({
+        .name = std::move(span.name),
+        .category = std::move(span.category),
+        .start_ns = span.start_ns,
+        .end_ns = now_ns(),
+    });
+    buffer.open_spans.pop_back();
+}
+
+void nx::impl::trace_set_thread_name(std::string_view name)
+{
+    if (is_tracing())
+        current_buffer().name = name;
+}
+
+void nx::impl::trace_restart_in_child(std::string_view process_name)
+{
+    if (!is_tracing())
+        return;
+
+    auto _ = std::lock_guard(g_mutex);
+    g_process_name = process_name;
+    g_imported_events.clear();
+    for (auto const& buffer : g_buffers)
+    {
+        buffer->events.clear();
+        buffer->open_spans.clear();
+    }
+}
+
+std::string nx::impl::trace_export_events() { return is_tracing() ? format_events() : std::string(); }
+
+void nx::impl::trace_import_events(std::string_view events)
+{
+    if (events.empty())
+        return;
+
+    auto _ = std::lock_guard(g_mutex);
+    g_imported_events.emplace_back(events);
+}
+
+void nx::impl::write_trace_json(std::ostream& out)
+{
+    out << "{\"traceEvents\": [\n" << format_events();
+    {
+        auto _ = std::lock_guard(g_mutex);
+        for (auto const& events : g_imported_events)
+            out << ",\n" << events;
+    }
+    out << "\n],\n\"displayTimeUnit\": \"ms\"}\n";
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+namespace nx
+{
+// a zone in the --trace-out timeline, from construction to destruction
+// - does nothing (beyond one relaxed load) unless tracing is enabled
+// - may be used on any thread, nesting is per thread
+//
+// usage:
+//   {
+//       auto _ = nx::trace_scope("build index");
+//       ...
+//   }
+struct trace_scope
+{
+    explicit trace_scope(std::string_view name, std::string_view category = "user");
+    trace_scope(trace_scope&&) = delete;
+    trace_scope(trace_scope const&) = delete;
+    trace_scope& operator=(trace_scope&&) = delete;
+    trace_scope& operator=(trace_scope const&) = delete;
+    ~trace_scope();
+
+private:
+    bool _is_active = false;
+};
+} // namespace nx
+
+namespace nx::impl
+{
+// timeline of the test run in Chrome's trace event format (chrome://tracing, ui.perfetto.dev)
+// - every thread records into its own buffer, spans are complete ("X") events with microsecond timestamps
+// - timestamps use the monotonic clock, so events of forked processes line up with the parent's
+void start_tracing();
+void stop_tracing(); // recorded events are kept
+[[nodiscard]] bool is_tracing();
+
+// opens / closes a span on the current thread (no-op unless tracing)
+// categories group spans in the viewer, e.g. "test", "pass", "section", "user"
+void trace_begin(std::string_view name, std::string_view category);
+void trace_end();
+
+// shown instead of the thread id in the viewer
+void trace_set_thread_name(std::string_view name);
+
+// forked processes: drops the parent's events in the child and records under the child's pid from then on
+// the child hands its events to the parent via trace_export_events / trace_import_events
+void trace_restart_in_child(std::string_view process_name);
+[[nodiscard]] std::string trace_export_events();
+void trace_import_events(std::string_view events);
+
+// writes {"traceEvents": [...]} with the events of all threads (which must not be recording anymore)
+void write_trace_json(std::ostream& out);
+} // namespace nx::impl
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <nexus/fuzz.hh>
+#include <nexus/fuzz/engine.hh>
+#include <nexus/tests/config.hh>
+#include <nexus/tests/execute.hh>
+#include <nexus/tests/registry.hh>
+#include <nexus/tests/schedule.hh>
+
+#include <functional>
+#include <source_location>
+#include <string>
+#include <vector>
+
+// fixture for tests of the test framework itself: failures of the inner test don't fail the outer one
+
+struct only_test_options
+{
+    std::string name = "only test";
+    nx::config::cfg test_config = {};
+    nx::test_schedule_config schedule_config = {};
+};
+
+// runs fn as the only test of a local registry and returns the execution of the whole schedule (e.g. for its counts)
+inline nx::test_schedule_execution run_in_registry(std::move_only_function<void()> fn, only_test_options const& options = {})
+{
+    nx::test_registry reg;
+    reg.add_declaration(options.name, options.test_config, std::move(fn));
+    auto schedule = nx::test_schedule::create({}, reg);
+    return nx::execute_tests(schedule, options.schedule_config);
+}
+
+// runs fn as the only test of a local registry and returns its execution
+inline nx::test_execution run_as_only_test(std::move_only_function<void()> fn, only_test_options const& options = {})
+{
+    return run_in_registry(std::move(fn), options).executions[0];
+}
+
+// a test consisting of the fuzz target fn, named "fuzz target" (its corpus directory is "fuzz_target")
+inline nx::test_schedule_execution run_fuzz_in_registry(nx::impl::fuzz_function fn, nx::test_schedule_config const& config)
+{
+    return run_in_registry(
+        [fn = std::move(fn)]
+        {
+            nx::impl::run_fuzz_target({
+                .name = "fuzz target",
+                .test_config = {},
+                .location = std::source_location::current(),
+                .fn = fn,
+            });
+        },
+        {.name = "fuzz target", .schedule_config = config});
+}
+
+// a test consisting of the FUZZ_DIFF comparison fn, named "fuzz diff"
+inline nx::test_schedule_execution run_fuzz_diff_in_registry(nx::impl::fuzz_diff_function fn,
+                                                             nx::test_schedule_config const& config)
+{
+    return run_in_registry([fn = std::move(fn)]
+                           { nx::impl::run_fuzz_diff("fuzz diff", {}, fn, std::source_location::current()); },
+                           {.name = "fuzz diff", .schedule_config = config});
+}
+
+// the extra lines of all errors, in order
+inline std::vector<std::string> extra_lines_of(nx::test_execution const& exec)
+{
+    std::vector<std::string> lines;
+    for (auto const& error : exec.errors)
+        for (auto line : error.extra_lines)
+            lines.emplace_back(line);
+    return lines;
+}
@@ -0,0 +1,185 @@
+#include "only-test.hh"
+
+#include <nexus/test.hh>
+#include <nexus/tests/benchmark_report.hh>
+#include <nexus/tests/execute.hh>
+#include <nexus/tests/timer.hh>
+
+#include <chrono>
+#include <numeric>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+void busy_wait_seconds(double seconds)
+{
+    auto const start = nx::tick_clock::now();
+    while (nx::tick_clock::to_seconds(nx::tick_clock::now() - start) < seconds)
+    {
+    }
+}
+} // namespace
+
+TEST("timer - tick clock is calibrated and monotonic")
+{
+    CHECK(nx::tick_clock::seconds_per_tick() > 0.0);
+
+    auto const t0 = nx::tick_clock::now();
+    auto const t1 = nx::tick_clock::now_ordered();
+    CHECK(t1 >= t0);
+
+    // the overhead of reading the clock is small
+    CHECK(nx::tick_clock::to_seconds(nx::tick_clock::overhead()) < 1e-5);
+}
+
+TEST("timer - paused time is excluded")
+{
+    nx::stopwatch sw;
+    sw.start();
+    sw.pause();
+    CHECK(!sw.is_running());
+
+    busy_wait_seconds(0.005);
+
+    sw.resume();
+    CHECK(sw.is_running());
+    sw.pause();
+
+    CHECK(sw.elapsed_seconds() < 0.001);
+}
+
+TEST("timer - pause_timer outside of an active timer is a no-op")
+{
+    nx::pause_timer();
+    nx::resume_timer();
+    {
+        auto _ = nx::scoped_timer_pause();
+    }
+    SUCCEED();
+}
+
+TEST("benchmark - result is recorded and counts as a check")
+{
+    auto exec = run_in_registry(
+        []
+        {
+            std::vector<int> v(100, 1);
+            BENCHMARK("sum {}", v.size()) { return std::accumulate(v.begin(), v.end(), 0); };
+        },
+        {.name = "bench only"});
+
+    REQUIRE(exec.executions.size() == 1);
+    REQUIRE(exec.executions[0].benchmarks.size() == 1);
+
+    auto const& bench = exec.executions[0].benchmarks[0];
+    CHECK(bench.name == "sum 100");
+    CHECK(bench.iterations > 1);
+    CHECK(bench.real_time_seconds > 0.0);
+
+    CHECK(exec.count_total_checks() == 1);
+    CHECK(exec.count_failed_tests() == 0);
+}
+
+TEST("benchmark - paused setup is excluded from iteration time")
+{
+    auto exec = run_in_registry(
+        []
+        {
+            BENCHMARK("paused setup")(nx::benchmark_state & state)
+            {
+                state.pause_timing();
+                busy_wait_seconds(0.00001);
+                state.resume_timing();
+            };
+        },
+        {.name = "bench with setup"});
+
+    REQUIRE(exec.executions.size() == 1);
+    REQUIRE(exec.executions[0].benchmarks.size() == 1);
+
+    // 10us of setup per iteration must not show up in the measurement
+    CHECK(exec.executions[0].benchmarks[0].real_time_per_iteration() < 0.000005);
+}
+
+TEST("benchmark - counters and cpu time are recorded")
+{
+    auto exec = run_in_registry(
+        []
+        {
+            BENCHMARK("with counters")(nx::benchmark_state & state)
+            {
+                state.counters["items"] = 64;
+                return state.counters.size();
+            };
+        },
+        {.name = "bench counters"});
+
+    REQUIRE(exec.executions.size() == 1);
+    REQUIRE(exec.executions[0].benchmarks.size() == 1);
+
+    auto const& bench = exec.executions[0].benchmarks[0];
+    CHECK(bench.cpu_time_seconds > 0.0);
+    REQUIRE(bench.counters.contains("items"));
+    CHECK(bench.counters.at("items") == 64);
+}
+
+TEST("benchmark - google benchmark json export")
+{
+    nx::test_schedule_execution execution;
+    auto& exec = execution.executions.emplace_back();
+    exec.benchmarks.push_back({
+        .name = "BM_\"quoted\"",
+        .iterations = 1000,
+        .real_time_seconds = 0.002,
+        .cpu_time_seconds = 0.001,
+        .counters = {{"bytes", 4096}},
+        .resources = {.minor_page_faults = 500},
+    });
+
+    auto context = nx::benchmark_context::collect("nexus-test");
+    context.caches = {{.type = "Data", .level = 1, .size = 32768, .num_sharing = 2}};
+
+    std::ostringstream out;
+    nx::write_benchmark_json(out, context, execution);
+    auto const json = out.str();
+
+    CHECK(json.contains("\"context\": {"));
+    CHECK(json.contains("\"executable\": \"nexus-test\""));
+    CHECK(json.contains("\"type\": \"Data\""));
+    CHECK(json.contains("\"size\": 32768"));
+    CHECK(json.contains("\"name\": \"BM_\\\"quoted\\\"\""));
+    CHECK(json.contains("\"iterations\": 1000"));
+    CHECK(json.contains("\"real_time\": 2000"));
+    CHECK(json.contains("\"cpu_time\": 1000"));
+    CHECK(json.contains("\"time_unit\": \"ns\""));
+    CHECK(json.contains("\"bytes\": 4096"));
+    CHECK(json.contains("\"minor_page_faults\": 0.5"));
+}
+
+TEST("benchmark - resource usage is recorded per test")
+{
+    auto const result = run_in_registry(
+        []
+        {
+            // fresh pages are mapped on first touch, i.e. with a minor page fault each
+            std::vector<char> memory(16 << 20);
+            for (size_t i = 0; i < memory.size(); i += 4096)
+                memory[i] = char(i);
+            CHECK(memory[4096] == char(4096));
+
+            busy_wait_seconds(0.01);
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        },
+        {.name = "touches memory and sleeps"});
+    REQUIRE(result.executions.size() == 1);
+
+#if defined(__linux__)
+    auto const& res = result.executions[0].resources;
+    CHECK(res.minor_page_faults >= 1000);
+    CHECK(res.voluntary_context_switches >= 1);
+    CHECK(res.user_cpu_seconds + res.system_cpu_seconds > 0.0);
+    CHECK(nx::to_string(res).contains("minor"));
+#endif
+}
@@ -0,0 +1,150 @@
+#include "only-test.hh"
+
+#include <nexus/test.hh>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+
+TEST("concurrent - checks of all threads and iterations count", concurrent(4, 25))
+{
+    CHECK(nx::concurrent_thread_index() >= 0);
+    CHECK(nx::concurrent_thread_index() < 4);
+    CHECK(nx::concurrent_iteration() >= 0);
+    CHECK(nx::concurrent_iteration() < 25);
+}
+
+TEST("concurrent - outside of concurrent tests")
+{
+    CHECK(nx::concurrent_thread_index() == -1);
+    CHECK(nx::concurrent_iteration() == -1);
+    CHECK(nx::concurrent_seed() == 0u);
+}
+
+TEST("concurrent - every thread runs every iteration")
+{
+    std::atomic<int> runs = 0;
+    auto const exec = run_as_only_test(
+        [&]
+        {
+            ++runs;
+            CHECK(true);
+        },
+        {.test_config = nx::impl::merge_config(nx::config::concurrent(8, 50))});
+
+    CHECK(runs == 8 * 50);
+    CHECK(exec.root.executed_checks == 8 * 50);
+    CHECK(exec.root.failed_checks == 0);
+    CHECK(!exec.is_considered_failing());
+}
+
+TEST("concurrent - seeds differ per thread and iteration")
+{
+    std::mutex mutex;
+    std::set<std::pair<int, int>> indices;
+    std::set<std::uint64_t> seeds;
+    auto const exec = run_as_only_test(
+        [&]
+        {
+            auto lock = std::lock_guard(mutex);
+            indices.emplace(nx::concurrent_thread_index(), nx::concurrent_iteration());
+            seeds.insert(nx::concurrent_seed());
+        },
+        {.test_config = nx::impl::merge_config(nx::config::concurrent(4, 10))});
+
+    CHECK(indices.size() == 40u);
+    CHECK(seeds.size() == 40u);
+
+    // deterministic per test
+    std::set<std::uint64_t> seeds_again;
+    run_as_only_test(
+        [&]
+        {
+            auto lock = std::lock_guard(mutex);
+            seeds_again.insert(nx::concurrent_seed());
+        },
+        {.test_config = nx::impl::merge_config(nx::config::concurrent(4, 10))});
+    CHECK(seeds == seeds_again);
+}
+
+TEST("concurrent - a failure stops further iterations")
+{
+    std::atomic<int> runs = 0;
+    auto const exec = run_as_only_test(
+        [&]
+        {
+            ++runs;
+            CHECK(!(nx::concurrent_iteration() == 3 && nx::concurrent_thread_index() == 2));
+        },
+        {.test_config = nx::impl::merge_config(nx::config::concurrent(4, 100))});
+
+    CHECK(runs == 4 * 4);
+    CHECK(exec.root.executed_checks == 4 * 4);
+    CHECK(exec.root.failed_checks == 1);
+    REQUIRE(exec.errors.size() == 1);
+    CHECK(std::ranges::any_of(exec.errors[0].extra_lines, [](std::string_view line)
+                              { return line.starts_with("in iteration 3 of 100 on thread 2 of 4"); }));
+    CHECK(exec.is_considered_failing());
+}
+
+TEST("concurrent - REQUIRE ends the body of its thread only")
+{
+    std::atomic<int> after_require = 0;
+    std::atomic<int> other_threads = 0;
+    auto const exec = run_as_only_test(
+        [&]
+        {
+            if (nx::concurrent_thread_index() == 0)
+            {
+                REQUIRE(false);
+                ++after_require;
+            }
+            else
+                ++other_threads;
+        },
+        {.test_config = nx::impl::merge_config(nx::config::concurrent(3, 5))});
+
+    CHECK(after_require == 0);
+    CHECK(other_threads == 2); // only the first iteration ran
+    CHECK(exec.root.failed_checks == 1);
+    REQUIRE(exec.errors.size() == 1);
+    CHECK(std::ranges::none_of(exec.errors[0].extra_lines, [](std::string_view line)
+                               { return line.starts_with("REQUIRE failed on a thread"); }));
+}
+
+TEST("concurrent - failures beyond the caps keep their kind")
+{
+    nx::test_schedule_config config;
+    config.max_failures_per_location = 1;
+    auto const exec = run_as_only_test([] { REQUIRE(false); },
+                                       {.test_config = nx::impl::merge_config(nx::config::concurrent(4, 1)),
+                                        .schedule_config = config});
+
+    CHECK(exec.root.failed_checks == 4);
+    REQUIRE(exec.errors.size() == 2);
+    CHECK(exec.errors[0].expanded.starts_with("REQUIRE at test-concurrent-test.cc:"));
+    CHECK(exec.errors[0].expanded.ends_with(" failed 3 more times"));
+}
+
+TEST("concurrent - SECTION in a body is a usage error")
+{
+    std::atomic<int> entered = 0;
+    auto const exec = run_as_only_test(
+        [&]
+        {
+            SECTION("inner")
+            {
+                ++entered;
+            }
+            CHECK(true);
+        },
+        {.test_config = nx::impl::merge_config(nx::config::concurrent(2, 1))});
+
+    CHECK(entered == 0);
+    CHECK(exec.is_considered_failing());
+    REQUIRE(exec.errors.size() == 2); // one per thread
+    CHECK(exec.errors[0].expanded == "section \"inner\" opened on a thread not running the test");
+}
@@ -0,0 +1,165 @@
+#include "only-test.hh"
+
+#include <nexus/test.hh>
+
+#include <algorithm>
+#include <format>
+#include <list>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+std::vector<std::string> check_errors(std::move_only_function<void()> fn)
+{
+    return extra_lines_of(run_as_only_test(std::move(fn), {.name = "container diff"}));
+}
+
+bool contains(std::vector<std::string> const& lines, std::string_view line)
+{
+    return std::ranges::find(lines, line) != lines.end();
+}
+} // namespace
+
+TEST("container diff - edit script of sequences")
+{
+    std::vector<nx::impl::diff_edit> edits;
+    std::string_view const a = "ABCABBA";
+    std::string_view const b = "CBABAC";
+    REQUIRE(nx::impl::find_edit_script(a.size(), b.size(), [&](size_t i, size_t j) { return a[i] == b[j]; }, 100, edits));
+    CHECK(edits.size() == 5); // the example of Myers' paper
+
+    // applying the script to a yields b
+    std::string result;
+    size_t i = 0;
+    for (auto const& e : edits)
+    {
+        result.append(a.substr(i, e.lhs_index - i));
+        i = e.lhs_index;
+        if (e.is_insert)
+            result += b[e.rhs_index];
+        else
+            ++i;
+    }
+    result.append(a.substr(i));
+    CHECK(result == b);
+
+    CHECK(!nx::impl::find_edit_script(a.size(), b.size(), [&](size_t i, size_t j) { return a[i] == b[j]; }, 4, edits));
+}
+
+TEST("container diff - large vectors are dumped and diffed bounded")
+{
+    auto const lines = check_errors(
+        []
+        {
+            std::vector<int> a(1'000'000);
+            for (auto i = 0; i < int(a.size()); ++i)
+                a[i] = i;
+            auto b = a;
+            b.erase(b.begin() + 500'000);
+            b.insert(b.begin() + 10, -1);
+            CHECK(a == b);
+        });
+
+    REQUIRE(lines.size() == 5);
+    CHECK(lines[0].starts_with("[0, 1, 2, "));
+    CHECK(lines[0].ends_with(", 999999] (1000000 elements)"));
+    CHECK(lines[1].ends_with("(1000000 elements)"));
+    CHECK(lines[2] == "diff (2 edits, - only in lhs, + only in rhs):");
+    CHECK(lines[3] == "+ rhs[10]: -1");
+    CHECK(lines[4] == "- lhs[500000]: 500000");
+}
+
+TEST("container diff - unrelated sequences fall back to positions")
+{
+    auto const lines = check_errors(
+        []
+        {
+            std::list<int> a(1000, 1);
+            std::list<int> b(1001, 2);
+            CHECK(a == b);
+        });
+
+    REQUIRE(lines.size() == 2 + 2 + nx::impl::max_diff_lines + 1);
+    CHECK(lines[2] == "sizes differ: 1000 vs 1001");
+    CHECK(lines[3] == "more than 128 edits, 1000 elements differ by position:");
+    CHECK(lines[4] == "[0]: 1 vs 2");
+    CHECK(contains(lines, std::format("... {} more ...", 1000 - nx::impl::max_diff_lines)));
+    CHECK(lines.back() == "[999]: 1 vs 2");
+}
+
+TEST("container diff - maps show differing keys")
+{
+    auto const lines = check_errors(
+        []
+        {
+            std::map<int, int> a;
+            for (auto i = 0; i < 100'000; ++i)
+                a[i] = i;
+            auto b = a;
+            b.erase(7);
+            b[42] = 0;
+            b[-1] = -1;
+            CHECK(a == b);
+        });
+
+    REQUIRE(lines.size() == 6);
+    CHECK(lines[2] == "3 keys differ (- only in lhs, + only in rhs, ~ different values):");
+    CHECK(lines[3] == "- 7: 7");
+    CHECK(lines[4] == "~ 42: 42 vs 0");
+    CHECK(lines[5] == "+ -1: -1");
+
+    auto const unordered = check_errors(
+        []
+        {
+            std::unordered_map<std::string, int> a = {{"x", 1}, {"y", 2}};
+            std::unordered_map<std::string, int> b = {{"x", 1}, {"y", 3}};
+            CHECK(a == b);
+        });
+    CHECK(contains(unordered, "~ y: 2 vs 3"));
+}
+
+TEST("container diff - only equality is diffed")
+{
+    auto const lines = check_errors(
+        []
+        {
+            std::vector<int> a = {1, 2, 3};
+            std::vector<int> b = {1, 2, 4};
+            CHECK(a != a);
+            CHECK(a == b);
+        });
+
+    REQUIRE(lines.size() == 2 + 2 + 3);
+    CHECK(lines[0] == "[1, 2, 3]");
+    CHECK(lines[1] == "[1, 2, 3]");
+    CHECK(lines[4] == "diff (2 edits, - only in lhs, + only in rhs):");
+    CHECK(lines[5] == "- lhs[2]: 3");
+    CHECK(lines[6] == "+ rhs[2]: 4");
+}
+
+TEST("container diff - nested and long elements are bounded")
+{
+    auto const lines = check_errors(
+        []
+        {
+            std::vector<std::vector<int>> a = {std::vector<int>(100'000, 1), {2}};
+            auto b = a;
+            b[1] = {3};
+            CHECK(a == b);
+
+            std::vector<std::string> c = {std::string(10'000, 'x')};
+            std::vector<std::string> d = {std::string(10'000, 'y')};
+            CHECK(c == d);
+        });
+
+    // each line stays short no matter how large the elements are
+    CHECK(std::ranges::all_of(lines, [](std::string const& line) { return line.size() < 2 * nx::impl::max_element_chars; }));
+    CHECK(lines[0].starts_with("[[1, 1, 1, "));
+    CHECK(lines[0].contains("] (100000 elements), [2]]"));
+    CHECK(contains(lines, "- lhs[1]: [2]"));
+    CHECK(std::ranges::any_of(lines, [](std::string const& line)
+                              { return line.starts_with("- lhs[0]: ") && line.ends_with(" more chars)"); }));
+}
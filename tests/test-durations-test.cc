@@ -0,0 +1,117 @@
+#include <nexus/test.hh>
+#include <nexus/tests/durations.hh>
+#include <nexus/tests/execute.hh>
+#include <nexus/tests/registry.hh>
+#include <nexus/tests/schedule.hh>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace
+{
+nx::duration_record record(std::string build_id, std::string name, double seconds)
+{
+    return {.build_id = std::move(build_id), .timestamp = 0, .seconds = seconds, .name = std::move(name)};
+}
+} // namespace
+
+TEST("durations - regressions are relative to earlier builds")
+{
+    std::vector<nx::duration_record> history;
+    for (auto i = 0; i < 5; ++i)
+    {
+        history.push_back(record("old", "stable", 0.100));
+        history.push_back(record("old", "regressed", 0.100));
+        history.push_back(record("old", "tiny", 0.001));
+    }
+    history.push_back(record("new", "regressed", 0.100)); // same build, not part of the baseline
+    history.push_back(record("old", "rare", 0.100));
+
+    std::vector<nx::duration_record> const current = {
+        record("new", "stable", 0.105),
+        record("new", "regressed", 0.200),
+        record("new", "tiny", 0.003), // 3x, but below the noise floor
+        record("new", "rare", 0.500), // not enough history
+        record("new", "unknown", 1.0),
+    };
+
+    auto const regressions = nx::impl::find_duration_regressions(history, current);
+    REQUIRE(regressions.size() == 1);
+    CHECK(regressions[0].name == "regressed");
+    CHECK(regressions[0].baseline_seconds == 0.100);
+    CHECK(regressions[0].seconds == 0.200);
+    CHECK(regressions[0].history_runs == 5);
+}
+
+TEST("durations - history round trip with tests and sections")
+{
+    nx::test_registry reg;
+    reg.add_declaration("timed test", {},
+                        []
+                        {
+                            SECTION("outer")
+                            {
+                                SECTION("inner\tname")
+                                {
+                                    CHECK(true);
+                                }
+                            }
+                        });
+    reg.add_declaration("failing test", {}, [] { CHECK(false); });
+
+    auto schedule = nx::test_schedule::create({}, reg);
+    auto const execution = nx::execute_tests(schedule, {});
+
+    auto const build_id = nx::impl::current_build_id();
+    CHECK(!build_id.empty());
+
+    auto const records = nx::impl::collect_duration_records(execution, build_id, 1234);
+    REQUIRE(records.size() == 3);
+    CHECK(records[0].name == "timed test");
+    CHECK(records[1].name == "timed test > outer");
+    CHECK(records[2].name == "timed test > outer > inner name");
+
+    auto const path = std::filesystem::temp_directory_path() / "nexus-durations-test.tsv";
+    std::filesystem::remove(path);
+    REQUIRE(nx::impl::append_duration_history(path, records));
+    REQUIRE(nx::impl::append_duration_history(path, records));
+
+    auto const history = nx::impl::read_duration_history(path);
+    REQUIRE(history.size() == 6);
+    CHECK(history[5].build_id == build_id);
+    CHECK(history[5].timestamp == 1234);
+    CHECK(history[5].name == "timed test > outer > inner name");
+    CHECK(history[0].seconds > 0.0);
+
+    std::filesystem::remove(path);
+}
+
+TEST("durations - catch2 flag value is consumed")
+{
+    char arg0[] = "nexus-test";
+    char arg1[] = "--durations";
+    char arg2[] = "no";
+    char arg3[] = "some filter";
+    char* argv[] = {arg0, arg1, arg2, arg3};
+
+    auto const config = nx::test_schedule_config::create_from_args(4, argv);
+    CHECK(!config.report_durations);
+    REQUIRE(config.filters.size() == 1);
+    CHECK(config.filters[0] == "some filter");
+}
+
+TEST("durations - history file only with an explicit path")
+{
+    char arg0[] = "nexus-test";
+    char arg1[] = "--durations";
+    char arg2[] = "--durations-history=timings.tsv";
+
+    char* without_history[] = {arg0, arg1};
+    auto const config = nx::test_schedule_config::create_from_args(2, without_history);
+    CHECK(config.report_durations);
+    CHECK(config.durations_history_file.empty());
+
+    char* with_history[] = {arg0, arg1, arg2};
+    CHECK(nx::test_schedule_config::create_from_args(3, with_history).durations_history_file == "timings.tsv");
+}
@@ -0,0 +1,429 @@
+#include "only-test.hh"
+
+#include <nexus/fuzz.hh>
+#include <nexus/fuzz/corpus.hh>
+#include <nexus/fuzz/engine.hh>
+#include <nexus/fuzz/mutator.hh>
+#include <nexus/tests/execute.hh>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define NX_TEST_HAS_FORK 1
+#else
+#define NX_TEST_HAS_FORK 0
+#endif
+
+namespace
+{
+// length-prefixed records, returns number of complete records
+int count_records(std::span<std::byte const> data)
+{
+    int count = 0;
+    size_t pos = 0;
+    while (pos < data.size())
+    {
+        auto const len = size_t(data[pos]);
+        if (pos + 1 + len > data.size())
+            break;
+        pos += 1 + len;
+        ++count;
+    }
+    return count;
+}
+
+bool starts_with(std::span<std::byte const> data, std::string_view prefix)
+{
+    return data.size() >= prefix.size() && std::memcmp(data.data(), prefix.data(), prefix.size()) == 0;
+}
+
+size_t count_zeros_reference(std::span<std::byte const> input) { return size_t(std::ranges::count(input, std::byte(0))); }
+
+// stand-in for an optimized version: one load per 8 bytes
+size_t count_zeros_fast(std::span<std::byte const> input)
+{
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 8 <= input.size(); i += 8)
+    {
+        std::uint64_t word;
+        std::memcpy(&word, input.data() + i, 8);
+        for (auto b = 0; b < 8; ++b)
+            count += ((word >> (8 * b)) & 0xff) == 0;
+    }
+    for (; i < input.size(); ++i)
+        count += input[i] == std::byte(0);
+    return count;
+}
+} // namespace
+
+FUZZ_TEST("fuzz - record parser never overreads")(std::span<std::byte const> input)
+{
+    CHECK(count_records(input) <= int(input.size()));
+}
+
+FUZZ_DIFF("fuzz - count zeros word-at-a-time", count_zeros_reference, count_zeros_fast);
+
+TEST("fuzz - passing target is a single passing check")
+{
+    int runs = 0;
+    auto exec = run_fuzz_in_registry([&](std::span<std::byte const> input) { runs += count_records(input) >= 0; }, {});
+
+    CHECK(runs > 1);
+    CHECK(exec.count_total_tests() == 1);
+    CHECK(exec.count_total_checks() == 1);
+    CHECK(exec.count_failed_tests() == 0);
+}
+
+TEST("fuzz - failing input is reported with the input")
+{
+    int runs = 0;
+    auto exec = run_fuzz_in_registry(
+        [&](std::span<std::byte const> input)
+        {
+            ++runs;
+            CHECK(input.size() < 4);
+        },
+        {});
+
+    CHECK(exec.count_failed_tests() == 1);
+    CHECK(exec.count_failed_checks() == 1);
+
+    // fuzzing stops at the first failure, then only tries smaller variants of it
+    int const runs_at_failure = runs;
+    CHECK(runs_at_failure < 256 + 1000);
+
+    REQUIRE(exec.executions.size() == 1);
+    REQUIRE(exec.executions[0].errors.size() == 1);
+    auto const& error = exec.executions[0].errors[0];
+    CHECK(std::ranges::any_of(error.extra_lines, [](std::string_view line) { return line.starts_with("fuzz input (4 bytes)"); }));
+}
+
+TEST("fuzz - exceptions in the target fail the test")
+{
+    auto exec = run_fuzz_in_registry(
+        [](std::span<std::byte const> input)
+        {
+            if (!input.empty())
+                throw std::runtime_error("parse error");
+        },
+        {});
+
+    CHECK(exec.count_failed_tests() == 1);
+}
+
+TEST("fuzz - regression replays the on-disk corpus")
+{
+    auto const corpus_root = std::filesystem::temp_directory_path() / "nexus-test-fuzz-corpus";
+    std::filesystem::remove_all(corpus_root);
+    std::filesystem::create_directories(corpus_root / "fuzz_target");
+    std::ofstream(corpus_root / "fuzz_target" / "known-bug") << "BUG!";
+
+    nx::test_schedule_config config;
+    config.fuzz_corpus_dir = corpus_root.string();
+
+    // unreachable for a few blind mutations, but in the corpus
+    auto exec = run_fuzz_in_registry([](std::span<std::byte const> input) { CHECK(!starts_with(input, "BUG!")); },
+                                     config);
+
+    CHECK(exec.count_failed_tests() == 1);
+
+    std::filesystem::remove_all(corpus_root);
+}
+
+TEST("fuzz - exploration respects the time budget")
+{
+    nx::test_schedule_config config;
+    config.fuzz = true;
+    config.fuzz_seconds = 0.05;
+
+    int runs = 0;
+    auto exec = run_fuzz_in_registry([&](std::span<std::byte const>) { ++runs; }, config);
+
+    CHECK(runs > 256);
+    CHECK(exec.count_failed_tests() == 0);
+}
+
+TEST("fuzz - parallel workers find failures and crashes")
+{
+    nx::test_schedule_config config;
+    config.fuzz = true;
+    config.fuzz_seconds = 2.0;
+    config.fuzz_jobs = 2;
+
+    SECTION("no failure")
+    {
+        config.fuzz_seconds = 0.2;
+        auto exec = run_fuzz_in_registry([](std::span<std::byte const> input) { (void)count_records(input); }, config);
+        CHECK(exec.count_failed_tests() == 0);
+    }
+
+    SECTION("failing check is replayed in the main process")
+    {
+        auto exec = run_fuzz_in_registry([](std::span<std::byte const> input) { CHECK(input.size() < 4); }, config);
+        CHECK(exec.count_failed_tests() == 1);
+        CHECK(exec.count_failed_checks() == 1);
+    }
+
+    SECTION("crashing worker is reported with its input")
+    {
+        auto exec = run_fuzz_in_registry(
+            [](std::span<std::byte const> input)
+            {
+                if (input.size() >= 4)
+                    std::abort();
+            },
+            config);
+        CHECK(exec.count_failed_tests() == 1);
+
+        REQUIRE(exec.executions.size() == 1);
+        REQUIRE(exec.executions[0].errors.size() == 1);
+        auto const& error = exec.executions[0].errors[0];
+        CHECK(error.expanded.contains("crashed with signal"));
+        CHECK(std::ranges::any_of(error.extra_lines, [](std::string_view line) { return line.starts_with("stack signature: "); }));
+
+        // minimized by reproducing the crash in forked processes
+        CHECK(std::ranges::any_of(error.extra_lines, [](std::string_view line) { return line.starts_with("fuzz input (4 bytes)"); }));
+    }
+}
+
+#if NX_TEST_HAS_FORK
+TEST("fuzz - in-process crash saves its input as reproducer")
+{
+    auto const corpus_root = std::filesystem::temp_directory_path() / "nexus-test-fuzz-in-process-crash";
+    std::filesystem::remove_all(corpus_root);
+
+    // the crash takes down the whole process, so the fuzz run happens in a child
+    std::cout << std::flush;
+    auto const pid = fork();
+    if (pid == 0)
+    {
+        auto const null_fd = open("/dev/null", O_WRONLY);
+        dup2(null_fd, STDOUT_FILENO);
+        dup2(null_fd, STDERR_FILENO);
+
+        nx::test_schedule_config config;
+        config.fuzz = true;
+        config.fuzz_seconds = 2.0;
+        config.fuzz_jobs = 1;
+        config.fuzz_corpus_dir = corpus_root.string();
+        (void)run_fuzz_in_registry(
+            [](std::span<std::byte const> input)
+            {
+                if (input.size() >= 4)
+                    std::abort();
+            },
+            config);
+        _exit(0);
+    }
+
+    REQUIRE(pid > 0);
+    auto status = 0;
+    waitpid(pid, &status, 0);
+    CHECK(WIFSIGNALED(status));
+
+    nx::impl::fuzz_corpus const corpus{.dir = corpus_root / "fuzz_target"};
+    auto const files = corpus.list_files();
+    CHECK(std::ranges::count_if(files, nx::impl::fuzz_corpus::is_reproducer) == 1);
+    for (auto const& file_name : files)
+        if (nx::impl::fuzz_corpus::is_reproducer(file_name))
+            CHECK(nx::impl::fuzz_corpus_file(corpus.dir / file_name).data().size() >= 4);
+
+    std::filesystem::remove_all(corpus_root);
+}
+#endif
+
+TEST("fuzz - failing inputs are minimized")
+{
+    CHECK(nx::impl::minimize_input(std::vector<std::byte>(100, std::byte('x')),
+                                   [](std::span<std::byte const> input) { return input.size() >= 3; }, 1000)
+          == std::vector<std::byte>(3, std::byte(0)));
+
+    // the byte that matters survives
+    auto const input = std::vector<std::byte>({std::byte(1), std::byte(2), std::byte(42), std::byte(3)});
+    auto const contains_42 = [](std::span<std::byte const> data) { return std::ranges::find(data, std::byte(42)) != data.end(); };
+    CHECK(nx::impl::minimize_input(input, contains_42, 1000) == std::vector<std::byte>({std::byte(42)}));
+
+    // without budget, the input stays as it is
+    CHECK(nx::impl::minimize_input(input, contains_42, 0) == input);
+}
+
+TEST("fuzz - corpus files are content-hashed")
+{
+    auto const dir = std::filesystem::temp_directory_path() / "nexus-test-fuzz-hashed";
+    std::filesystem::remove_all(dir);
+
+    nx::impl::fuzz_corpus const corpus{.dir = dir};
+    auto const input = std::as_bytes(std::span(std::string_view("hello")));
+
+    auto const name = corpus.add(input);
+    CHECK(name == nx::impl::fuzz_content_hash(input));
+    CHECK(corpus.add(input) == name);
+    CHECK(corpus.add_reproducer(input, "0123") == "crash-0123");
+    CHECK(nx::impl::fuzz_corpus::is_reproducer("crash-0123"));
+
+    // temporaries of concurrent writers are ignored
+    std::ofstream(dir / ".partial.tmp") << "xyz";
+    CHECK(corpus.list_files().size() == 2);
+    CHECK(corpus.list_files().front() == "crash-0123"); // reproducers are replayed first
+
+    // a reproducer of the same bug only replaces a larger one
+    (void)corpus.add_reproducer(std::as_bytes(std::span(std::string_view("hello world"))), "0123");
+    CHECK(nx::impl::fuzz_corpus_file(dir / "crash-0123").data().size() == 5);
+    (void)corpus.add_reproducer(std::as_bytes(std::span(std::string_view("hi"))), "0123");
+    CHECK(nx::impl::fuzz_corpus_file(dir / "crash-0123").data().size() == 2);
+
+    nx::impl::fuzz_corpus_file const file(dir / name);
+    CHECK(file.data().size() == 5);
+    CHECK(starts_with(file.data(), "hello"));
+
+    std::ofstream(dir / "empty").close();
+    nx::impl::fuzz_corpus_file const empty_file(dir / "empty");
+    CHECK(empty_file.data().empty());
+
+    std::filesystem::remove_all(dir);
+}
+
+TEST("fuzz - corpus minimization keeps a small cover")
+{
+    std::vector<std::vector<std::uint32_t>> const features = {
+        {1, 2},       // smaller than 3 and covers what 6 leaves of it
+        {2},          // subsumed by 0
+        {5},          // same feature as 5, but larger
+        {1, 2, 3},    //
+        {},           // no coverage at all
+        {5},          //
+        {3, 4, 6, 7}, // most features, picked first
+    };
+    std::vector<size_t> const sizes = {10, 10, 100, 30, 1, 20, 50};
+
+    auto const cover = nx::impl::minimize_feature_cover(features, sizes);
+    CHECK(cover == std::vector<size_t>({0, 5, 6}));
+}
+
+TEST("fuzz - failing inputs are saved as reproducers")
+{
+    auto const corpus_root = std::filesystem::temp_directory_path() / "nexus-test-fuzz-reproducers";
+    std::filesystem::remove_all(corpus_root);
+
+    nx::test_schedule_config config;
+    config.fuzz_corpus_dir = corpus_root.string();
+
+    auto const target = [](std::span<std::byte const> input) { CHECK(input.size() < 4); };
+
+    auto exec = run_fuzz_in_registry(target, config);
+    REQUIRE(exec.count_failed_tests() == 1);
+    REQUIRE(exec.executions[0].errors.size() == 1);
+    auto const& lines = exec.executions[0].errors[0].extra_lines;
+    CHECK(std::ranges::any_of(lines, [](std::string_view line) { return line.starts_with("reproducer: "); }));
+
+    CHECK(std::ranges::find(lines, std::string("fuzz input (4 bytes): 00 00 00 00")) != lines.end());
+
+    nx::impl::fuzz_corpus const corpus{.dir = corpus_root / "fuzz_target"};
+    auto const files = corpus.list_files();
+    REQUIRE(files.size() == 1);
+    CHECK(nx::impl::fuzz_corpus::is_reproducer(files[0]));
+
+    // other inputs that hit the same bug end up as the same reproducer
+    auto other_config = config;
+    other_config.fuzz = true;
+    other_config.fuzz_seconds = 0.1;
+    other_config.fuzz_jobs = 1;
+    other_config.fuzz_corpus_dir = (corpus_root / "other").string();
+    (void)run_fuzz_in_registry(target, other_config);
+    auto const other_files = nx::impl::fuzz_corpus{.dir = corpus_root / "other" / "fuzz_target"}.list_files();
+    CHECK(std::ranges::count_if(other_files, nx::impl::fuzz_corpus::is_reproducer) == 1);
+    CHECK(std::ranges::find(other_files, files[0]) != other_files.end());
+
+    // the reproducer fails the next regression run right away (the rest of the runs only minimize it)
+    std::vector<size_t> input_sizes;
+    exec = run_fuzz_in_registry(
+        [&](std::span<std::byte const> input)
+        {
+            input_sizes.push_back(input.size());
+            target(input);
+        },
+        config);
+    CHECK(exec.count_failed_tests() == 1);
+    REQUIRE(!input_sizes.empty());
+    CHECK(input_sizes.front() == 4);
+
+    std::filesystem::remove_all(corpus_root);
+}
+
+TEST("fuzz - performance fuzzing climbs towards slow inputs")
+{
+    nx::test_schedule_config config;
+    config.fuzz = true;
+    config.fuzz_seconds = 0.3;
+    config.fuzz_cost = nx::fuzz_cost_metric::wall_time;
+
+    // quadratic in the number of 'a' bytes, like a parser with a backtracking path
+    int max_count = 0;
+    auto exec = run_fuzz_in_registry(
+        [&](std::span<std::byte const> input)
+        {
+            auto const count = int(std::ranges::count(input, std::byte('a')));
+            max_count = std::max(max_count, count);
+            for (auto i = 0; i < count * count * 1000; ++i)
+                nx::impl::do_not_optimize(i);
+        },
+        config);
+
+    CHECK(exec.count_failed_tests() == 0);
+
+    // blind mutation almost never produces this many 'a' bytes
+    CHECK(max_count >= 6);
+}
+
+TEST("fuzz - diff reports differing outputs")
+{
+    auto const reference = [](std::span<std::byte const> input) { return input.size(); };
+    auto const optimized = [](std::span<std::byte const> input) { return input.size() < 5 ? input.size() : 0; };
+
+    auto exec = run_fuzz_diff_in_registry(nx::impl::make_fuzz_diff_function(reference, optimized, std::source_location::current()), {});
+
+    CHECK(exec.count_failed_tests() == 1);
+    REQUIRE(exec.executions[0].errors.size() == 1);
+    auto const& error = exec.executions[0].errors[0];
+    CHECK(error.expr == "optimized(input) == reference(input)");
+    CHECK(std::ranges::any_of(error.extra_lines, [](std::string_view line) { return line.starts_with("reproducer: "); }));
+
+    // the timing of a failed comparison is not reported
+    CHECK(exec.executions[0].benchmarks.empty());
+}
+
+TEST("fuzz - diff reports the speed of both sides")
+{
+    auto const slow_reference = [](std::span<std::byte const> input)
+    {
+        size_t count = 0;
+        for (auto repeat = 0; repeat < 20; ++repeat)
+            count = count_zeros_reference(input);
+        nx::impl::do_not_optimize(count);
+        return count;
+    };
+
+    auto exec = run_fuzz_diff_in_registry(
+        nx::impl::make_fuzz_diff_function(slow_reference, count_zeros_fast, std::source_location::current()), {});
+
+    CHECK(exec.count_failed_tests() == 0);
+    REQUIRE(exec.executions[0].benchmarks.size() == 2);
+    auto const& reference = exec.executions[0].benchmarks[0];
+    auto const& optimized = exec.executions[0].benchmarks[1];
+    CHECK(reference.name == "fuzz diff [reference]");
+    CHECK(optimized.name == "fuzz diff [optimized]");
+    CHECK(reference.iterations > 256);
+    CHECK(optimized.iterations == reference.iterations);
+    CHECK(optimized.counters.contains("speedup"));
+}
@@ -0,0 +1,73 @@
+#include "only-test.hh"
+
+#include <nexus/test.hh>
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+// the info lines of each error
+std::vector<std::vector<std::string>> info_of_errors(std::move_only_function<void()> fn)
+{
+    auto const exec = run_as_only_test(std::move(fn), {.name = "info"});
+
+    std::vector<std::vector<std::string>> result;
+    for (auto const& error : exec.errors)
+        result.emplace_back(error.info.begin(), error.info.end());
+    return result;
+}
+} // namespace
+
+TEST("info - only formatted on failure")
+{
+    auto formatted = 0;
+    auto const describe = [&](int i)
+    {
+        ++formatted;
+        return i;
+    };
+
+    auto const infos = info_of_errors(
+        [&]
+        {
+            for (auto i = 0; i < 1000; ++i)
+            {
+                INFO("iteration {}", describe(i));
+                CHECK(i != 500);
+            }
+        });
+
+    CHECK(formatted == 1);
+    REQUIRE(infos.size() == 1);
+    CHECK(infos[0] == std::vector<std::string>{"info: iteration 500"});
+}
+
+TEST("info - scopes and captures")
+{
+    auto const infos = info_of_errors(
+        []
+        {
+            auto a = 1;
+            std::vector<int> v = {2, 3};
+            INFO("outer");
+            {
+                CAPTURE(a, v[0], std::max(a, v[1]));
+                a = 7; // read on failure
+                CHECK(a == 1);
+            }
+            CHECK(v.empty());
+        });
+
+    REQUIRE(infos.size() == 2);
+    CHECK(infos[0] == (std::vector<std::string>{"info: outer", "a := 7, v[0] := 2, std::max(a, v[1]) := 7"}));
+    CHECK(infos[1] == std::vector<std::string>{"info: outer"});
+}
+
+TEST("info - splitting capture names")
+{
+    auto const names = nx::impl::split_capture_names("a, f(b, c), m[{1, 2}] ,s == \"x,y\", ','");
+    CHECK(names == (std::vector<std::string_view>{"a", "f(b, c)", "m[{1, 2}]", "s == \"x,y\"", "','"}));
+}
@@ -0,0 +1,121 @@
+#include "only-test.hh"
+
+#include <nexus/test.hh>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+enum class color
+{
+    red,
+    green
+};
+} // namespace
+
+TEST("log - discarded for passing tests")
+{
+    auto const exec = run_as_only_test(
+        []
+        {
+            for (auto i = 0; i < 10'000; ++i)
+                nx::log("iteration {}", i);
+            CHECK(true);
+        });
+
+    CHECK(!exec.is_considered_failing());
+    CHECK(exec.log.empty());
+}
+
+TEST("log - reported for failing tests")
+{
+    auto const exec = run_as_only_test(
+        []
+        {
+            nx::log("deferred {} {} {}", 1, 2.5, true);
+            nx::log("formatted {}", std::string("text"));
+            nx::log("long {}", std::string(1000, 'x'));
+            nx::log("enum {}", int(color::green));
+            CHECK(false);
+        });
+
+    REQUIRE(exec.log.size() == 4);
+    CHECK(exec.log[0].ends_with("[thread 0] deferred 1 2.5 true"));
+    CHECK(exec.log[1].ends_with("[thread 0] formatted text"));
+    CHECK(exec.log[2].ends_with("x [truncated]"));
+    CHECK(exec.log[3].ends_with("enum 1"));
+    CHECK(exec.log[0].starts_with("[+"));
+}
+
+TEST("log - ring buffer keeps the most recent records of every thread")
+{
+    auto const exec = run_as_only_test(
+        []
+        {
+            std::vector<std::thread> threads;
+            for (auto t = 0; t < 4; ++t)
+                threads.emplace_back(
+                    [t]
+                    {
+                        for (auto i = 0; i < 3000; ++i)
+                            nx::log("thread {} record {}", t, i);
+                    });
+            for (auto& thread : threads)
+                thread.join();
+            CHECK(false);
+        });
+
+    // the threads have ended, but their records are still there
+    auto const records = 4 * nx::impl::log_buffer_records;
+    REQUIRE(exec.log.size() == 4 + records);
+    for (auto i = 0; i < 4; ++i)
+        CHECK(exec.log[size_t(i)].ends_with(std::format("{} older records were overwritten (ring buffer of {})",
+                                                        3000 - nx::impl::log_buffer_records, nx::impl::log_buffer_records)));
+
+    auto last_records = 0;
+    for (auto const& line : exec.log)
+        if (line.ends_with(" record 2999"))
+            ++last_records;
+    CHECK(last_records == 4);
+}
+
+TEST("log - nested test runs have their own log")
+{
+    std::vector<std::string> inner_log;
+    auto const exec = run_as_only_test(
+        [&]
+        {
+            nx::log("outer before");
+            inner_log = run_as_only_test(
+                            []
+                            {
+                                nx::log("inner");
+                                CHECK(false);
+                            })
+                            .log;
+            nx::log("outer after");
+            CHECK(false);
+        });
+
+    REQUIRE(inner_log.size() == 1);
+    CHECK(inner_log[0].ends_with("] inner"));
+    REQUIRE(exec.log.size() == 2);
+    CHECK(exec.log[0].ends_with("] outer before"));
+    CHECK(exec.log[1].ends_with("] outer after"));
+}
+
+TEST("log - records of ended threads survive nested test runs")
+{
+    auto const exec = run_as_only_test(
+        []
+        {
+            std::thread([] { nx::log("from an ended thread"); }).join();
+            (void)run_as_only_test([] { CHECK(true); });
+            CHECK(false);
+        });
+
+    REQUIRE(exec.log.size() == 1);
+    CHECK(exec.log[0].ends_with("] from an ended thread"));
+}
@@ -0,0 +1,135 @@
+#include "only-test.hh"
+
+#include <nexus/test.hh>
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+TEST("parallel - parallel_for visits every index once")
+{
+    CHECK(nx::worker_count() >= 1);
+
+    for (auto count : {0, 1, 7, 100, 10'000})
+    {
+        std::vector<std::atomic<int>> visits(static_cast<size_t>(count));
+        nx::parallel_for(-5, count - 5, [&](int i) { visits[size_t(i + 5)].fetch_add(1); });
+
+        auto all_once = true;
+        for (auto const& v : visits)
+            all_once &= v.load() == 1;
+        CHECK(all_once);
+    }
+
+    // empty and reversed ranges do nothing
+    auto calls = 0;
+    nx::parallel_for(10, 3, [&](int) { ++calls; });
+    nx::parallel_for(std::size_t(4), std::size_t(4), [&](std::size_t) { ++calls; });
+    CHECK(calls == 0);
+}
+
+TEST("parallel - nested task groups share the pool")
+{
+    std::atomic<long long> sum = 0;
+    nx::task_group outer;
+    for (auto t = 0; t < 32; ++t)
+        outer.run(
+            [&]
+            {
+                // waiting inside a task runs queued tasks, so this cannot starve the pool
+                nx::parallel_for(0, 1000, [&](int i) { sum.fetch_add(i); });
+            });
+    outer.wait();
+
+    CHECK(sum.load() == 32 * (999 * 1000 / 2));
+}
+
+TEST("parallel - task_group rethrows the first exception")
+{
+    std::atomic<int> finished = 0;
+    nx::task_group group;
+    group.run([] { throw std::runtime_error("task failed"); });
+    for (auto t = 0; t < 8; ++t)
+        group.run([&] { finished.fetch_add(1); });
+
+    auto message = std::string();
+    try
+    {
+        group.wait();
+    }
+    catch (std::runtime_error const& e)
+    {
+        message = e.what();
+    }
+    CHECK(message == "task failed");
+    CHECK(finished.load() == 8); // the other tasks still ran
+
+    // the error is only reported once
+    group.wait();
+}
+
+TEST("parallel - checks in tasks count for the test")
+{
+    auto const exec = run_as_only_test(
+        []
+        {
+            nx::parallel_for(0, 1000, [](int i) { CHECK(i != 500); });
+
+            nx::task_group group;
+            group.run([] { CHECK(true); });
+            group.wait();
+        });
+
+    CHECK(exec.root.executed_checks == 1001);
+    CHECK(exec.root.failed_checks == 1);
+    REQUIRE(exec.errors.size() == 1);
+    CHECK(exec.errors[0].expanded == "500 != 500");
+}
+
+TEST("parallel - REQUIRE ends only its task")
+{
+    std::atomic<int> visited = 0;
+    std::atomic<int> tasks_done = 0;
+    auto reached_end = false;
+    auto const exec = run_as_only_test(
+        [&]
+        {
+            nx::parallel_for(0, 1000,
+                             [&](int i)
+                             {
+                                 REQUIRE(i % 100 != 50);
+                                 visited.fetch_add(1);
+                             });
+
+            nx::task_group group;
+            for (auto t = 0; t < 16; ++t)
+                group.run(
+                    [&, t]
+                    {
+                        REQUIRE(t != 3);
+                        tasks_done.fetch_add(1);
+                    });
+            group.wait();
+
+            reached_end = true;
+        });
+
+    CHECK(reached_end); // neither the caller nor a pool thread aborted the test
+    CHECK(visited.load() == 990);
+    CHECK(tasks_done.load() == 15);
+    CHECK(exec.root.failed_checks == 11);
+    CHECK(exec.errors.size() == 11);
+}
+
+TEST("parallel - parallel_for handles ranges wider than half the index type")
+{
+    std::atomic<int> calls = 0;
+    nx::parallel_for(std::int8_t(-100), std::int8_t(100), [&](std::int8_t) { calls.fetch_add(1); });
+    CHECK(calls.load() == 200);
+
+    calls = 0;
+    nx::parallel_for(std::int8_t(100), std::int8_t(-100), [&](std::int8_t) { calls.fetch_add(1); });
+    CHECK(calls.load() == 0);
+}
@@ -0,0 +1,97 @@
+#include <nexus/test.hh>
+#include <nexus/tests/execute.hh>
+#include <nexus/tests/profile.hh>
+#include <nexus/tests/registry.hh>
+#include <nexus/tests/schedule.hh>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace
+{
+// burns CPU time so that the profiler has something to sample
+[[gnu::noinline]] int spin_for(std::chrono::milliseconds duration)
+{
+    auto const end = std::chrono::steady_clock::now() + duration;
+    volatile int counter = 0;
+    while (std::chrono::steady_clock::now() < end)
+        counter = counter + 1;
+    return counter;
+}
+} // namespace
+
+TEST("profile - samples are attributed to tests and sections")
+{
+#if defined(__unix__) || defined(__APPLE__)
+    auto const dir = std::filesystem::temp_directory_path() / "nexus-profile-test";
+    std::filesystem::remove_all(dir);
+
+    nx::test_schedule_config config;
+    config.profile_dir = dir.string();
+
+    nx::test_registry reg;
+    reg.add_declaration("profiled test", {},
+                        []
+                        {
+                            SECTION("hot section")
+                            {
+                                CHECK(spin_for(std::chrono::milliseconds(300)) > 0);
+                            }
+                        });
+    auto schedule = nx::test_schedule::create({}, reg);
+    auto const result = nx::execute_tests(schedule, config);
+    CHECK(result.count_failed_checks() == 0);
+    CHECK(!nx::impl::is_profiling());
+
+    auto const path = dir / "profiled_test.folded";
+    REQUIRE(std::filesystem::exists(path));
+
+    std::ifstream in(path);
+    std::string line;
+    int total = 0;
+    int in_section = 0;
+    while (std::getline(in, line))
+    {
+        auto const count = std::stoi(line.substr(line.rfind(' ') + 1));
+        total += count;
+        if (line.starts_with("profiled test;hot section;"))
+            in_section += count;
+    }
+    CHECK(total > 0);
+    CHECK(in_section > total / 2);
+
+    std::filesystem::remove_all(dir);
+#endif
+}
+
+TEST("profile - folded stacks are one line per stack")
+{
+    nx::impl::profile_result result;
+    result.folded_stacks["a;b;c"] = 3;
+    result.folded_stacks["a;d"] = 1;
+
+    std::ostringstream out;
+    nx::impl::write_folded_stacks(out, result);
+    CHECK(out.str() == "a;b;c 3\na;d 1\n");
+}
+
+TEST("profile - test names with the same file name get distinct files")
+{
+    auto const dir = std::filesystem::temp_directory_path() / "nexus-profile-names-test";
+    std::filesystem::remove_all(dir);
+
+    nx::impl::profile_result result;
+    result.folded_stacks["a"] = 1;
+    auto const first = nx::impl::write_test_profile(dir, "same name/1", result);
+    auto const second = nx::impl::write_test_profile(dir, "same name?1", result);
+
+    CHECK(first.filename() == "same_name_1.folded");
+    CHECK(second.filename() == "same_name_1-2.folded");
+    CHECK(std::filesystem::exists(first));
+    CHECK(std::filesystem::exists(second));
+
+    std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,197 @@
+#include "only-test.hh"
+
+#include <nexus/test.hh>
+#include <nexus/tests/execute.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+TEST("property - reverse is an involution")
+{
+    PROPERTY("reverse twice", nx::gen::vector(nx::gen::integer<int>()))(std::vector<int> const& v)
+    {
+        auto r = v;
+        std::ranges::reverse(r);
+        std::ranges::reverse(r);
+        CHECK(r == v);
+    };
+
+    PROPERTY("addition commutes", nx::gen::integer<int>(-1000, 1000), nx::gen::integer<int>(-1000, 1000))(int a, int b)
+    {
+        CHECK(a + b == b + a);
+    };
+}
+
+TEST("property - passing property is a single passing check")
+{
+    int cases = 0;
+    auto exec = run_in_registry(
+        [&]
+        {
+            PROPERTY("always true", nx::gen::boolean())(bool)
+            {
+                ++cases;
+                CHECK(true);
+            };
+        });
+
+    CHECK(cases == 100);
+    CHECK(exec.count_total_checks() == 1);
+    CHECK(exec.count_failed_tests() == 0);
+}
+
+TEST("property - generators respect their ranges")
+{
+    PROPERTY("ranges",
+             nx::gen::integer<std::int8_t>(-5, 7),
+             nx::gen::integer<std::uint64_t>(),
+             nx::gen::floating(0.5, 2.0),
+             nx::gen::vector(nx::gen::integer<int>(1, 3), 2, 4),
+             nx::gen::string(1, 5))(std::int8_t i, std::uint64_t, double f, std::vector<int> const& v, std::string const& s)
+    {
+        CHECK(i >= -5);
+        CHECK(i <= 7);
+        CHECK(f >= 0.5);
+        CHECK(f <= 2.0);
+        CHECK(v.size() >= 2u);
+        CHECK(v.size() <= 4u);
+        CHECK(std::ranges::all_of(v, [](int x) { return x >= 1 && x <= 3; }));
+        CHECK(s.size() >= 1u);
+        CHECK(s.size() <= 5u);
+        CHECK(std::ranges::all_of(s, [](char c) { return c >= ' ' && c <= '~'; }));
+    };
+}
+
+TEST("property - failures are shrunk to a minimal counterexample")
+{
+    SECTION("integer")
+    {
+        int last = 0;
+        auto exec = run_in_registry(
+            [&]
+            {
+                PROPERTY("small", nx::gen::integer<int>(-1'000'000, 1'000'000))(int x)
+                {
+                    last = x;
+                    CHECK(x < 1000);
+                };
+            });
+
+        CHECK(exec.count_failed_tests() == 1);
+        CHECK(exec.count_failed_checks() == 1);
+        CHECK(last == 1000); // the counterexample is replayed last
+
+        REQUIRE(exec.executions[0].errors.size() == 1);
+        auto const& lines = exec.executions[0].errors[0].extra_lines;
+        CHECK(std::ranges::any_of(lines, [](std::string_view l) { return l == "counterexample: 1000"; }));
+        CHECK(std::ranges::any_of(lines, [](std::string_view l) { return l.starts_with("shrunk from case "); }));
+    }
+
+    SECTION("large vector")
+    {
+        std::vector<int> last;
+        auto exec = run_in_registry(
+            [&]
+            {
+                PROPERTY("few large", nx::gen::vector(nx::gen::integer<int>(0, 1000), 0, 10'000))(std::vector<int> const& v)
+                {
+                    last = v;
+                    CHECK(std::ranges::count_if(v, [](int x) { return x >= 500; }) < 3);
+                };
+            });
+
+        CHECK(exec.count_failed_tests() == 1);
+        CHECK(last == std::vector<int>({500, 500, 500}));
+    }
+
+    SECTION("string")
+    {
+        std::string last;
+        auto exec = run_in_registry(
+            [&]
+            {
+                PROPERTY("no x", nx::gen::string())(std::string const& s)
+                {
+                    last = s;
+                    CHECK(!s.contains('x'));
+                };
+            });
+
+        CHECK(exec.count_failed_tests() == 1);
+        CHECK(last == "x");
+    }
+
+    SECTION("float")
+    {
+        double last = 0;
+        auto exec = run_in_registry(
+            [&]
+            {
+                PROPERTY("square", nx::gen::floating(-1000.0, 1000.0))(double x)
+                {
+                    last = x;
+                    CHECK(x * x < 100.0);
+                };
+            });
+
+        CHECK(exec.count_failed_tests() == 1);
+        CHECK(std::abs(last) >= 10.0);
+        CHECK(std::abs(last) < 11.0);
+    }
+
+    SECTION("multiple arguments")
+    {
+        int last_a = 0;
+        int last_b = 0;
+        auto exec = run_in_registry(
+            [&]
+            {
+                PROPERTY("ordered", nx::gen::integer<int>(0, 100), nx::gen::integer<int>(0, 100))(int a, int b)
+                {
+                    last_a = a;
+                    last_b = b;
+                    REQUIRE(a <= b);
+                };
+            });
+
+        CHECK(exec.count_failed_tests() == 1);
+        CHECK(last_a == 1);
+        CHECK(last_b == 0);
+    }
+}
+
+TEST("property - cases are deterministic per seed and independent of jobs")
+{
+    // "shrunk from case <i> of <n> in <steps> steps (seed <seed>)"
+    auto const shrink_summary = [](nx::test_schedule_config const& config, nx::config::cfg test_config)
+    {
+        auto exec = run_in_registry(
+            [&]
+            {
+                PROPERTY("not divisible", nx::gen::integer<int>(1, 1'000'000))(int x)
+                {
+                    CHECK(x % 5 != 0);
+                };
+            },
+            {.test_config = test_config, .schedule_config = config});
+
+        auto const& errors = exec.executions[0].errors;
+        return errors.empty() ? std::string() : std::string(errors[0].extra_lines.back());
+    };
+
+    nx::test_schedule_config sequential;
+    nx::test_schedule_config parallel;
+    parallel.property_jobs = 4;
+
+    nx::config::cfg seeded;
+    seeded.seed = 42;
+
+    auto const summary = shrink_summary(sequential, {});
+    CHECK(summary.starts_with("shrunk from case "));
+    CHECK(shrink_summary(sequential, {}) == summary);
+    CHECK(shrink_summary(parallel, {}) == summary);
+    CHECK(shrink_summary(sequential, seeded) != summary);
+    CHECK(shrink_summary(parallel, seeded) == shrink_summary(sequential, seeded));
+}
@@ -0,0 +1,174 @@
+#include "only-test.hh"
+
+#include <nexus/test.hh>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace
+{
+std::vector<std::string> range_check_errors(std::move_only_function<void()> fn)
+{
+    return extra_lines_of(run_as_only_test(std::move(fn), {.name = "range check"}));
+}
+} // namespace
+
+TEST("range check - passing checks")
+{
+    std::vector<int> a(10'000);
+    for (auto i = 0; i < int(a.size()); ++i)
+        a[i] = i;
+    auto const b = a;
+
+    CHECK_RANGE_EQ(a, b);
+    CHECK_RANGE_EQ(std::span(a).first(5), (std::array{0, 1, 2, 3, 4}));
+    CHECK_RANGE_ALL_EQ(std::vector<float>(5000, 1.5f), 1.5f);
+    CHECK_RANGE_WITHIN(a, 0, 9999);
+    CHECK_RANGE_WITHIN(std::vector<float>(100, 0.5f), 0, 1.0f); // bounds of different types
+    CHECK_RANGE_SORTED(a);
+    CHECK_RANGE_SORTED(std::vector<int>{});
+}
+
+TEST("range check - equality reports the first mismatches")
+{
+    auto const lines = range_check_errors(
+        []
+        {
+            std::vector<int> a(5000, 7);
+            auto b = a;
+            for (auto i = 100; i < 5000; i += 100)
+                b[i] = 8;
+            CHECK_RANGE_EQ(a, b);
+        });
+
+    REQUIRE(lines.size() == 1 + nx::impl::max_reported_range_mismatches + 1);
+    CHECK(lines[0] == "49 of 5000 elements differ");
+    CHECK(lines[1] == "[100]: 7 != 8");
+    CHECK(lines[2] == "[200]: 7 != 8");
+    CHECK(lines.back() == "... and 41 more");
+}
+
+TEST("range check - size mismatch")
+{
+    auto const lines = range_check_errors([] { CHECK_RANGE_EQ((std::vector<int>{1, 2, 3}), (std::vector<int>{1, 5})); });
+
+    REQUIRE(lines.size() == 2);
+    CHECK(lines[0] == "sizes differ: 3 != 2, 1 of the first 2 elements differ");
+    CHECK(lines[1] == "[1]: 2 != 5");
+}
+
+TEST("range check - all equal, bounds, and order")
+{
+    auto const lines = range_check_errors(
+        []
+        {
+            std::vector<int> v = {0, 5, 20, -1, 10};
+            CHECK_RANGE_ALL_EQ(v, 0);
+            CHECK_RANGE_WITHIN(v, 0, 10);
+            CHECK_RANGE_SORTED((std::vector<int>{1, 2, 2, 1, 3}));
+        });
+
+    auto const contains = [&](std::string const& line) { return std::find(lines.begin(), lines.end(), line) != lines.end(); };
+    CHECK(contains("4 of 5 elements are not 0"));
+    CHECK(contains("2 of 5 elements are outside [0, 10]"));
+    CHECK(contains("[2]: 20"));
+    CHECK(contains("[3]: -1"));
+    CHECK(contains("1 of 4 adjacent pairs are out of order"));
+    CHECK(contains("[2] > [3]: 2 > 1"));
+}
+
+TEST("range check - NaN is outside of every range")
+{
+    auto const lines = range_check_errors(
+        []
+        {
+            std::vector<float> v(3000, 0.5f);
+            v[2500] = NAN;
+            CHECK_RANGE_WITHIN(v, 0.0f, 1.0f);
+        });
+
+    REQUIRE(lines.size() == 2);
+    CHECK(lines[0].starts_with("1 of 3000 elements are outside ["));
+    CHECK(lines[1].starts_with("[2500]: "));
+}
+
+TEST("range check - a failed range is a single failed check")
+{
+    auto const exec = run_as_only_test(
+        []
+        {
+            std::vector<int> v(100'000, 1);
+            CHECK_RANGE_ALL_EQ(v, 0).context("all wrong");
+        });
+
+    CHECK(exec.root.failed_checks == 1);
+    REQUIRE(exec.errors.size() == 1);
+    CHECK(exec.errors[0].expr == "CHECK_RANGE_ALL_EQ(v, 0)");
+    CHECK(exec.errors[0].extra_lines.back() == "context: all wrong");
+}
+
+TEST("range check - approximate comparison with tolerances")
+{
+    std::vector<float> ref(4000);
+    for (size_t i = 0; i < ref.size(); ++i)
+        ref[i] = float(i) * 0.25f;
+    auto out = ref;
+    out[10] = std::nextafter(out[10], 1e9f);
+
+    CHECK_RANGE_APPROX(out, ref, {.ulps = 1});
+    CHECK_RANGE_APPROX(out, ref, {.abs = 1e-3});
+    CHECK_RANGE_APPROX(out, ref, {.rel = 1e-6});
+    CHECK_RANGE_APPROX(ref, ref, {});
+
+    std::vector<double> zeros = {0.0, -0.0};
+    CHECK_RANGE_APPROX(zeros, (std::vector<double>{-0.0, 0.0}), {});
+    CHECK(nx::impl::ulp_distance(1.0, std::nextafter(1.0, 2.0)) == 1);
+    CHECK(nx::impl::ulp_distance(-0.0f, std::nextafter(0.0f, 1.0f)) == 1);
+    CHECK(nx::impl::ulp_distance(std::nextafter(0.0f, -1.0f), std::nextafter(0.0f, 1.0f)) == 2);
+}
+
+TEST("range check - approximate comparison reports error statistics")
+{
+    auto const lines = range_check_errors(
+        []
+        {
+            std::vector<double> ref(1000, 1.0);
+            auto out = ref;
+            out[3] = 1.5;
+            out[7] = 1.0 + 1e-9;
+            out[9] = NAN;
+            CHECK_RANGE_APPROX(out, ref, {.abs = 1e-6});
+        });
+
+    REQUIRE(lines.size() >= 4);
+    CHECK(lines[0].starts_with("2 of 1000 elements outside of tolerance"));
+    CHECK(lines[1].starts_with("max abs error "));
+    CHECK(lines[1].find("at [3]") != std::string::npos);
+    CHECK(lines[2].find("at [3]") != std::string::npos);
+    CHECK(lines[3].starts_with("ulp distances: 0: 997, "));
+    CHECK(lines[3].ends_with("NaN: 1"));
+    REQUIRE(lines.size() == 6);
+    CHECK(lines[4].starts_with("[3]: "));
+    CHECK(lines[5].starts_with("[9]: "));
+}
+
+TEST("range check - approximate comparison with an empty range")
+{
+    auto const lines = range_check_errors(
+        []
+        {
+            std::vector<float> const ref = {1.0f, 2.0f};
+            CHECK_RANGE_APPROX(std::vector<float>{}, ref, {});
+            CHECK_RANGE_APPROX(ref, std::vector<float>{}, {});
+        });
+
+    REQUIRE(lines.size() == 4);
+    CHECK(lines[0] == "sizes differ: 0 != 2");
+    CHECK(lines[1].starts_with("0 of 0 elements outside of tolerance"));
+    CHECK(lines[2] == "sizes differ: 2 != 0");
+    CHECK(lines[3].starts_with("0 of 0 elements outside of tolerance"));
+}
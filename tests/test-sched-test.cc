@@ -0,0 +1,232 @@
+#include "only-test.hh"
+
+#include <nexus/test.hh>
+
+#include <algorithm>
+#include <charconv>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+bool has_line_starting_with(nx::test_error_view const& error, std::string_view prefix)
+{
+    return std::ranges::any_of(error.extra_lines, [&](std::string_view line) { return line.starts_with(prefix); });
+}
+
+// the seed from "replay with INTERLEAVINGS("...", .replay_seed = <seed>)"
+std::uint64_t replay_seed_of(nx::test_error_view const& error)
+{
+    for (std::string_view line : error.extra_lines)
+        if (auto const pos = line.find(".replay_seed = "); pos != std::string_view::npos)
+        {
+            auto const digits = line.substr(pos + std::string_view(".replay_seed = ").size());
+            std::uint64_t seed = 0;
+            std::from_chars(digits.data(), digits.data() + digits.size(), seed);
+            return seed;
+        }
+    return 0;
+}
+
+// a read-modify-write race: both threads may read 0
+void racy_increments(nx::sched::options const& options)
+{
+    nx::impl::interleaving_runner{"racy increments", std::source_location::current(), options} = [&]
+    {
+        nx::sched::atomic<int> counter = 0;
+        {
+            nx::sched::thread a([&] { counter.store(counter.load() + 1); });
+            nx::sched::thread b([&] { counter.store(counter.load() + 1); });
+        }
+        CHECK(counter.load() == 2);
+    };
+}
+} // namespace
+
+TEST("sched - correct code passes as a single check")
+{
+    nx::test_schedule_config config;
+    config.interleavings = 200;
+    auto const exec = run_as_only_test(
+        []
+        {
+            INTERLEAVINGS("atomic increments")
+            {
+                nx::sched::atomic<int> counter = 0;
+                nx::sched::mutex mutex;
+                auto guarded = 0;
+                {
+                    std::vector<nx::sched::thread> threads;
+                    for (auto t = 0; t < 3; ++t)
+                        threads.emplace_back(
+                            [&]
+                            {
+                                counter.fetch_add(1);
+                                auto lock = std::lock_guard(mutex);
+                                guarded = guarded + 1;
+                            });
+                }
+                CHECK(counter.load() == 3);
+                CHECK(guarded == 3);
+            };
+        },
+        {.schedule_config = config});
+
+    CHECK(exec.root.executed_checks == 1);
+    CHECK(exec.root.failed_checks == 0);
+    CHECK(!exec.is_considered_failing());
+}
+
+TEST("sched - finds lost updates and replays them from the seed")
+{
+    for (auto strategy : {nx::sched::strategy::pct, nx::sched::strategy::random})
+    {
+        auto const exec = run_as_only_test([&] { racy_increments({.strategy = strategy}); });
+
+        CHECK(exec.root.failed_checks == 1);
+        REQUIRE(exec.errors.size() == 1);
+        CHECK(exec.errors[0].expanded == "1 == 2");
+        CHECK(has_line_starting_with(exec.errors[0], "interleaving "));
+        CHECK(has_line_starting_with(exec.errors[0], "schedule ("));
+        CHECK(!has_line_starting_with(exec.errors[0], "passed when replayed"));
+
+        auto const seed = replay_seed_of(exec.errors[0]);
+        REQUIRE(seed != 0u);
+        auto const replayed = run_as_only_test([&] { racy_increments({.strategy = strategy, .replay_seed = seed}); });
+        CHECK(replayed.root.failed_checks == 1);
+        REQUIRE(replayed.errors.size() == 1);
+        CHECK(replayed.errors[0].expanded == "1 == 2");
+    }
+}
+
+TEST("sched - interleavings are deterministic per seed")
+{
+    auto const first = run_as_only_test([] { racy_increments({}); });
+    auto const second = run_as_only_test([] { racy_increments({}); });
+    REQUIRE(first.errors.size() == 1);
+    REQUIRE(second.errors.size() == 1);
+    CHECK(first.errors[0].extra_lines == second.errors[0].extra_lines);
+}
+
+TEST("sched - deadlocks are reported")
+{
+    auto const exec = run_as_only_test(
+        []
+        {
+            INTERLEAVINGS("lock order inversion")
+            {
+                nx::sched::mutex a;
+                nx::sched::mutex b;
+                nx::sched::thread t0(
+                    [&]
+                    {
+                        auto la = std::lock_guard(a);
+                        auto lb = std::lock_guard(b);
+                    });
+                nx::sched::thread t1(
+                    [&]
+                    {
+                        auto lb = std::lock_guard(b);
+                        auto la = std::lock_guard(a);
+                    });
+            };
+        });
+
+    CHECK(exec.root.failed_checks == 1);
+    REQUIRE(exec.errors.size() == 1);
+    CHECK(exec.errors[0].expanded == "deadlock: every unfinished thread is blocked");
+    CHECK(has_line_starting_with(exec.errors[0], "thread 0 waits for thread"));
+    CHECK(has_line_starting_with(exec.errors[0], "thread 1 waits for a mutex"));
+    CHECK(has_line_starting_with(exec.errors[0], "thread 2 waits for a mutex"));
+}
+
+TEST("sched - busy waiting needs yield")
+{
+    auto const spin = [](bool use_yield)
+    {
+        return run_as_only_test(
+            [use_yield]
+            {
+                INTERLEAVINGS("spin", .pct_depth = 1, .interleavings = 20, .max_steps = 1000)
+                {
+                    nx::sched::atomic<bool> ready = false;
+                    nx::sched::thread waiter(
+                        [&]
+                        {
+                            while (!ready.load())
+                                if (use_yield)
+                                    nx::sched::yield();
+                        });
+                    nx::sched::thread setter([&] { ready.store(true); });
+                };
+            });
+    };
+
+    auto const with_yield = spin(true);
+    CHECK(!with_yield.is_considered_failing());
+
+    // the waiter may have the higher priority and never lets the setter run
+    auto const without_yield = spin(false);
+    REQUIRE(without_yield.errors.size() == 1);
+    CHECK(without_yield.errors[0].expanded == "livelock: more than 1000 scheduling points");
+}
+
+TEST("sched - REQUIRE ends only its thread")
+{
+    auto const exec = run_as_only_test(
+        []
+        {
+            INTERLEAVINGS("require", .interleavings = 10)
+            {
+                nx::sched::atomic<int> done = 0;
+                {
+                    nx::sched::thread a(
+                        [&]
+                        {
+                            REQUIRE(done.load() < 0);
+                            done.store(-1);
+                        });
+                    nx::sched::thread b([&] { done.fetch_add(1); });
+                }
+                CHECK(done.load() == 1);
+            };
+        });
+
+    // the first (sequential) interleaving already fails
+    CHECK(exec.root.failed_checks == 1);
+    REQUIRE(exec.errors.size() == 1);
+    CHECK(has_line_starting_with(exec.errors[0], "failed without preemption"));
+}
+
+TEST("sched - primitives work without a scheduler")
+{
+    nx::sched::atomic<int> counter = 0;
+    nx::sched::mutex mutex;
+    auto guarded = 0;
+    {
+        nx::sched::thread a(
+            [&]
+            {
+                for (auto i = 0; i < 1000; ++i)
+                {
+                    ++counter;
+                    auto lock = std::lock_guard(mutex);
+                    ++guarded;
+                }
+            });
+        nx::sched::thread b(
+            [&]
+            {
+                for (auto i = 0; i < 1000; ++i)
+                {
+                    ++counter;
+                    auto lock = std::lock_guard(mutex);
+                    ++guarded;
+                }
+            });
+    }
+    CHECK(counter.load() == 2000);
+    CHECK(guarded == 2000);
+}
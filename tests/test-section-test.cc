@@ -3,6 +3,8 @@
 #include <nexus/tests/registry.hh>
 #include <nexus/tests/schedule.hh>
 
+#include <chrono>
+#include <cstdint>
 #include <format>
 #include <stdexcept>
 #include <string>
@@ -650,3 +652,193 @@ TEST("test sections - CC_ASSERT_ALWAYS failure in root after subsections execute
     // But the test overall should be marked as failed due to the CC_ASSERT_ALWAYS failures
     CHECK(exec.count_failed_tests() == 1);
 }
+
+TEST("test sections - inclusive, self, and repeated prefix time across re-entries")
+{
+    auto const busy_wait = [](double seconds)
+    {
+        auto const t_end = std::chrono::steady_clock::now() + std::chrono::duration<double>(seconds);
+        while (std::chrono::steady_clock::now() < t_end)
+        {
+        }
+    };
+
+    nx::test_registry reg;
+    reg.add_declaration( //
+        "testA", {},
+        [&]
+        {
+            busy_wait(0.005); // shared prefix, runs once per leaf
+
+            SECTION("sec A")
+            {
+                busy_wait(0.002);
+                SUCCEED();
+            }
+            SECTION("sec B")
+            {
+                SUCCEED();
+            }
+            SECTION("sec C")
+            {
+                SUCCEED();
+            }
+        });
+
+    auto schedule = nx::test_schedule::create({}, reg);
+    auto exec = nx::execute_tests(schedule, {});
+    REQUIRE(exec.executions.size() == 1);
+
+    auto const& root = exec.executions[0].root;
+    REQUIRE(root.subsections.size() == 3);
+    auto const& sec_a = root.subsections[0];
+
+    CHECK(root.entries == 3);
+    CHECK(sec_a.entries == 1);
+
+    // inclusive time contains the subsections, self time does not
+    CHECK(root.duration_seconds >= 0.017);
+    CHECK(root.self_seconds >= 0.015);
+    CHECK(root.self_seconds < root.duration_seconds);
+    CHECK(sec_a.duration_seconds >= 0.002);
+    CHECK(sec_a.duration_seconds < root.duration_seconds - root.self_seconds + 1e-9);
+
+    // two of the three prefix runs were only needed to reach further sections
+    CHECK(root.repeated_seconds >= 0.010);
+    CHECK(root.repeated_seconds < root.self_seconds);
+    CHECK(sec_a.repeated_seconds == 0.0);
+    CHECK(exec.executions[0].repeated_prefix_seconds() == root.repeated_seconds);
+}
+
+TEST("test sections - errors are stored once and referenced by section ranges")
+{
+    nx::test_registry reg;
+    reg.add_declaration("many failures", {},
+                        []
+                        {
+                            SECTION("outer")
+                            {
+                                SECTION("inner")
+                                {
+                                    for (auto i = 0; i < 100; ++i)
+                                        CHECK(i < 0);
+                                }
+                            }
+                            SECTION("sibling")
+                            {
+                                CHECK(false);
+                            }
+                        });
+
+    auto schedule = nx::test_schedule::create({}, reg);
+    auto const exec = nx::execute_tests(schedule, {});
+    REQUIRE(exec.executions.size() == 1);
+
+    auto const& e = exec.executions[0];
+    auto const& outer = e.root.subsections[0];
+    auto const& inner = outer.subsections[0];
+    auto const& sibling = e.root.subsections[1];
+
+    // every failure exists once, parents aggregate by range
+    CHECK(e.errors.size() == 101);
+    CHECK(e.errors_of(e.root).size() == 101);
+    CHECK(e.own_errors_of(e.root).empty());
+    CHECK(e.errors_of(outer).size() == 100);
+    CHECK(e.own_errors_of(outer).empty());
+    CHECK(e.own_errors_of(inner).size() == 100);
+    CHECK(e.errors_of(sibling).size() == 1);
+    CHECK(e.root.failed_checks == 101);
+    CHECK(e.root.executed_checks == 101);
+
+    // the same CHECK failing repeatedly shares its strings
+    CHECK(e.errors[0].expr == "i < 0");
+    CHECK(e.errors[0].expr.data() == e.errors[99].expr.data());
+
+    // copies share the string storage
+    auto const copy = e;
+    CHECK(copy.errors_of(copy.root)[100].expr == "false");
+}
+
+TEST("test sections - failures beyond the caps are only counted")
+{
+    nx::test_registry reg;
+    reg.add_declaration("failing loop", {},
+                        []
+                        {
+                            for (auto i = 0; i < 10'000; ++i)
+                                CHECK(i < 0);
+                            CHECK(false);
+                        });
+
+    nx::test_schedule_config config;
+    config.max_failures_per_location = 5;
+
+    auto schedule = nx::test_schedule::create({}, reg);
+    auto const exec = nx::execute_tests(schedule, config);
+    REQUIRE(exec.executions.size() == 1);
+
+    auto const& e = exec.executions[0];
+    CHECK(e.root.failed_checks == 10'001);
+    CHECK(e.is_considered_failing());
+
+    // 5 recorded + 1 summary for the loop, the other location is below the cap
+    REQUIRE(e.errors.size() == 7);
+    CHECK(e.errors[0].expr == "i < 0");
+    CHECK(e.errors[0].expanded.ends_with(":" + std::to_string(e.errors[1].location.line()) + " failed 9,995 more times"));
+    CHECK(e.errors[0].expanded.starts_with("CHECK at test-section-test.cc:"));
+    CHECK(e.errors[6].expr == "false");
+
+    // the per-test cap applies across locations
+    config.max_failures_per_location = 0;
+    config.max_failures_per_test = 3;
+    auto const capped = nx::execute_tests(schedule, config);
+    REQUIRE(capped.executions[0].errors.size() == 5);
+    CHECK(capped.executions[0].errors[0].extra_lines[0].starts_with("only the first 3 failures were recorded"));
+    CHECK(capped.executions[0].errors[1].expanded.ends_with(" failed 1 time"));
+    CHECK(capped.executions[0].errors[1].extra_lines[0].starts_with("no failures were recorded here"));
+
+    // singular for a single recorded and a single suppressed failure
+    config.max_failures_per_location = 1;
+    config.max_failures_per_test = 0;
+    auto const single = nx::execute_tests(schedule, config);
+    REQUIRE(single.executions[0].errors.size() == 3);
+    CHECK(single.executions[0].errors[0].extra_lines[0].starts_with("only the first failure was recorded"));
+}
+
+TEST("test sections - captured failures beyond the caps are only counted")
+{
+    auto recorded = size_t(0);
+    auto suppressed = std::int64_t(0);
+
+    nx::test_registry reg;
+    reg.add_declaration("captured failing loop", {},
+                        [&]
+                        {
+                            auto captured = nx::impl::run_captured(
+                                []
+                                {
+                                    for (auto i = 0; i < 10'000; ++i)
+                                        CHECK(i < 0);
+                                },
+                                std::source_location::current());
+                            recorded = captured.errors.size();
+                            suppressed = captured.suppressed.empty() ? 0 : captured.suppressed[0].count;
+                            nx::impl::report_captured_checks(std::move(captured), {});
+                        });
+
+    nx::test_schedule_config config;
+    config.max_failures_per_location = 5;
+
+    auto schedule = nx::test_schedule::create({}, reg);
+    auto const exec = nx::execute_tests(schedule, config);
+    REQUIRE(exec.executions.size() == 1);
+
+    // the capture already stops formatting at the cap
+    CHECK(recorded == 5);
+    CHECK(suppressed == 9'995);
+
+    auto const& e = exec.executions[0];
+    CHECK(e.root.failed_checks == 10'000);
+    REQUIRE(e.errors.size() == 6);
+    CHECK(e.errors[0].expanded.ends_with(" failed 9,995 more times"));
+}
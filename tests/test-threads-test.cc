@@ -0,0 +1,110 @@
+#include "only-test.hh"
+
+#include <nexus/test.hh>
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+void run_threads(int count, std::function<void(int)> const& fn)
+{
+    std::vector<std::thread> threads;
+    for (auto t = 0; t < count; ++t)
+        threads.emplace_back([&fn, t] { fn(t); });
+    for (auto& thread : threads)
+        thread.join();
+}
+} // namespace
+
+TEST("threads - checks on worker threads count for the test")
+{
+    auto const exec = run_as_only_test(
+        []
+        {
+            run_threads(32,
+                        [](int t)
+                        {
+                            for (auto i = 0; i < 100; ++i)
+                                CHECK(i + t >= 0);
+                            CHECK(t != 7);
+                        });
+        });
+
+    CHECK(exec.root.executed_checks == 32 * 101);
+    CHECK(exec.root.failed_checks == 1);
+    REQUIRE(exec.errors.size() == 1);
+    CHECK(exec.errors[0].expanded == "7 != 7");
+    CHECK(exec.is_considered_failing());
+}
+
+TEST("threads - worker checks belong to the section of their pass")
+{
+    auto const exec = run_as_only_test(
+        []
+        {
+            SECTION("a")
+            {
+                run_threads(2, [](int) { CHECK(true); });
+            }
+            SECTION("b")
+            {
+                run_threads(3, [](int t) { CHECK(t < 0); });
+            }
+        });
+
+    REQUIRE(exec.root.subsections.size() == 2);
+    CHECK(exec.root.subsections[0].executed_checks == 2);
+    CHECK(exec.root.subsections[0].failed_checks == 0);
+    CHECK(exec.root.subsections[1].executed_checks == 3);
+    CHECK(exec.root.subsections[1].failed_checks == 3);
+    CHECK(exec.errors_of(exec.root.subsections[1]).size() == 3);
+}
+
+TEST("threads - REQUIRE on a worker thread")
+{
+    auto after_require = 0;
+    auto const exec = run_as_only_test(
+        [&]
+        {
+            run_threads(1,
+                        [&](int)
+                        {
+                            INFO("worker");
+                            REQUIRE(false);
+                            ++after_require;
+                        });
+            CHECK(true);
+        });
+
+    CHECK(after_require == 1); // not aborted
+    CHECK(exec.root.failed_checks == 1);
+    REQUIRE(exec.errors.size() == 1);
+    CHECK(exec.errors[0].info == std::vector<std::string_view>{"info: worker"});
+    CHECK(std::ranges::any_of(exec.errors[0].extra_lines, [](std::string_view line) { return line.starts_with("REQUIRE failed on a thread"); }));
+}
+
+TEST("threads - failure caps apply across threads")
+{
+    nx::test_schedule_config config;
+    config.max_failures_per_test = 10;
+    config.max_failures_per_location = 0;
+    auto const exec = run_as_only_test(
+        []
+        {
+            run_threads(8,
+                        [](int)
+                        {
+                            for (auto i = 0; i < 1000; ++i)
+                                CHECK(i < 0);
+                        });
+        },
+        {.schedule_config = config});
+
+    CHECK(exec.root.failed_checks == 8000);
+    // 10 recorded, the rest summarized in one error
+    REQUIRE(exec.errors.size() == 11);
+    CHECK(exec.errors[0].expanded.ends_with("failed 7,990 more times"));
+}
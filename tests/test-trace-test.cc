@@ -0,0 +1,121 @@
+#include "only-test.hh"
+
+#include <nexus/fuzz/engine.hh>
+#include <nexus/test.hh>
+
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace
+{
+// with --trace-out, the whole run is traced: a test can neither toggle tracing nor read the trace while others record
+// such runs skip the trace tests (with a passing check, so they are not flagged as empty)
+bool is_run_traced()
+{
+    CHECK(true);
+    return nx::impl::is_tracing();
+}
+
+// runs fn as the only test of a local registry with tracing enabled, returns the trace JSON
+std::string trace_in_registry(std::move_only_function<void()> fn, nx::test_schedule_config const& config = {})
+{
+    REQUIRE(!nx::impl::is_tracing());
+    nx::impl::start_tracing();
+    (void)run_as_only_test(std::move(fn), {.name = "traced test", .schedule_config = config});
+    nx::impl::stop_tracing();
+
+    std::ostringstream out;
+    nx::impl::write_trace_json(out);
+    return out.str();
+}
+} // namespace
+
+TEST("trace - tests, passes, sections, and user zones are spans")
+{
+    if (is_run_traced())
+        return;
+
+    auto const json = trace_in_registry(
+        []
+        {
+            SECTION("first")
+            {
+                auto _ = nx::trace_scope("user zone");
+                CHECK(true);
+            }
+            SECTION("second")
+            {
+                CHECK(true);
+            }
+        });
+
+    CHECK(json.starts_with("{\"traceEvents\": ["));
+    CHECK(json.contains(R"("name": "traced test", "cat": "test", "ph": "X")"));
+    CHECK(json.contains(R"("name": "pass 1", "cat": "pass")"));
+    CHECK(json.contains(R"("name": "pass 2", "cat": "pass")"));
+    CHECK(json.contains(R"("name": "first", "cat": "section")"));
+    CHECK(json.contains(R"("name": "second", "cat": "section")"));
+    CHECK(json.contains(R"("name": "user zone", "cat": "user")"));
+}
+
+TEST("trace - spans are no-ops without tracing")
+{
+    if (is_run_traced())
+        return;
+
+    {
+        auto _ = nx::trace_scope("not recorded");
+    }
+
+    std::ostringstream out;
+    nx::impl::write_trace_json(out);
+    CHECK(!out.str().contains("not recorded"));
+}
+
+TEST("trace - worker threads and processes get their own tracks")
+{
+    if (is_run_traced())
+        return;
+
+    nx::test_schedule_config config;
+    config.property_jobs = 2;
+    config.fuzz = true;
+    config.fuzz_seconds = 0.1;
+    config.fuzz_jobs = 2;
+
+    auto const json = trace_in_registry(
+        []
+        {
+            PROPERTY("traced property", nx::gen::integer<int>())(int) { CHECK(true); };
+
+            // the test thread does not help while it spins, so the task runs on a pool worker
+            if (nx::worker_count() > 1)
+            {
+                std::atomic<bool> has_run = false;
+                nx::task_group group;
+                group.run([&] { has_run = true; });
+                while (!has_run)
+                    std::this_thread::yield();
+                group.wait();
+            }
+
+            nx::impl::run_fuzz_target({
+                .name = "traced fuzz",
+                .test_config = {},
+                .location = std::source_location::current(),
+                .fn = [](std::span<std::byte const>) {},
+            });
+        },
+        config);
+
+    CHECK(json.contains("\"name\": \"PROPERTY(\\\"traced property\\\")\""));
+    if (nx::worker_count() > 1)
+        CHECK(json.contains(R"("args": {"name": "worker )"));
+    CHECK(json.contains("\"name\": \"FUZZ_TEST(\\\"traced fuzz\\\")\""));
+#if defined(__unix__) || defined(__APPLE__)
+    CHECK(json.contains(R"("args": {"name": "fuzz worker 0"})"));
+    CHECK(json.contains(R"("args": {"name": "fuzz worker 1"})"));
+#endif
+}